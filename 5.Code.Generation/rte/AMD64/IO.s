@@ -0,0 +1,310 @@
+#-------------------------------------------------------------------------------
+#// @brief SnuPL I/O library (AMD64)
+#// @author Bernhard Egger <bernhard@csap.snu.ac.kr>
+#// @section changelog Change Log
+#// 2012/10/12 Bernhard Egger created
+#// 2016/04/01 Bernhard Egger support for strings
+#//
+#// @section license_section License
+#// Copyright (c) 2012-2016, Bernhard Egger
+#// All rights reserved.
+#//
+#// Redistribution and use in source and binary forms,  with or without modifi-
+#// cation, are permitted provided that the following conditions are met:
+#//
+#// - Redistributions of source code must retain the above copyright notice,
+#//   this list of conditions and the following disclaimer.
+#// - Redistributions in binary form must reproduce the above copyright notice,
+#//   this list of conditions and the following disclaimer in the documentation
+#//   and/or other materials provided with the distribution.
+#//
+#// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+#// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+#// IMPLIED WARRANTIES OF MERCHANTABILITY  AND FITNESS FOR A PARTICULAR PURPOSE
+#// ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER  OR CONTRIBUTORS BE
+#// LIABLE FOR ANY DIRECT,  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+#// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF  SUBSTITUTE
+#// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+#// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN  CONTRACT, STRICT
+#// LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY
+#// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+#// DAMAGE.
+
+  .text
+  .align 16
+
+.global ReadInt
+.global WriteInt
+.global WriteStr
+.global WriteChar
+.global WriteLn
+
+.extern DOFS
+
+#-------------------------------------------------------------------------------
+# function ReadInt()
+# (C: int ReadInt(void))
+#
+# reads a (decimal) value string from stdin and returns it a signed integer
+#
+# Reads strings in the format ["-"] digit {digit}.
+# Recognizes newline, space and tab as number separators.
+# Illegal and superfluous characters are skipped.
+# Does not check for overflow.
+#
+# System V AMD64 calling convention (result = %eax)
+ReadInt:
+  pushq   %rbp
+  movq    %rsp, %rbp
+  pushq   %rbx
+  pushq   %r12
+  subq    $32, %rsp             # keep %rsp 16-byte aligned
+
+  leaq    -48(%rbp), %rbx       # pointer to input string. We need at least an
+                                # 11-char buffer to parse '-2147483648'
+  leaq    -37(%rbp), %r12       # last character of input buffer
+
+.Lread:
+  movl    $1, %edx              # %rdx = number of characters to read
+  movq    %rbx, %rsi            # %rsi = pointer to buffer
+  movl    $0, %edi              # %rdi = stdin
+  movl    $0, %eax              # %rax = 0 (read syscall)
+  syscall                       # syscall (clobbers %rcx and %r11)
+
+  testq   %rax, %rax            # end of input?
+  je      .Lscan
+
+  movb    (%rbx), %al           # load character into %al
+  cmpb    $0xa, %al             # early-exit on newlines before increasing %rbx
+  je      .Lskip
+
+  incq    %rbx
+  cmpq    %rbx, %r12            # buffer full?
+  je      .Lskip
+
+  cmpb    $0x2d, %al            # '-'?
+  je      .Lread
+
+  subb    $0x30, %al            # convert to number
+  cmpb    $10, %al              # valid digit?
+  jb      .Lread
+
+  decq    %rbx                  # character not valid -> discard
+
+.Lskip:
+  movq    %rbx, %r12            # save %rbx
+  movq    %rbx, %rsi            # last read character
+
+.Lskiploop:
+  movb    (%rsi), %al           # get last read character into %al
+
+  cmpb    $0xa, %al             # newline ?
+  je      .Lskipdone
+  cmpb    $0x9, %al             # tab?
+  je      .Lskipdone
+  cmpb    $0x20, %al            # space ?
+  je      .Lskipdone
+
+  movl    $1, %edx              # %rdx = number of characters to read
+  leaq    -32(%rbp), %rsi       # %rsi = pointer to (scratch) buffer
+  movl    $0, %edi              # %rdi = stdin
+  movl    $0, %eax              # %rax = 0 (read syscall)
+  syscall                       # syscall
+
+  testq   %rax, %rax            # end of input?
+  je      .Lskipdone
+  jmp     .Lskiploop
+
+.Lskipdone:
+  movq    %r12, %rbx            # restore %rbx
+
+.Lscan:
+  movb    $0, (%rbx)            # terminate input buffer
+
+
+  movl    $0, %eax              # accumulated number
+  xorl    %r8d, %r8d            # negative flag
+  leaq    -48(%rbp), %rcx       # input string to parse
+
+  cmpb    $0x2d, (%rcx)         # first character a '-'?
+  jne     .Lscanloop
+
+  movl    $1, %r8d              # set negative flag
+  incq    %rcx
+
+.Lscanloop:
+  movzbl  (%rcx), %esi          # read character
+  incq    %rcx
+
+  subl    $0x30, %esi           # conver to number
+  cmpl    $9, %esi              # valid digit?
+  ja      .Lscandone
+
+  imull   $10, %eax, %eax       # new value = 10 * old value
+  addl    %esi, %eax            #             + digit
+
+  jmp     .Lscanloop
+
+.Lscandone:
+  testl   %r8d, %r8d            # negative?
+  je      .Lexit
+
+  negl    %eax                  # negate
+
+.Lexit:
+  addq    $32, %rsp
+  popq    %r12
+  popq    %rbx
+  popq    %rbp
+  ret
+
+
+#-------------------------------------------------------------------------------
+# procedure WriteInt(value)
+# (C: void WriteInt(int value))
+#
+# prints a signed integer value in decimal notation to stdout
+#
+# System V AMD64 calling convention (1st parameter in %edi)
+WriteInt:
+  pushq   %rbp
+  movq    %rsp, %rbp
+  subq    $32, %rsp             # result string below %rbp
+
+  movl    %edi, %eax            # value in %eax
+  movl    $10, %r8d             # base divident in %r8d
+  leaq    -8(%rbp), %rsi        # pointer to result string in %rsi
+                                # (decremented before use)
+
+  movl    %eax, %r9d
+  shrl    $31, %r9d             # sign flag in %r9d
+
+  je      .Lloop                # if positive goto Lloop
+  negl    %eax                  # otherwise negate value first
+
+.Lloop:
+  xorl    %edx, %edx            # since %eax is positive
+  divl    %r8d                  # divide value by base
+  addl    $0x30, %edx           # add '0' to remainder
+
+  decq    %rsi
+  movb    %dl, (%rsi)           # add digit to result string
+
+  testl   %eax, %eax            # more digits?
+  jne     .Lloop
+
+  testl   %r9d, %r9d            # sign set?
+  je      .Lprint
+
+  decq    %rsi
+  movb    $0x2d, (%rsi)         # output '-' sign
+
+.Lprint:
+  leaq    -8(%rbp), %rdx
+  subq    %rsi, %rdx            # %rdx = number of characters (= %rbp-8 - %rsi)
+                                # %rsi = pointer to string (already set)
+  movl    $1, %edi              # %rdi = stdout
+  movl    $1, %eax              # %rax = 1 (write syscall)
+  syscall                       # syscall
+
+  movq    %rbp, %rsp
+  popq    %rbp
+  ret
+
+
+#-------------------------------------------------------------------------------
+# procedure WriteStr(str: char[])
+# (C: void WriteStr(ptr to SnuPL/1 array of char str)
+#
+# prints string to stdout.
+# Note: the str parameter is a pointer to an SnuPL/1 array!
+#
+# System V AMD64 calling convention (1st parameter in %rdi)
+WriteStr:
+  pushq   %rbp
+  movq    %rsp, %rbp
+  pushq   %rbx
+  subq    $8, %rsp              # keep %rsp 16-byte aligned
+
+  # get start of array data
+  movq    %rdi, %rbx            # str argument (pointer to array)
+  call    DOFS                  # get offset into data array (%rdi = str)
+  movslq  %eax, %rax
+  addq    %rax, %rbx            # add offset to pointer
+
+  # determine string length
+  movq    %rbx, %rdi            # %rdi = pointer to string
+  movq    $-1, %rcx             # max positive (unsigned) value
+  xorl    %eax, %eax            # set %al = 0 (search for \0)
+  cld                           # clear direction flag
+  repne   scasb                 # find \0 in string
+  notq    %rcx                  # rcx = max. value - string length (incl. \0)
+  decq    %rcx                  # exclude \0
+
+  # print string
+  movq    %rcx, %rdx            # %rdx = number of characters
+  movq    %rbx, %rsi            # %rsi = pointer to string
+  movl    $1, %edi              # %rdi = stdout
+  movl    $1, %eax              # %rax = 1 (write syscall)
+  syscall                       # syscall
+
+  addq    $8, %rsp
+  popq    %rbx
+  popq    %rbp
+  ret
+
+
+#-------------------------------------------------------------------------------
+# procedure WriteChar(c: char)
+# (C: void WriteChar(char c))
+#
+# prints character c to stdout.
+#
+# System V AMD64 calling convention (1st parameter in %dil)
+WriteChar:
+  pushq   %rbp
+  movq    %rsp, %rbp
+  subq    $16, %rsp
+
+  # prepare 'c' on stack
+  movb    %dil, (%rsp)          # 'c'
+
+  # print string
+  movl    $1, %edx              # %rdx = number of characters
+  movq    %rsp, %rsi            # %rsi = pointer to string
+  movl    $1, %edi              # %rdi = stdout
+  movl    $1, %eax              # %rax = 1 (write syscall)
+  syscall                       # syscall
+
+  movq    %rbp, %rsp
+  popq    %rbp
+  ret
+
+
+#-------------------------------------------------------------------------------
+# procedure WriteLn
+# (C: void WriteLn(void))
+#
+# prints a newline to stdout.
+#
+# System V AMD64 calling convention
+WriteLn:
+  pushq   %rbp
+  movq    %rsp, %rbp
+  subq    $16, %rsp
+
+  # prepare newline
+  movb    $0x0a, (%rsp)         # 0x0a (newline)
+
+  # print string
+  movl    $1, %edx              # %rdx = number of characters
+  movq    %rsp, %rsi            # %rsi = pointer to string
+  movl    $1, %edi              # %rdi = stdout
+  movl    $1, %eax              # %rax = 1 (write syscall)
+  syscall                       # syscall
+
+  movq    %rbp, %rsp
+  popq    %rbp
+  ret
+
+  .section .note.GNU-stack,"",@progbits
@@ -35,6 +35,7 @@
 
 .global DIM
 .global DOFS
+.global BoundsError
 
 #-------------------------------------------------------------------------------
 # Dynamic array implementation
@@ -84,3 +85,28 @@ DOFS:
   leal    4(,%eax,4), %eax      # result = 4 + 4*#dim
 
   ret
+
+
+#-------------------------------------------------------------------------------
+# BoundsError
+#
+# target of the array bounds checks inserted with --bounds-check. Prints an
+# error message to stderr and terminates the program with exit code 1.
+#
+# Does not return.
+BoundsError:
+  movl    $4, %eax              # %eax = 4 (write syscall)
+  movl    $2, %ebx              # %ebx = stderr
+  movl    $.Lbounds_msg, %ecx   # %ecx = message
+  movl    $(.Lbounds_end - .Lbounds_msg), %edx # %edx = length of message
+  int     $0x80                 # syscall
+
+  movl    $1, %eax              # %eax = 1 (exit syscall)
+  movl    $1, %ebx              # %ebx = exit code
+  int     $0x80                 # syscall
+
+  .data
+
+.Lbounds_msg:
+  .ascii  "array index out of bounds\n"
+.Lbounds_end:
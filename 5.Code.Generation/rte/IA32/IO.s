@@ -62,9 +62,10 @@ ReadInt:
   pushl   %edi
   subl    $44, %esp             # align at 32-byte boundary
 
-  leal    -12(%ebp), %ecx       # pointer to input string. We need at least an
-                                # 11-char buffer to parse '-2147483648'
-  leal    -1(%ebp), %esi        # last character of input buffer
+  leal    -28(%ebp), %ecx       # pointer to input string. We need at least an
+                                # 11-char buffer to parse '-2147483648'. The
+                                # buffer lies below the saved registers
+  leal    -17(%ebp), %esi       # last character of input buffer
 
 .Lread:
   movl    $1, %edx              # %edx = number of characters to read
@@ -107,7 +108,7 @@ ReadInt:
   je      .Lskipdone
 
   movl    $1, %edx              # %edx = number of characters to read
-  leal    -16(%ebp), %ecx       # %ecx = pointer to (scratch) buffer
+  leal    -32(%ebp), %ecx       # %ecx = pointer to (scratch) buffer
   movl    $0, %ebx              # %ebx = stdin
   movl    $3, %eax              # %eax = 3 (read syscall)
   int     $0x80                 # syscall
@@ -125,7 +126,7 @@ ReadInt:
 
   movl    $0, %eax              # accumulated number
   xorl    %ebx, %ebx            # negative flag
-  leal    -12(%ebp), %ecx       # input string to parse
+  leal    -28(%ebp), %ecx       # input string to parse
 
   movl    $10, %edi             # base multiplicator
 
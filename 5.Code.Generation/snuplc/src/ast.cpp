@@ -982,22 +982,22 @@ void CAstStatWhile::toDot(ostream &out, int indent) const
 
 CTacAddr* CAstStatWhile::ToTac(CCodeBlock *cb, CTacLabel *next)
 {
-  CTacLabel *cond = cb->CreateLabel("while_cond");
   CTacLabel *body = cb->CreateLabel("while_body");
   CAstStatement *bodyStat = GetBody();
 
   /* The TAC of CAstStatWhile has the form as follwing;
+   * the loop is rotated such that each iteration executes only the
+   * conditional branch at the bottom of the loop.
    *
-   * while_cond:
    *   if (the condition is true) goto while_body
    *   goto next
    * while_body:
    *   (whileBody statement sequence)
-   *   goto while_cond
+   *   if (the condition is true) goto while_body
+   *   goto next
    * next:
    */
 
-  cb->AddInstr(cond);
   GetCondition()->ToTac(cb, body, next);
 
   cb->AddInstr(body);
@@ -1008,7 +1008,7 @@ CTacAddr* CAstStatWhile::ToTac(CCodeBlock *cb, CTacLabel *next)
     bodyStat = bodyStat->GetNext();
   }
 
-  cb->AddInstr(new CTacInstr(opGoto, cond, NULL, NULL));
+  GetCondition()->ToTac(cb, body, next);
   cb->AddInstr(new CTacInstr(opGoto, next, NULL, NULL));
 
   return NULL;
@@ -1772,6 +1772,22 @@ CTacAddr* CAstFunctionCall::ToTac(CCodeBlock *cb)
 
   int n = GetNArgs();
 
+  // the dimensions of statically shaped arrays are constants
+  const CSymProc *proc = GetSymbol();
+  const CAstConstant *k = n == 2 ? dynamic_cast<const CAstConstant*>(GetArg(1)) : NULL;
+  if (proc->IsExternal() && (proc->GetName() == "DIM") && (k != NULL)) {
+    const CType *at = GetArg(0)->GetType();
+    if ((at != NULL) && at->IsPointer())
+      at = dynamic_cast<const CPointerType*>(at)->GetBaseType();
+
+    const CArrayType *a = dynamic_cast<const CArrayType*>(at);
+    for (long long d = 1; (a != NULL) && (d < k->GetValue()); d++)
+      a = dynamic_cast<const CArrayType*>(a->GetInnerType());
+
+    if ((a != NULL) && (k->GetValue() >= 1) && (a->GetNElem() != CArrayType::OPEN))
+      return new CTacConst(a->GetNElem());
+  }
+
   for (int i = n - 1; i >= 0; i--) {
       CTacAddr *argTac = GetArg(i)->ToTac(cb);
       CTacInstr *instr = new CTacInstr(opParam, new CTacConst(i), argTac, NULL);
@@ -2016,9 +2032,6 @@ CTacAddr* CAstArrayDesignator::ToTac(CCodeBlock *cb)
   const CSymbol *DIM_SYM = st->FindSymbol("DIM");
   CAstConstant *DIM_VAL = new CAstConstant(t, tm->GetInt(), 0);
 
-  // prepare DOFS
-  const CSymbol *DOFS_SYM = st->FindSymbol("DOFS");
-
   // get array identifier properties
   CTacAddr *id = new CTacName(GetSymbol());
   CAstExpression *idExpr = new CAstDesignator(GetToken(), GetSymbol());
@@ -2045,17 +2058,38 @@ CTacAddr* CAstArrayDesignator::ToTac(CCodeBlock *cb)
   int dataSize = dataType->GetBaseType()->GetSize();
 
   CTacAddr *idx = NULL;
+  const CArrayType *dimType = dataType;
   int iterateCount = dataType->GetNDim();
   for (int i = 0; i < iterateCount; i++) {
     // evaluate index
-    if (!idx)
-      idx = GetIndex(i)->ToTac(cb);
-    else {
-      CTacAddr *prev = new CTacConst(0);
+    CTacAddr *prev = new CTacConst(0);
+
+    if (i < GetNIndices()) {
+      prev = GetIndex(i)->ToTac(cb);
 
-      if (i < GetNIndices())
-        prev = GetIndex(i)->ToTac(cb);
+      // check index against the size of the dimension
+      if (cb->GetOwner()->GetBoundsCheck()) {
+        CTacAddr *dimSize;
 
+        if (dimType->GetNElem() == CArrayType::OPEN) {
+          CAstFunctionCall *DIM_FUN =
+            new CAstFunctionCall(t, dynamic_cast<const CSymProc*>(DIM_SYM));
+
+          DIM_FUN->AddArg(idExpr);
+          DIM_FUN->AddArg(new CAstConstant(t, tm->GetInt(), i + 1));
+          dimSize = DIM_FUN->ToTac(cb);
+        }
+        else
+          dimSize = new CTacConst(dimType->GetNElem());
+
+        cb->AddInstr(new CTacInstr(opCheck, NULL, prev, dimSize));
+      }
+    }
+    dimType = dynamic_cast<const CArrayType*>(dimType->GetInnerType());
+
+    if (!idx)
+      idx = prev;
+    else {
       CTacAddr *next = cb->CreateTemp(tm->GetInt());
       cb->AddInstr(new CTacInstr(opAdd, next, idx, prev));
       idx = next;
@@ -2064,14 +2098,20 @@ CTacAddr* CAstArrayDesignator::ToTac(CCodeBlock *cb)
     if (i == iterateCount - 1)
       break;
 
-    // call dimention size
-    CAstFunctionCall *DIM_FUN =
-      new CAstFunctionCall(t, dynamic_cast<const CSymProc*>(DIM_SYM));
+    // dimention size: known for statically shaped arrays, DIM for open ones
+    CTacAddr *entrySize;
 
-    DIM_FUN->AddArg(idExpr);
-    DIM_VAL->SetValue(i + 2);
-    DIM_FUN->AddArg(DIM_VAL);
-    CTacAddr *entrySize = DIM_FUN->ToTac(cb);
+    if (dimType->GetNElem() == CArrayType::OPEN) {
+      CAstFunctionCall *DIM_FUN =
+        new CAstFunctionCall(t, dynamic_cast<const CSymProc*>(DIM_SYM));
+
+      DIM_FUN->AddArg(idExpr);
+      DIM_VAL->SetValue(i + 2);
+      DIM_FUN->AddArg(DIM_VAL);
+      entrySize = DIM_FUN->ToTac(cb);
+    }
+    else
+      entrySize = new CTacConst(dimType->GetNElem());
 
     // multiply dimention size
     CTacAddr *next = cb->CreateTemp(tm->GetInt());
@@ -2084,12 +2124,9 @@ CTacAddr* CAstArrayDesignator::ToTac(CCodeBlock *cb)
   cb->AddInstr(new CTacInstr(opMul, tmp, idx, new CTacConst(dataSize)));
   idx = tmp;
 
-  // calculate array offset
-  CAstFunctionCall *DOFS_FUN =
-    new CAstFunctionCall(t, dynamic_cast<const CSymProc*>(DOFS_SYM));
-
-  DOFS_FUN->AddArg(idExpr);
-  CTacAddr *ofs = DOFS_FUN->ToTac(cb);
+  // calculate array offset: the data follows the header holding the number
+  // of dimensions and the size of each dimension (what DOFS returns)
+  CTacAddr *ofs = new CTacConst(4 + 4 * dataType->GetNDim());
 
   tmp = cb->CreateTemp(tm->GetInt());
   cb->AddInstr(new CTacInstr(opAdd, tmp, idx, ofs));
@@ -36,8 +36,11 @@
 #include <sstream>
 #include <iomanip>
 #include <cassert>
+#include <set>
+#include <algorithm>
 
 #include "backend.h"
+#include "cfg.h"
 using namespace std;
 
 
@@ -93,17 +96,270 @@ void CBackend::EmitFooter(void)
 }
 
 
+//------------------------------------------------------------------------------
+// inlined runtime functions
+//
+
+/// @brief collect the calls DIM(a, k) of @a scope with a constant k that are
+///        inlined as a load of the size of dimension k from the array header
+///        at offset 4*k. The array has to be passed right before the call.
+/// @param dim receives the array and the offset in the header per call
+/// @param args receives the instructions passing the arguments of the calls
+static void FindDimCalls(CScope *scope,
+                         map<const CTacInstr*, pair<CTacAddr*, int> > &dim,
+                         set<const CTacInstr*> &args)
+{
+  dim.clear();
+  args.clear();
+
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator prev = il.end();
+
+  for (list<CTacInstr*>::const_iterator it = il.begin(); it != il.end(); prev = it++) {
+    if ((*it)->GetOperation() != opCall) continue;
+
+    const CSymProc *proc = GetCallee(*it);
+    vector<CTacInstr*> params;
+    if (!proc->IsExternal() || (proc->GetName() != "DIM") ||
+        !GetParams(il.begin(), it, params) || (params[0] != *prev))
+      continue;
+
+    const CTacName *a = dynamic_cast<const CTacName*>(params[0]->GetSrc(1));
+    const CTacConst *k = dynamic_cast<const CTacConst*>(params[1]->GetSrc(1));
+    if ((a == NULL) || (dynamic_cast<const CTacReference*>(a) != NULL) ||
+        (k == NULL))
+      continue;
+
+    dim[*it] = make_pair(params[0]->GetSrc(1), 4 * (int)k->GetValue());
+    args.insert(params[0]);
+    args.insert(params[1]);
+  }
+}
+
+
 //------------------------------------------------------------------------------
 // CBackendx86
 //
-CBackendx86::CBackendx86(ostream &out)
-  : CBackend(out), _curr_scope(NULL)
+
+// registers available to the register allocators. %ecx and %edx are
+// caller-saved and clobbered by calls and divisions; %esi and %edi are saved
+// by the prologue if used
+static const char *regs[] = { "%ecx", "%edx", "%esi", "%edi" };
+static const int nregs = 4;       // number of registers
+static const int ncallee = 2;     // number of callee-saved registers (last)
+
+// calls between SnuPL procedures pass the first arguments in registers; the
+// runtime builtins keep the stack-based cdecl convention
+static const char *fastregs[] = { "%ecx", "%edx" };
+static const int nfastregs = 2;
+
+/// @brief return the number of arguments of @a proc passed in registers
+static int RegisterArgs(const CSymProc *proc)
+{
+  if (proc->IsExternal()) return 0;
+  return proc->GetNParams() < nfastregs ? proc->GetNParams() : nfastregs;
+}
+
+/// @brief return the index in regs[] of the register argument @a s arrives
+///        in (the argument registers come first there), or -1
+static int ArgRegister(const CSymbol *s)
+{
+  const CSymParam *p = dynamic_cast<const CSymParam*>(s);
+  return (p != NULL) && (p->GetIndex() < nfastregs) ? p->GetIndex() : -1;
+}
+
+/// @brief collect the register arguments of the calls of @a scope that are
+///        loaded into their registers at the call instead of being pushed.
+///        The value of such an argument must not change between its opParam
+///        and the call: no other call, branch, definition of its operands
+///        or store through a reference may occur in between.
+/// @param dim inlined DIM calls (see FindDimCalls)
+/// @param regargs receives the arguments loaded by each call, indexed by
+///        parameter number (NULL if the argument is pushed)
+/// @param args receives the instructions passing these arguments
+static void FindRegisterArgs(CScope *scope,
+                             const map<const CTacInstr*, pair<CTacAddr*, int> > &dim,
+                             map<const CTacInstr*, vector<const CTacInstr*> > &regargs,
+                             set<const CTacInstr*> &args)
+{
+  regargs.clear();
+  args.clear();
+
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+
+  for (list<CTacInstr*>::const_iterator it = il.begin(); it != il.end(); it++) {
+    if ((*it)->GetOperation() != opCall) continue;
+
+    int nreg = RegisterArgs(GetCallee(*it));
+    vector<CTacInstr*> params;
+    if ((nreg == 0) || !GetParams(il.begin(), it, params)) continue;
+
+    vector<const CTacInstr*> &load = regargs[*it];
+    load.assign(nreg, NULL);
+
+    for (int k = 0; k < nreg; k++) {
+      vector<const CSymbol*> used;
+      GetUsedSymbols(params[k], used);
+      bool memory = dynamic_cast<const CTacName*>(params[k]->GetSrc(1)) != NULL;
+      bool ok = true;
+
+      list<CTacInstr*>::const_iterator b = it;
+      while (ok && (*--b != params[k])) {
+        const CTacInstr *q = *b;
+        EOperation op = q->GetOperation();
+        const CSymbol *d = GetDefinedSymbol(q);
+
+        if ((op == opLabel) || q->IsBranch() || (op == opReturn) ||
+            ((op == opCall) && (dim.count(q) == 0)))
+          ok = false;
+        else if (memory && WritesMemory(q))
+          ok = false;
+        else if ((d != NULL) && (find(used.begin(), used.end(), d) != used.end()))
+          ok = false;
+      }
+
+      if (ok) {
+        load[k] = params[k];
+        args.insert(params[k]);
+      }
+    }
+  }
+}
+
+// IA32 registers and their 16- and 8-bit parts
+static const char *regparts[][4] = {
+  { "%eax", "%ax", "%al", "%ah" },
+  { "%ebx", "%bx", "%bl", "%bh" },
+  { "%ecx", "%cx", "%cl", "%ch" },
+  { "%edx", "%dx", "%dl", "%dh" },
+  { "%esi", "%si", "%si", "%si" },
+  { "%edi", "%di", "%di", "%di" },
+};
+static const int nregparts = sizeof(regparts) / sizeof(regparts[0]);
+
+/// @brief return the index of the 32-bit register @a op or -1
+static int Register32(const string &op)
+{
+  for (int r = 0; r < nregparts; r++)
+    if (op == regparts[r][0]) return r;
+  return -1;
+}
+
+/// @brief check whether operand @a op refers to (a part of) register @a r
+static bool Mentions(const string &op, int r)
+{
+  for (int p = 0; p < 4; p++)
+    if (op.find(regparts[r][p]) != string::npos) return true;
+  return false;
+}
+
+// instruction selection grammar
+//
+// Expression trees are covered by bottom-up tree pattern matching: every
+// node is labeled with the cheapest rule deriving each nonterminal (BURS),
+// and the tree is then reduced from the nonterminal the root requires.
+// Rules match an operator with the nonterminals of its operands, a leaf
+// pattern, or another nonterminal (chain rules). Costs approximate cycles.
+
+// nonterminals
+enum {
+  ntImm,                          // constant                 $c
+  ntScale,                        // constant 1, 2, 4 or 8    c
+  ntReg,                          // variable in a register   %esi
+  ntMem,                          // 4-byte memory operand    -8(%ebp), (%esi)
+  ntLeaf,                         // any leaf (loaded by the consuming rule)
+  ntRM,                           // register or memory
+  ntSrc,                          // source operand: rm, imm or loaded to %ebx
+  ntAcc,                          // value computed into %eax
+  ntBase,                         // base register of an address
+  ntIndex,                        // index register and scale of an address
+  ntAddr,                         // address computed by lea
+  ntCount
+};
+
+// leaf patterns and chain rules
+enum { lfConst = -1, lfScale = -2, lfReg = -3, lfMem = -4, lfAny = -5, opChain = -6 };
+
+// rule actions
+enum { aLeaf, aChain, aLoad, aLea, aBinary, aUnary, aIndex, aAddress };
+
+static const int INF = 1 << 20;
+
+static const struct SRule {
+  int lhs;                        // nonterminal derived
+  int op;                         // operator or leaf pattern
+  int kid[2];                     // nonterminals of the operands (or -1)
+  int cost;                       // cost
+  int action;                     // emitter
+} rules[] = {
+  { ntImm,   lfConst, { -1,      -1      }, 0,  aLeaf    },
+  { ntScale, lfScale, { -1,      -1      }, 0,  aLeaf    },
+  { ntReg,   lfReg,   { -1,      -1      }, 0,  aLeaf    },
+  { ntMem,   lfMem,   { -1,      -1      }, 0,  aLeaf    },
+  { ntLeaf,  lfAny,   { -1,      -1      }, 0,  aLeaf    },
+
+  { ntRM,    opChain, { ntReg,   -1      }, 0,  aChain   },
+  { ntRM,    opChain, { ntMem,   -1      }, 0,  aChain   },
+  { ntSrc,   opChain, { ntRM,    -1      }, 0,  aChain   },
+  { ntSrc,   opChain, { ntImm,   -1      }, 0,  aChain   },
+  { ntSrc,   opChain, { ntLeaf,  -1      }, 1,  aLoad    },   // mov  x, %ebx
+  { ntAcc,   opChain, { ntLeaf,  -1      }, 1,  aLoad    },   // mov  x, %eax
+  { ntAcc,   opChain, { ntAddr,  -1      }, 1,  aLea     },   // leal a, %eax
+  { ntBase,  opChain, { ntReg,   -1      }, 0,  aChain   },
+  { ntBase,  opChain, { ntAcc,   -1      }, 0,  aChain   },
+  { ntIndex, opChain, { ntReg,   -1      }, 0,  aIndex   },   // (,r,1)
+
+  { ntIndex, opMul,   { ntReg,   ntScale }, 0,  aIndex   },   // (,r,s)
+  { ntIndex, opMul,   { ntScale, ntReg   }, 0,  aIndex   },
+  { ntAddr,  opMul,   { ntReg,   ntScale }, 0,  aAddress },   // 0(,r,s)
+  { ntAddr,  opMul,   { ntScale, ntReg   }, 0,  aAddress },
+  { ntAddr,  opAdd,   { ntBase,  ntIndex }, 0,  aAddress },   // (b,r,s)
+  { ntAddr,  opAdd,   { ntIndex, ntBase  }, 0,  aAddress },
+  { ntAddr,  opAdd,   { ntBase,  ntImm   }, 0,  aAddress },   // c(b)
+  { ntAddr,  opAdd,   { ntImm,   ntBase  }, 0,  aAddress },
+  { ntAddr,  opSub,   { ntBase,  ntImm   }, 0,  aAddress },
+  { ntAddr,  opAdd,   { ntAddr,  ntImm   }, 0,  aAddress },   // c(b,r,s)
+  { ntAddr,  opAdd,   { ntImm,   ntAddr  }, 0,  aAddress },
+  { ntAddr,  opSub,   { ntAddr,  ntImm   }, 0,  aAddress },
+
+  { ntAcc,   opAdd,   { ntAcc,   ntSrc   }, 1,  aBinary  },   // addl
+  { ntAcc,   opAdd,   { ntSrc,   ntAcc   }, 1,  aBinary  },
+  { ntAcc,   opSub,   { ntAcc,   ntSrc   }, 1,  aBinary  },   // subl
+  { ntAcc,   opSub,   { ntSrc,   ntAcc   }, 2,  aBinary  },   // negl; addl
+  { ntAcc,   opMul,   { ntAcc,   ntImm   }, 2,  aBinary  },   // lea/shl
+  { ntAcc,   opMul,   { ntImm,   ntAcc   }, 2,  aBinary  },
+  { ntAcc,   opMul,   { ntAcc,   ntSrc   }, 3,  aBinary  },   // imull
+  { ntAcc,   opMul,   { ntSrc,   ntAcc   }, 3,  aBinary  },
+  { ntAcc,   opDiv,   { ntAcc,   ntImm   }, 6,  aBinary  },   // magic number
+  { ntAcc,   opDiv,   { ntAcc,   ntLeaf  }, 26, aBinary  },   // idivl
+  { ntAcc,   opDiv,   { ntLeaf,  ntAcc   }, 27, aBinary  },
+  { ntAcc,   opUDiv,  { ntAcc,   ntImm   }, 5,  aBinary  },
+  { ntAcc,   opUDiv,  { ntAcc,   ntLeaf  }, 26, aBinary  },   // divl
+  { ntAcc,   opUDiv,  { ntLeaf,  ntAcc   }, 27, aBinary  },
+  { ntAcc,   opNeg,   { ntAcc,   -1      }, 1,  aUnary   },   // negl
+  { ntAcc,   opPos,   { ntAcc,   -1      }, 0,  aUnary   },
+};
+
+static const int nrules = sizeof(rules) / sizeof(rules[0]);
+
+/// @brief expression tree node
+struct CBackendx86::CNode {
+  EOperation op;                  ///< operation (opNop for leaves)
+  CTacAddr *leaf;                 ///< operand of a leaf
+  CNode *kid[2];                  ///< operands of an inner node
+  int cost[ntCount];              ///< cost of deriving a nonterminal
+  int rule[ntCount];              ///< rule deriving a nonterminal
+};
+
+CBackendx86::CBackendx86(ostream &out, int level)
+  : CBackend(out), _curr_scope(NULL), _level(level)
 {
   _ind = string(4, ' ');
 }
 
 CBackendx86::~CBackendx86(void)
 {
+  ClearTrees();
 }
 
 void CBackendx86::EmitHeader(void)
@@ -126,6 +382,7 @@ void CBackendx86::EmitCode(void)
        << _ind << ".global main" << endl
        << _ind << ".extern DIM" << endl
        << _ind << ".extern DOFS" << endl
+       << _ind << ".extern BoundsError" << endl
        << _ind << ".extern ReadInt" << endl
        << _ind << ".extern WriteInt" << endl
        << _ind << ".extern WriteStr" << endl
@@ -193,65 +450,148 @@ void CBackendx86::EmitScope(CScope *scope)
   else label = scope->GetName();
 
   /* label */
-  _out << _ind << "# scope " << scope->GetName() << endl
-       << label << ":" << endl;
+  EmitLine(_ind + "# scope " + scope->GetName());
+  EmitLabel(label);
 
-  /* ComputeStackOffsets(scope) */
-  _out << _ind << "# stack offsets:" << endl;
-  size_t size = ComputeStackOffsets(scope->GetSymbolTable(), +8, -12);
-  _out << endl;
+  /* BuildTrees(scope), AllocateRegisters(scope)
+   * before the stack layout; register-allocated locals and temporaries
+   * folded into trees need no stack slot
+   */
+  vector<const CSymbol*> init;
+  FindDimCalls(scope, _dim, _dimargs);
+  FindRegisterArgs(scope, _dim, _regargs, _regparams);
+  BuildTrees(scope);
+  AllocateRegisters(scope, init);
+
+  /* ComputeStackOffsets(scope)
+   * assumes that all callee-saved registers are saved; AdjustFrame() moves
+   * the stack slots once the saved registers are known
+   */
+  CSymtab *st = scope->GetSymbolTable();
+  size_t size = ComputeStackOffsets(st, +8, -12);
 
-  /* emit function prologue */
-  _out << _ind << "# prologue" << endl;
-  EmitInstruction("pushl", "%ebp");
-  EmitInstruction("movl", "%esp, %ebp");
-  EmitInstruction("pushl", "%ebx", "save callee saved registers");
-  EmitInstruction("pushl", "%esi");
-  EmitInstruction("pushl", "%edi");
-  EmitInstruction("subl", "$" + to_string(size) + ", %esp", "make room for locals");
+  /* the function body is emitted first: the prologue and epilogue depend on
+   * the registers it uses
+   */
+  size_t start = _code.size();
 
-  /* memset local stack area to 0
-   * there are 2 different ways depending on total stack offset
+  /* the arguments passed in %ecx and %edx go to their stack slots or
+   * register variables before anything else uses these registers
    */
-  if (size >= 20) {
-    _out << endl;
-    EmitInstruction("cld", "", "memset local stack area to 0");
-    EmitInstruction("xorl", "%eax, %eax");
-    EmitInstruction("movl", "$" + to_string(size/4) + ", %ecx");
-    EmitInstruction("mov", "%esp, %edi");
-    EmitInstruction("rep", "stosl");
-  }
-  else if (size > 0) {
-    _out << endl;
-    EmitInstruction("xorl", "%eax, %eax", "memset local stack area to 0");
-    for (int i = size - 4; i >= 0; i -= 4)
-      EmitInstruction("movl", "%eax, " + to_string(i) + "(%esp)");
-  }
+  EmitRegisterArgs(st, init);
+
+  /* zero the locals that may be read before they are written; rep stosl
+   * would clobber register arguments kept in %ecx or %edi
+   */
+  bool rep = true;
+  for (const auto &s : init)
+    if ((s->GetSymbolType() == stParam) &&
+        ((Register(s) == "%ecx") || (Register(s) == "%edi")))
+      rep = false;
+
+  set<const CSymbol*> uninit;
+  FindUninitialized(scope, uninit);
+  ZeroLocals(st, size, uninit, rep);
 
   /* emit local data */
   if (scope->GetParent())
     EmitLocalData(scope);
-  _out << endl;
+
+  /* initialize register variables that are live at the entry; the
+   * arguments passed in registers are already in place
+   */
+  bool first = true;
+  for (const auto &s : init) {
+    string reg = Register(s);
+    string cmt = "register variable '" + s->GetName() + "'";
+
+    if ((s->GetSymbolType() == stParam) &&
+        (dynamic_cast<const CSymParam*>(s)->GetIndex() < nfastregs))
+      continue;
+
+    if (first) EmitLine();
+    first = false;
+
+    if (s->GetSymbolType() == stParam) {
+      string slot = to_string(s->GetOffset()) + "(" + s->GetBaseRegister() + ")";
+      EmitInstruction("movl", slot + ", " + reg, cmt);
+    }
+    else
+      EmitInstruction("xorl", reg + ", " + reg, cmt);
+  }
+  EmitLine();
 
   /* emit function body */
-  _out << _ind << "# function body" << endl;
+  EmitLine(_ind + "# function body");
   const list<CTacInstr*> &instructions = scope->GetCodeBlock()->GetInstr();
 
   for (const auto &i : instructions) {
-    EmitInstruction(i);
+    if (_level >= 1) SelectInstruction(i);
+    else EmitInstruction(i);
   }
-  _out << endl;
+  EmitLine();
+
+  vector<CMachInstr> body(_code.begin() + start, _code.end());
+  _code.resize(start);
+
+  /* save the callee-saved registers used by the body. Procedures without
+   * locals that neither call nor push need no frame; their parameters are
+   * addressed relative to %esp
+   */
+  const char *callee_saved[] = { "%ebx", "%esi", "%edi" };
+  vector<string> saved;
+  bool frame = size > 0;
+
+  for (const auto &mi : body)
+    if ((mi.mnemonic == "call") || (mi.mnemonic == "pushl")) frame = true;
+
+  for (const auto &reg : callee_saved) {
+    int r = Register32(reg);
+    bool used = false;
+    for (const auto &mi : body) {
+      if ((mi.mnemonic == "rep") && (string(reg) == "%edi")) used = true;
+      for (const auto &op : mi.ops)
+        if (Mentions(op, r)) used = true;
+    }
+    if (used) saved.push_back(reg);
+  }
+
+  AdjustFrame(st, body, saved.size(), frame);
+
+  /* stack offsets */
+  EmitLine(_ind + "# stack offsets:");
+  EmitStackOffsets(st);
+  EmitLine();
+
+  /* emit function prologue */
+  EmitLine(_ind + "# prologue");
+  if (frame) {
+    EmitInstruction("pushl", "%ebp");
+    EmitInstruction("movl", "%esp, %ebp");
+  }
+  for (size_t r = 0; r < saved.size(); r++)
+    EmitInstruction("pushl", saved[r], r == 0 ? "save callee saved registers" : "");
+  if (size > 0)
+    EmitInstruction("subl", "$" + to_string(size) + ", %esp", "make room for locals");
+
+  _code.insert(_code.end(), body.begin(), body.end());
 
   /* emit function epilogue */
-  _out << Label("exit") << ":" << endl
-       << _ind << "# epilogue" << endl;
-  EmitInstruction("addl", "$" + to_string(size) + ", %esp", "remove locals");
-  EmitInstruction("popl", "%edi");
-  EmitInstruction("popl", "%esi");
-  EmitInstruction("popl", "%ebx");
-  EmitInstruction("popl", "%ebp");
+  EmitLabel(Label("exit"));
+  EmitLine(_ind + "# epilogue");
+  if (size > 0)
+    EmitInstruction("addl", "$" + to_string(size) + ", %esp", "remove locals");
+  for (size_t r = saved.size(); r > 0; r--)
+    EmitInstruction("popl", saved[r-1]);
+  if (frame)
+    EmitInstruction("popl", "%ebp");
   EmitInstruction("ret");
-  _out << endl;
+  EmitLine();
+
+  if (_level >= 1) Peephole();
+  EmitMachineCode();
+
+  ClearTrees();
 }
 
 void CBackendx86::EmitGlobalData(CScope *scope)
@@ -342,8 +682,6 @@ void CBackendx86::EmitLocalData(CScope *scope)
 
   _out << dec;
 
-  size_t size = 0;
-
   for (size_t i = 0; i < slist.size(); i++) {
     CSymbol *s = slist[i];
     const CType *t = s->GetDataType();
@@ -402,8 +740,28 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
     case opSub:
     case opMul:
     case opDiv:
+    case opUDiv:
     case opAnd:
     case opOr:
+    {
+      CTacConst *c1 = dynamic_cast<CTacConst*>(i->GetSrc(1));
+      CTacConst *c2 = dynamic_cast<CTacConst*>(i->GetSrc(2));
+
+      // multiplication and division by a constant
+      if ((op == opMul) && (c1 != NULL) && (c2 == NULL)) {
+        Load(i->GetSrc(2), "%eax", cmt.str());
+        EmitMulConst(c1->GetValue());
+        Store(i->GetDest(), 'a');
+        break;
+      }
+      if (((op == opMul) || (op == opDiv) || (op == opUDiv)) && (c2 != NULL)) {
+        Load(i->GetSrc(1), "%eax", cmt.str());
+        if (op == opMul) EmitMulConst(c2->GetValue());
+        else EmitDivConst(c2->GetValue(), op == opUDiv);
+        Store(i->GetDest(), 'a');
+        break;
+      }
+
       Load(i->GetSrc(1), "%eax", cmt.str());
       Load(i->GetSrc(2), "%ebx");
       if (op == opAdd)
@@ -416,6 +774,10 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
         EmitInstruction("cdq");
         EmitInstruction("idivl", "%ebx");
       }
+      else if (op == opUDiv) {
+        EmitInstruction("xorl", "%edx, %edx");
+        EmitInstruction("divl", "%ebx");
+      }
       else if (op == opAnd) {
         /* opAnd will not be appeared */
         EmitInstruction("andl", "%eax, %ebx");
@@ -427,6 +789,7 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
 
       Store(i->GetDest(), 'a');
       break;
+    }
 
     // unary operators
     // dst = op src1
@@ -446,14 +809,31 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
     // memory operations
     // dst = src1
     case opAssign:
+    {
+      // register variables are loaded directly; moves between coalesced
+      // variables vanish
+      const CTacName *dst = dynamic_cast<const CTacName*>(i->GetDest());
+      const CTacName *src = dynamic_cast<const CTacName*>(i->GetSrc(1));
+      string reg;
+      if ((dst != NULL) && (dynamic_cast<const CTacReference*>(dst) == NULL))
+        reg = Register(dst->GetSymbol());
+
+      if (reg != "") {
+        if ((src == NULL) || (dynamic_cast<const CTacReference*>(src) != NULL) ||
+            (Register(src->GetSymbol()) != reg))
+          Load(i->GetSrc(1), reg, cmt.str());
+        break;
+      }
+
       Load(i->GetSrc(1), "%eax", cmt.str());
       Store(i->GetDest(), 'a');
       break;
+    }
 
     // pointer operations
     // dst = &src1
     case opAddress:
-      EmitInstruction("leal", Operand(i->GetSrc(1)) + ", %eax", cmt.str());
+      EmitInstruction("leal", Operand(i->GetSrc(1), "%eax") + ", %eax", cmt.str());
       Store(i->GetDest(), 'a');
       break;
     // dst = *src1
@@ -476,11 +856,41 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
     case opLessEqual:
     case opBiggerThan:
     case opBiggerEqual:
-      Load(i->GetSrc(1), "%eax", cmt.str());
-      Load(i->GetSrc(2), "%ebx");
-      EmitInstruction("cmpl", "%ebx, %eax");
+    {
+      // immediates and memory operands are compared directly, registers
+      // tested against zero. The left operand goes into a register unless
+      // the right one is a register: cmp mem, imm does not fuse with jcc
+      CTacAddr *l = i->GetSrc(1), *r = i->GetSrc(2);
+      string lhs, rhs;
+      _cmt = cmt.str();
+
+      if (dynamic_cast<CTacConst*>(r) != NULL)
+        rhs = Operand(r, "");
+      else if (OperandSize(r) == 4)
+        rhs = Operand(r, "%ebx");
+      else {
+        Load(r, "%ebx");
+        rhs = "%ebx";
+      }
+
+      CTacName *n = dynamic_cast<CTacName*>(l);
+      if ((n != NULL) && (OperandSize(l) == 4) &&
+          ((rhs[0] == '%') || ((dynamic_cast<CTacReference*>(l) == NULL) &&
+                               (Register(n->GetSymbol()) != ""))))
+        lhs = Operand(l, "%eax");
+      else {
+        Load(l, "%eax");
+        lhs = "%eax";
+      }
+
+      if ((rhs == "$0") && (lhs[0] == '%'))
+        EmitInstruction("testl", lhs + ", " + lhs);
+      else
+        EmitInstruction("cmpl", rhs + ", " + lhs);
       EmitInstruction("j" + Condition(op), Label(dynamic_cast<const CTacLabel*>(i->GetDest())));
+      _cmt = "";
       break;
+    }
 
     // function call-related operations
     case opCall:
@@ -490,9 +900,72 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
       assert(fun != NULL);
       assert(sym != NULL);
 
-      EmitInstruction("call", sym->GetName(), cmt.str());
-      if (sym->GetNParams() > 0)
-        EmitInstruction("addl", "$" + to_string(4 * sym->GetNParams()) + ", %esp");
+      // inlined DIM: load the size of the dimension from the array header
+      map<const CTacInstr*, pair<CTacAddr*, int> >::const_iterator d = _dim.find(i);
+      if (d != _dim.end()) {
+        string c = cmt.str();
+        string base = Operand(d->second.first, "%eax");
+        if (base[0] != '%') {
+          EmitInstruction("movl", base + ", %eax", c);
+          base = "%eax";
+          c = "";
+        }
+        EmitInstruction("movl", to_string(d->second.second) + "(" + base + "), %eax", c);
+        if (i->GetDest())
+          Store(i->GetDest(), 'a');
+        break;
+      }
+
+      // the stack arguments have been pushed in reverse order. The register
+      // arguments are loaded into their registers here; those that could
+      // change before the call were pushed last and are popped after the
+      // loads, which may read %ecx or %edx
+      string c = cmt.str();
+      int nreg = RegisterArgs(sym);
+      vector<const CTacInstr*> load(nreg, NULL);
+      map<const CTacInstr*, vector<const CTacInstr*> >::const_iterator r = _regargs.find(i);
+      if (r != _regargs.end()) load = r->second;
+
+      // held: register read by an argument, placed: the argument is the
+      // value of its register already
+      string held[2];
+      bool placed[2] = { false, false };
+      for (int k = 0; k < nreg; k++) {
+        const CTacName *n = load[k] ? dynamic_cast<const CTacName*>(load[k]->GetSrc(1)) : NULL;
+        if (n != NULL) held[k] = Register(n->GetSymbol());
+        placed[k] = (held[k] == fastregs[k]) &&
+                    (dynamic_cast<const CTacReference*>(n) == NULL);
+      }
+
+      // %edx is loaded first if its argument is in %ecx; swapped arguments
+      // go through %eax
+      int order[2] = { 0, 1 };
+      bool first = (nreg == 2) && load[0] && load[1] && (held[1] == fastregs[0]);
+      if (first) swap(order[0], order[1]);
+
+      if (first && (held[0] == fastregs[1])) {
+        Load(load[0]->GetSrc(1), "%eax", c);
+        Load(load[1]->GetSrc(1), fastregs[1]);
+        EmitInstruction("movl", string("%eax, ") + fastregs[0]);
+        c = "";
+      }
+      else
+        for (int j = 0; j < nreg; j++) {
+          int k = order[j];
+          if ((load[k] == NULL) || placed[k]) continue;
+          Load(load[k]->GetSrc(1), fastregs[k], c);
+          c = "";
+        }
+
+      for (int k = 0; k < nreg; k++) {
+        if (load[k] != NULL) continue;
+        EmitInstruction("popl", fastregs[k], c);
+        c = "";
+      }
+
+      EmitInstruction("call", sym->GetName(), c);
+      if (sym->GetNParams() > nreg)
+        EmitInstruction("addl", "$" + to_string(4 * (sym->GetNParams() - nreg)) + ", %esp");
       if (i->GetDest())
         Store(i->GetDest(), 'a');
       break;
@@ -506,13 +979,28 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
         EmitInstruction("jmp", Label("exit"), cmt.str());
       break;
     case opParam:
+      if ((_dimargs.count(i) > 0) || (_regparams.count(i) > 0)) break;
+
+      if (OperandSize(i->GetSrc(1)) == 4)
+        EmitInstruction("pushl", Operand(i->GetSrc(1), "%eax"), cmt.str());
+      else {
+        Load(i->GetSrc(1), "%eax", cmt.str());
+        EmitInstruction("pushl", "%eax");
+      }
+      break;
+
+    // runtime checks
+    case opCheck:
+      // a single unsigned comparison also catches negative indices
       Load(i->GetSrc(1), "%eax", cmt.str());
-      EmitInstruction("pushl", "%eax");
+      Load(i->GetSrc(2), "%ebx");
+      EmitInstruction("cmpl", "%ebx, %eax");
+      EmitInstruction("jae", "BoundsError");
       break;
 
     // special
     case opLabel:
-      _out << Label(dynamic_cast<CTacLabel*>(i)) << ":" << endl;
+      EmitLabel(Label(dynamic_cast<CTacLabel*>(i)));
       break;
 
     case opNop:
@@ -526,12 +1014,230 @@ void CBackendx86::EmitInstruction(CTacInstr *i)
 
 void CBackendx86::EmitInstruction(string mnemonic, string args, string comment)
 {
-  _out << left
-       << _ind
-       << setw(7) << mnemonic << " "
-       << setw(23) << args;
-  if (comment != "") _out << " # " << comment;
-  _out << endl;
+  // the first instruction selected for a TAC instruction carries its comment
+  if (comment == "") comment = _cmt;
+  _cmt = "";
+
+  CMachInstr mi;
+  mi.mnemonic = mnemonic;
+  mi.comment = comment;
+
+  // split the operands at the commas outside of parentheses
+  size_t start = 0;
+  int depth = 0;
+  for (size_t p = 0; p <= args.size(); p++) {
+    if ((p == args.size()) || ((args[p] == ',') && (depth == 0))) {
+      string op = args.substr(start, p - start);
+      op.erase(0, op.find_first_not_of(' '));
+      op.erase(op.find_last_not_of(' ') + 1);
+      if (op != "") mi.ops.push_back(op);
+      start = p + 1;
+    }
+    else if (args[p] == '(') depth++;
+    else if (args[p] == ')') depth--;
+  }
+
+  _code.push_back(mi);
+}
+
+void CBackendx86::EmitLabel(string label)
+{
+  CMachInstr mi;
+  mi.label = label;
+  _code.push_back(mi);
+}
+
+void CBackendx86::EmitLine(string text)
+{
+  CMachInstr mi;
+  mi.comment = text;
+  _code.push_back(mi);
+}
+
+void CBackendx86::EmitMachineCode(void)
+{
+  for (const auto &mi : _code) {
+    if (mi.label != "")
+      _out << mi.label << ":" << endl;
+    else if (mi.mnemonic == "")
+      _out << mi.comment << endl;
+    else {
+      string args;
+      for (size_t i = 0; i < mi.ops.size(); i++)
+        args += (i > 0 ? ", " : "") + mi.ops[i];
+
+      _out << left
+           << _ind
+           << setw(7) << mi.mnemonic << " "
+           << setw(23) << args;
+      if (mi.comment != "") _out << " # " << mi.comment;
+      _out << endl;
+    }
+  }
+
+  _code.clear();
+}
+
+void CBackendx86::EmitMulConst(int c)
+{
+  // |c| = m * 2^k with m in {1, 3, 5, 9}; m is computed by lea
+  unsigned int a = c < 0 ? -(unsigned int)c : c;
+  int k = 0;
+
+  if (a == 0) {
+    EmitInstruction("xorl", "%eax, %eax");
+    return;
+  }
+
+  while ((a & 1) == 0) { a >>= 1; k++; }
+
+  if ((a != 1) && (a != 3) && (a != 5) && (a != 9)) {
+    EmitInstruction("imull", Imm(c) + ", %eax, %eax");
+    return;
+  }
+
+  if (a > 1) {
+    EmitInstruction("leal", "(%eax,%eax," + to_string(a-1) + "), %eax");
+  }
+  if (k > 0) EmitInstruction("shll", Imm(k) + ", %eax");
+  if (c < 0) EmitInstruction("negl", "%eax");
+}
+
+void CBackendx86::EmitDivConst(int d, bool nonneg)
+{
+  if (nonneg) {
+    EmitUDivConst((unsigned int)d);
+    return;
+  }
+
+  unsigned int ad = d < 0 ? -(unsigned int)d : d;
+
+  // 0 and -1 may trap; leave them to idiv
+  if ((d == 0) || (d == -1)) {
+    EmitInstruction("movl", Imm(d) + ", %ebx");
+    EmitInstruction("cdq");
+    EmitInstruction("idivl", "%ebx");
+    return;
+  }
+
+  if (d == 1) return;
+
+  if ((ad & (ad - 1)) == 0) {
+    // power of two: add 2^k-1 to negative dividends to round towards zero
+    int k = 0;
+    while ((1u << k) != ad) k++;
+
+    if (k > 1) {
+      EmitInstruction("movl", "%eax, %edx");
+      EmitInstruction("sarl", Imm(31) + ", %edx");
+      EmitInstruction("shrl", Imm(32-k) + ", %edx");
+    } else {
+      EmitInstruction("movl", "%eax, %edx");
+      EmitInstruction("shrl", Imm(31) + ", %edx");
+    }
+    EmitInstruction("addl", "%edx, %eax");
+    EmitInstruction("sarl", Imm(k) + ", %eax");
+    if (d < 0) EmitInstruction("negl", "%eax");
+    return;
+  }
+
+  // magic number M and shift s such that n/d = hi32(M*n) >> s (corrected)
+  const unsigned int two31 = 0x80000000u;
+  unsigned int t = two31 + ((unsigned int)d >> 31);
+  unsigned int anc = t - 1 - t % ad;
+  unsigned int q1 = two31 / anc, r1 = two31 - q1 * anc;
+  unsigned int q2 = two31 / ad, r2 = two31 - q2 * ad;
+  unsigned int delta;
+  int p = 31;
+
+  do {
+    p++;
+    q1 *= 2; r1 *= 2;
+    if (r1 >= anc) { q1++; r1 -= anc; }
+    q2 *= 2; r2 *= 2;
+    if (r2 >= ad) { q2++; r2 -= ad; }
+    delta = ad - r2;
+  } while ((q1 < delta) || ((q1 == delta) && (r1 == 0)));
+
+  int m = (int)(q2 + 1);
+  if (d < 0) m = -m;
+  int shift = p - 32;
+
+  bool fixup = ((d > 0) && (m < 0)) || ((d < 0) && (m > 0));
+
+  if (fixup) EmitInstruction("movl", "%eax, %ecx");
+  EmitInstruction("movl", Imm(m) + ", %edx");
+  EmitInstruction("imull", "%edx");
+  if (fixup) EmitInstruction(d > 0 ? "addl" : "subl", "%ecx, %edx");
+  if (shift > 0) EmitInstruction("sarl", Imm(shift) + ", %edx");
+  EmitInstruction("movl", "%edx, %eax");
+  EmitInstruction("shrl", Imm(31) + ", %eax");
+  EmitInstruction("addl", "%edx, %eax");
+}
+
+void CBackendx86::EmitUDivConst(unsigned int d)
+{
+  // 0 traps; leave it to divl
+  if (d == 0) {
+    EmitInstruction("movl", Imm(0) + ", %ebx");
+    EmitInstruction("xorl", "%edx, %edx");
+    EmitInstruction("divl", "%ebx");
+    return;
+  }
+
+  if (d == 1) return;
+
+  if ((d & (d - 1)) == 0) {
+    int k = 0;
+    while ((1u << k) != d) k++;
+    EmitInstruction("shrl", Imm(k) + ", %eax");
+    return;
+  }
+
+  // the quotient is 0 or 1 for divisors of 2^31 and more: 1 - borrow(n - d)
+  if (d >= 0x80000000u) {
+    EmitInstruction("cmpl", Imm((int)d) + ", %eax");
+    EmitInstruction("sbbl", "%eax, %eax");
+    EmitInstruction("incl", "%eax");
+    return;
+  }
+
+  // magic number M and shift s such that n/d = hi32(M*n) >> s; if M does
+  // not fit into 32 bits, the 33rd bit is added back (Hacker's Delight, 10-8)
+  unsigned int nc = 0xffffffffu - (0u - d) % d;
+  unsigned int q1 = 0x80000000u / nc, r1 = 0x80000000u - q1 * nc;
+  unsigned int q2 = 0x7fffffffu / d, r2 = 0x7fffffffu - q2 * d;
+  unsigned int delta;
+  bool add = false;
+  int p = 31;
+
+  do {
+    p++;
+    if (r1 >= nc - r1) { q1 = 2 * q1 + 1; r1 = 2 * r1 - nc; }
+    else { q1 = 2 * q1; r1 = 2 * r1; }
+    if (r2 + 1 >= d - r2) {
+      if (q2 >= 0x7fffffffu) add = true;
+      q2 = 2 * q2 + 1; r2 = 2 * r2 + 1 - d;
+    } else {
+      if (q2 >= 0x80000000u) add = true;
+      q2 = 2 * q2; r2 = 2 * r2 + 1;
+    }
+    delta = d - 1 - r2;
+  } while ((p < 64) && ((q1 < delta) || ((q1 == delta) && (r1 == 0))));
+
+  int shift = p - 32;
+
+  if (add) EmitInstruction("movl", "%eax, %ecx");
+  EmitInstruction("movl", Imm((int)(q2 + 1)) + ", %edx");
+  EmitInstruction("mull", "%edx");
+  if (add) {
+    EmitInstruction("subl", "%edx, %ecx");
+    EmitInstruction("shrl", Imm(1) + ", %ecx");
+    EmitInstruction("addl", "%ecx, %edx");
+    shift--;
+  }
+  if (shift > 0) EmitInstruction("shrl", Imm(shift) + ", %edx");
+  EmitInstruction("movl", "%edx, %eax");
 }
 
 void CBackendx86::Load(CTacAddr *src, string dst, string comment)
@@ -549,12 +1255,13 @@ void CBackendx86::Load(CTacAddr *src, string dst, string comment)
   }
 
   // emit the load instruction
-  EmitInstruction(mnm + mod, Operand(src) + ", " + dst, comment);
+  EmitInstruction(mnm + mod, Operand(src, dst) + ", " + dst, comment);
 }
 
 void CBackendx86::Store(CTac *dst, char src_base, string comment)
 {
   assert(dst != NULL);
+  assert(src_base != 'b');
 
   string mnm = "mov";
   string mod = "l";
@@ -568,10 +1275,10 @@ void CBackendx86::Store(CTac *dst, char src_base, string comment)
   }
 
   // emit the store instruction
-  EmitInstruction(mnm + mod, src + ", " + Operand(dst), comment);
+  EmitInstruction(mnm + mod, src + ", " + Operand(dst, "%ebx"), comment);
 }
 
-string CBackendx86::Operand(const CTac *op)
+string CBackendx86::Operand(const CTac *op, string scratch)
 {
   string operand;
 
@@ -583,8 +1290,12 @@ string CBackendx86::Operand(const CTac *op)
   const CTacReference *opRef = dynamic_cast<const CTacReference*>(op);
   if (opRef) {
     const CSymbol *sym = opRef->GetSymbol();
-    EmitInstruction("movl", to_string(sym->GetOffset()) + "(" + sym->GetBaseRegister() + "), %edi");
-    operand = "(%edi)";
+    string reg = Register(sym);
+    if (reg == "") {
+      EmitInstruction("movl", to_string(sym->GetOffset()) + "(" + sym->GetBaseRegister() + "), " + scratch);
+      reg = scratch;
+    }
+    operand = "(" + reg + ")";
 
     return operand;
   }
@@ -596,6 +1307,8 @@ string CBackendx86::Operand(const CTac *op)
     ESymbolType symbolType = sym->GetSymbolType();
     if (symbolType == stGlobal || symbolType == stProcedure)
       operand = sym->GetName();
+    else if (Register(sym) != "")
+      operand = Register(sym);
     else {
       operand = to_string(sym->GetOffset()) + "(" + sym->GetBaseRegister() + ")";
     }
@@ -700,16 +1413,20 @@ size_t CBackendx86::ComputeStackOffsets(CSymtab *symtab,
 
   size_t size = 0;
 
-  /* foreach local symbol l in slist do
+  /* foreach local symbol and register argument l in slist do
    *   compute aligned offset on stack and store in symbol l
    *   set base register to %ebp
+   * arguments passed in registers are stored as 4-byte words
    */
   for (const auto &l : slist) {
-    if (l->GetSymbolType() != stLocal)
+    bool regarg = (l->GetSymbolType() == stParam) &&
+                  (dynamic_cast<CSymParam*>(l)->GetIndex() < nfastregs);
+    if (((l->GetSymbolType() != stLocal) && !regarg) || (Register(l) != "") ||
+        (_fold.count(l) > 0))
       continue;
 
     const CType* datatype = l->GetDataType();
-    if (datatype->IsInt() || datatype->IsPointer()) {
+    if (datatype->IsInt() || datatype->IsPointer() || regarg) {
       if (local_ofs % 4) {
         int padding = 4 + local_ofs % 4; /* local_ofs < 0 */
         size += padding;
@@ -750,9 +1467,13 @@ size_t CBackendx86::ComputeStackOffsets(CSymtab *symtab,
       continue;
 
     /* parameter doesn't require alignment rule.
-     * its offset is always (start_param_ofs + 4 * index)
+     * its offset is always (start_param_ofs + 4 * index) counting the
+     * arguments on the stack only
      */
-    int offset = param_ofs + 4 * dynamic_cast<CSymParam*>(p)->GetIndex();
+    int index = dynamic_cast<CSymParam*>(p)->GetIndex();
+    if (index < nfastregs) continue;
+
+    int offset = param_ofs + 4 * (index - nfastregs);
     p->SetOffset(offset);
     p->SetBaseRegister("%ebp");
   }
@@ -764,15 +1485,2505 @@ size_t CBackendx86::ComputeStackOffsets(CSymtab *symtab,
     local_ofs += -padding;
   }
 
-  /* dump stack frame to assembly file */
+  return size;
+}
+
+void CBackendx86::FindUninitialized(CScope *scope,
+                                    set<const CSymbol*> &uninit) const
+{
+  assert(scope != NULL);
+
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  vector<CTacInstr*> instr(il.begin(), il.end());
+  size_t n = instr.size();
+
+  /* candidates: scalar locals and temporaries on the stack */
+  map<const CSymbol*, size_t> idx;
+  vector<CSymbol*> slist = scope->GetSymbolTable()->GetSymbols();
+  for (const auto &s : slist)
+    if ((s->GetSymbolType() == stLocal) && IsScalarVar(s) &&
+        (Register(s) == "") && (_fold.count(s) == 0)) {
+      size_t k = idx.size();
+      idx[s] = k;
+    }
+  size_t m = idx.size();
+
+  /* successors */
+  map<const CTac*, size_t> label;
+  for (size_t p = 0; p < n; p++)
+    if (instr[p]->GetOperation() == opLabel) label[instr[p]] = p;
+
+  vector<vector<size_t> > succ(n);
+  for (size_t p = 0; p < n; p++) {
+    EOperation op = instr[p]->GetOperation();
+    if (instr[p]->IsBranch()) succ[p].push_back(label[instr[p]->GetDest()]);
+    if ((op != opGoto) && (op != opReturn) && (p + 1 < n))
+      succ[p].push_back(p + 1);
+  }
+
+  /* definite assignment: assigned[p] is the set of candidates written on
+   * every path from the entry to p
+   */
+  vector<vector<bool> > assigned(n, vector<bool>(m, true));
+  if (n > 0) assigned[0].assign(m, false);
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t p = 0; p < n; p++) {
+      vector<bool> out = assigned[p];
+      const CSymbol *d = GetDefinedSymbol(instr[p]);
+      if ((d != NULL) && (idx.count(d) > 0)) out[idx[d]] = true;
+
+      for (const auto &q : succ[p])
+        for (size_t k = 0; k < m; k++)
+          if (assigned[q][k] && !out[k] && (q != 0)) {
+            assigned[q][k] = false;
+            changed = true;
+          }
+    }
+  }
+
+  for (size_t p = 0; p < n; p++) {
+    vector<const CSymbol*> used;
+    GetUsedSymbols(instr[p], used);
+    for (const auto &u : used)
+      if ((idx.count(u) > 0) && !assigned[p][idx[u]]) uninit.insert(u);
+  }
+
+  /* local arrays are read as a whole: by loads through a reference or by
+   * passing their address to a procedure other than DIM
+   */
+  map<const CSymbol*, const CSymbol*> addr;
+  for (const auto &i : instr) {
+    EOperation op = i->GetOperation();
+    const CTacName *src = dynamic_cast<const CTacName*>(i->GetSrc(1));
+    const CSymbol *d = GetDefinedSymbol(i);
+
+    if ((op == opAddress) && (src != NULL) && (d != NULL) &&
+        src->GetSymbol()->GetDataType()->IsArray())
+      addr[d] = src->GetSymbol();
+    else if ((d != NULL) && (src != NULL) && (addr.count(src->GetSymbol()) > 0))
+      addr[d] = addr[src->GetSymbol()];
+
+    for (int k = 1; k <= 2; k++) {
+      const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetSrc(k));
+      if ((r != NULL) && (op != opAddress)) uninit.insert(r->GetDerefSymbol());
+    }
+  }
+
+  for (list<CTacInstr*>::const_iterator it = il.begin(); it != il.end(); it++) {
+    vector<CTacInstr*> params;
+    if (((*it)->GetOperation() != opCall) ||
+        (GetCallee(*it)->IsExternal() && (GetCallee(*it)->GetName() == "DIM")) ||
+        !GetParams(il.begin(), it, params))
+      continue;
+
+    for (const auto &q : params) {
+      const CTacName *a = dynamic_cast<const CTacName*>(q->GetSrc(1));
+      if ((a != NULL) && (addr.count(a->GetSymbol()) > 0))
+        uninit.insert(addr[a->GetSymbol()]);
+    }
+  }
+}
+
+void CBackendx86::ZeroLocals(CSymtab *symtab, size_t size,
+                             const set<const CSymbol*> &uninit, bool rep)
+{
+  assert(symtab != NULL);
+
+  /* the 4-byte words of the local area to clear; the stack pointer is
+   * 12 + size bytes below the frame pointer (see ComputeStackOffsets)
+   */
+  vector<bool> word(size / 4, false);
+  vector<CSymbol*> slist = symtab->GetSymbols();
+
   for (const auto &s : slist) {
-    ESymbolType stype = s->GetSymbolType();
-    if (stype != stLocal && stype != stParam)
+    if ((uninit.count(s) == 0) || (s->GetSymbolType() != stLocal) ||
+        (s->GetBaseRegister() != "%ebp"))
       continue;
 
-    _out << _ind << "#" << setw(7) << std::right << s->GetOffset() << "(" << s->GetBaseRegister() << ")"
-         << setw(4) << std::right << s->GetDataType()->GetSize() << setw(2) << s << endl;
+    const CType *t = s->GetDataType();
+    int lo = s->GetOffset() + 12 + size;
+    int hi = lo + t->GetSize();
+
+    // EmitLocalData() initializes the header of arrays
+    if (t->IsArray()) lo += 4 + 4 * dynamic_cast<const CArrayType*>(t)->GetNDim();
+
+    for (int w = lo / 4; w * 4 < hi; w++) word[w] = true;
   }
 
-  return size;
+  /* runs of 20 bytes and more are cleared by rep stosl */
+  string cmt = "memset local stack area to 0";
+  bool cld = false;
+
+  for (size_t w = 0; w < word.size(); ) {
+    if (!word[w]) { w++; continue; }
+
+    size_t e = w;
+    while ((e < word.size()) && word[e]) e++;
+
+    if (cmt != "") {
+      EmitLine();
+      EmitInstruction("xorl", "%eax, %eax", cmt);
+      cmt = "";
+    }
+
+    if (rep && (e - w >= 5)) {
+      if (!cld) EmitInstruction("cld");
+      cld = true;
+      EmitInstruction("movl", Imm(e - w) + ", %ecx");
+      EmitInstruction("leal", to_string(4 * w) + "(%esp), %edi");
+      EmitInstruction("rep", "stosl");
+    }
+    else
+      for (size_t v = e; v-- > w; )
+        EmitInstruction("movl", "%eax, " + to_string(4 * v) + "(%esp)");
+
+    w = e;
+  }
+}
+
+void CBackendx86::EmitRegisterArgs(CSymtab *symtab,
+                                   const vector<const CSymbol*> &init)
+{
+  assert(symtab != NULL);
+
+  /* arguments without a register variable are stored in their stack slot;
+   * the others are moved to their register if they are live at the entry.
+   * The moves form a parallel assignment from %ecx and %edx
+   */
+  vector<pair<string, string> > moves;
+  vector<string> cmts;
+  vector<CSymbol*> slist = symtab->GetSymbols();
+  bool first = true;
+
+  for (const auto &s : slist) {
+    if (s->GetSymbolType() != stParam) continue;
+
+    int index = dynamic_cast<CSymParam*>(s)->GetIndex();
+    if (index >= nfastregs) continue;
+
+    string cmt = "parameter '" + s->GetName() + "'";
+    string reg = Register(s);
+
+    if (reg == "") {
+      string slot = to_string(s->GetOffset()) + "(" + s->GetBaseRegister() + ")";
+      if (first) EmitLine();
+      first = false;
+      EmitInstruction("movl", string(fastregs[index]) + ", " + slot, cmt);
+    }
+    else if ((reg != fastregs[index]) &&
+             (find(init.begin(), init.end(), s) != init.end())) {
+      moves.push_back(make_pair(string(fastregs[index]), reg));
+      cmts.push_back(cmt);
+    }
+  }
+
+  if (first && !moves.empty()) EmitLine();
+
+  // the first move must not overwrite the source of the second one
+  if ((moves.size() == 2) && (moves[0].second == moves[1].first)) {
+    if (moves[1].second == moves[0].first) {
+      EmitInstruction("xchgl", moves[0].first + ", " + moves[1].first,
+                      cmts[0] + ", " + cmts[1]);
+      return;
+    }
+    swap(moves[0], moves[1]);
+    swap(cmts[0], cmts[1]);
+  }
+
+  for (size_t k = 0; k < moves.size(); k++)
+    EmitInstruction("movl", moves[k].first + ", " + moves[k].second, cmts[k]);
+}
+
+void CBackendx86::AdjustFrame(CSymtab *symtab, vector<CMachInstr> &code,
+                              int nsaved, bool frame)
+{
+  assert(symtab != NULL);
+
+  // locals move up by the registers not saved; without a frame, the
+  // parameters are found above the saved registers and the return address
+  int local_delta = 4 * (3 - nsaved);
+  int param_delta = 4 * nsaved - 4;
+
+  vector<CSymbol*> slist = symtab->GetSymbols();
+  for (const auto &s : slist) {
+    ESymbolType stype = s->GetSymbolType();
+    if (((stype != stLocal) && (stype != stParam)) ||
+        (s->GetBaseRegister() != "%ebp"))
+      continue;
+
+    if (!frame) {
+      s->SetOffset(s->GetOffset() + param_delta);
+      s->SetBaseRegister("%esp");
+    }
+    else if (s->GetOffset() < 0)
+      s->SetOffset(s->GetOffset() + local_delta);
+  }
+
+  // rewrite the operands disp(%ebp...) accordingly
+  for (auto &mi : code) {
+    for (auto &op : mi.ops) {
+      size_t p = op.find("(%ebp");
+      if (p == string::npos) continue;
+
+      int disp = p > 0 ? atoi(op.substr(0, p).c_str()) : 0;
+      string base = "(%ebp";
+
+      if (!frame) {
+        disp += param_delta;
+        base = "(%esp";
+      }
+      else if (disp < 0)
+        disp += local_delta;
+
+      op = to_string(disp) + base + op.substr(p + 5);
+    }
+  }
+}
+
+void CBackendx86::EmitStackOffsets(CSymtab *symtab)
+{
+  assert(symtab != NULL);
+  vector<CSymbol*> slist = symtab->GetSymbols();
+
+  /* dump stack frame to assembly file */
+  for (const auto &s : slist) {
+    ESymbolType stype = s->GetSymbolType();
+    if ((stype != stLocal && stype != stParam) || (_fold.count(s) > 0))
+      continue;
+
+    ostringstream o;
+    if (Register(s) != "")
+      o << _ind << "#" << setw(13) << std::right << Register(s);
+    else
+      o << _ind << "#" << setw(7) << std::right << s->GetOffset() << "(" << s->GetBaseRegister() << ")";
+    o << setw(4) << std::right << s->GetDataType()->GetSize() << setw(2) << s;
+    EmitLine(o.str());
+  }
+}
+
+string CBackendx86::Register(const CSymbol *sym) const
+{
+  map<const CSymbol*, string>::const_iterator it = _reg.find(sym);
+
+  return it != _reg.end() ? it->second : "";
+}
+
+void CBackendx86::AllocateRegisters(CScope *scope, vector<const CSymbol*> &init)
+{
+  assert(scope != NULL);
+
+  _reg.clear();
+  init.clear();
+  if (_level < 1) return;
+
+  CLiveness l;
+  ComputeLiveness(scope, l);
+  if (l.instr.empty() || l.cand.empty()) return;
+
+  vector<int> reg;
+  if (_level >= 2) ColorGraph(l, reg);
+  else LinearScan(l, reg);
+
+  for (size_t k = 0; k < l.cand.size(); k++) {
+    if (reg[k] < 0) continue;
+    _reg[l.cand[k]] = regs[reg[k]];
+    if (l.live[0][k]) init.push_back(l.cand[k]);
+  }
+}
+
+void CBackendx86::ComputeLiveness(CScope *scope, CLiveness &l) const
+{
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  l.instr.assign(il.begin(), il.end());
+  size_t n = l.instr.size();
+
+  /* candidates: 4-byte scalar locals, temporaries and parameters whose
+   * address is never taken
+   */
+  set<const CSymbol*> addressed;
+  for (const auto &i : l.instr) {
+    const CTacName *src = dynamic_cast<const CTacName*>(i->GetSrc(1));
+    if ((i->GetOperation() == opAddress) && (src != NULL) &&
+        (dynamic_cast<const CTacReference*>(src) == NULL))
+      addressed.insert(src->GetSymbol());
+  }
+
+  vector<CSymbol*> slist = scope->GetSymbolTable()->GetSymbols();
+  for (const auto &s : slist) {
+    ESymbolType stype = s->GetSymbolType();
+    const CType *t = s->GetDataType();
+
+    if ((stype != stLocal) && (stype != stParam)) continue;
+    if ((!t->IsInt() && !t->IsPointer()) || (addressed.count(s) > 0)) continue;
+    if (_fold.count(s) > 0) continue;
+
+    l.idx[s] = l.cand.size();
+    l.cand.push_back(s);
+  }
+  size_t m = l.cand.size();
+
+  /* uses, definitions, successors, loop depth and clobbers per instruction
+   * instructions folded into a tree are evaluated with the tree's root
+   */
+  map<const CTac*, size_t> label;
+  for (size_t p = 0; p < n; p++)
+    if (l.instr[p]->GetOperation() == opLabel) label[l.instr[p]] = p;
+
+  l.use.assign(n, vector<int>());
+  l.def.assign(n, -1);
+  l.succ.assign(n, vector<size_t>());
+  l.clobber.assign(n, false);
+  l.callee.assign(m, false);
+  vector<int> depth(n, 0);
+
+  for (size_t p = 0; p < n; p++) {
+    const CTacInstr *i = l.instr[p];
+    EOperation op = i->GetOperation();
+
+    if (_skip.count(i) == 0) {
+      vector<const CSymbol*> used;
+      int ninner = 0;
+      bool memory = false, division = false;
+      const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetDest());
+
+      map<const CTacInstr*, CNode*>::const_iterator t = _tree.find(i);
+      if (t != _tree.end()) {
+        GetTreeOperands(t->second, used, ninner, memory, division);
+        if (r != NULL) used.push_back(r->GetSymbol());
+      }
+      else if (_regparams.count(i) == 0)
+        GetUsedSymbols(i, used);
+
+      // the register arguments loaded at a call are read by the call
+      map<const CTacInstr*, vector<const CTacInstr*> >::const_iterator ra = _regargs.find(i);
+      if (ra != _regargs.end())
+        for (const auto &q : ra->second)
+          if (q != NULL) GetUsedSymbols(q, used);
+
+      // operands read after a division inside the tree must survive it
+      bool survive = division && ((ninner >= 2) || (r != NULL));
+      for (const auto &u : used) {
+        if (l.idx.count(u) == 0) continue;
+        int k = l.idx.find(u)->second;
+        l.use[p].push_back(k);
+        if (survive) l.callee[k] = true;
+      }
+
+      const CSymbol *d = GetDefinedSymbol(i);
+      if ((d != NULL) && (l.idx.count(d) > 0)) l.def[p] = l.idx.find(d)->second;
+
+      l.clobber[p] = ((op == opCall) && (_dim.count(l.instr[p]) == 0)) || division;
+    }
+
+    if (i->IsBranch()) {
+      size_t target = label[i->GetDest()];
+      l.succ[p].push_back(target);
+
+      // a backward branch closes a loop
+      if (target <= p)
+        for (size_t q = target; q <= p; q++) depth[q]++;
+    }
+    if ((op != opGoto) && (op != opReturn) && (p + 1 < n))
+      l.succ[p].push_back(p + 1);
+  }
+
+  /* liveness: live[p] is the set of candidates live at the entry of p */
+  l.live.assign(n, vector<bool>(m, false));
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t p = n; p-- > 0; ) {
+      vector<bool> in(m, false);
+      for (const auto &s : l.succ[p])
+        for (size_t k = 0; k < m; k++)
+          if (l.live[s][k]) in[k] = true;
+      if (l.def[p] >= 0) in[l.def[p]] = false;
+      for (const auto &u : l.use[p]) in[u] = true;
+
+      if (in != l.live[p]) {
+        l.live[p] = in;
+        changed = true;
+      }
+    }
+  }
+
+  /* spill weights: uses and definitions weighted by 10^loop depth */
+  l.weight.assign(m, 0.0);
+  for (size_t p = 0; p < n; p++) {
+    double w = 1.0;
+    for (int d = 0; d < depth[p]; d++) w *= 10.0;
+
+    if (l.def[p] >= 0) l.weight[l.def[p]] += w;
+    for (const auto &u : l.use[p]) l.weight[u] += w;
+  }
+}
+
+void CBackendx86::LinearScan(const CLiveness &l, vector<int> &reg) const
+{
+  size_t n = l.instr.size(), m = l.cand.size();
+
+  /* live intervals */
+  vector<size_t> start(m, n), end(m, 0);
+
+  for (size_t p = 0; p < n; p++) {
+    for (size_t k = 0; k < m; k++) {
+      if (l.live[p][k] || (l.def[p] == (int)k)) {
+        if (p < start[k]) start[k] = p;
+        if (p > end[k]) end[k] = p;
+      }
+    }
+  }
+
+  vector<bool> crosses(l.callee);
+  vector<vector<int> > starts(n);
+  for (size_t k = 0; k < m; k++) {
+    if (start[k] == n) continue;
+    for (size_t p = start[k]; p < end[k]; p++)
+      if (l.clobber[p] && ((p > start[k]) || (l.def[p] != (int)k)))
+        crosses[k] = true;
+    starts[start[k]].push_back(k);
+  }
+
+  /* linear scan over the intervals in order of their start */
+  vector<int> owner(nregs, -1);
+  reg.assign(m, -1);
+
+  for (size_t p = 0; p < n; p++) {
+    // expire intervals that end before p
+    for (int r = 0; r < nregs; r++)
+      if ((owner[r] >= 0) && (end[owner[r]] < p)) owner[r] = -1;
+
+    for (const auto &k : starts[p]) {
+      // an interval whose last use is at p may share its register with a
+      // definition at p, but not with the other intervals live at p
+      vector<bool> free(nregs, false);
+      for (int r = 0; r < nregs; r++) {
+        int o = owner[r];
+        free[r] = (o < 0) || ((end[o] == p) && !l.live[p][k]);
+      }
+
+      // arguments preferably stay in the register they arrive in
+      int first = crosses[k] ? nregs - ncallee : 0;
+      int a = ArgRegister(l.cand[k]);
+      int r = (a >= first) && free[a] ? a : -1;
+      for (int j = first; (j < nregs) && (r < 0); j++)
+        if (free[j]) r = j;
+
+      // no free register: spill the cheapest of k and the intervals
+      // occupying a register k may use
+      if (r < 0) {
+        for (int j = first; j < nregs; j++)
+          if ((r < 0) || (l.weight[owner[j]] < l.weight[owner[r]])) r = j;
+        if (l.weight[owner[r]] >= l.weight[k]) continue;
+        reg[owner[r]] = -1;
+      }
+
+      owner[r] = k;
+      reg[k] = r;
+    }
+  }
+}
+
+void CBackendx86::ColorGraph(const CLiveness &l, vector<int> &reg) const
+{
+  size_t n = l.instr.size(), m = l.cand.size();
+
+  /* interference graph
+   * a definition interferes with everything live after it except for the
+   * source of a move; candidates live across a clobber are restricted to
+   * the callee-saved registers
+   */
+  vector<set<int> > adj(m);
+  vector<bool> callee(l.callee);
+  vector<pair<int, int> > moves;
+
+  for (size_t p = 0; p < n; p++) {
+    vector<bool> out(m, false);
+    for (const auto &s : l.succ[p])
+      for (size_t k = 0; k < m; k++)
+        if (l.live[s][k]) out[k] = true;
+
+    int d = l.def[p], src = -1;
+    if ((l.instr[p]->GetOperation() == opAssign) && (d >= 0)) {
+      const CTacName *n = dynamic_cast<const CTacName*>(l.instr[p]->GetSrc(1));
+      if ((n != NULL) && (dynamic_cast<const CTacReference*>(n) == NULL) &&
+          (l.idx.count(n->GetSymbol()) > 0)) {
+        src = l.idx.find(n->GetSymbol())->second;
+        moves.push_back(make_pair(d, src));
+      }
+    }
+
+    for (size_t k = 0; k < m; k++) {
+      if (!out[k] || ((int)k == d)) continue;
+      if ((d >= 0) && ((int)k != src)) {
+        adj[d].insert(k);
+        adj[k].insert(d);
+      }
+      if (l.clobber[p]) callee[k] = true;
+    }
+  }
+
+  // the candidates live at the entry are initialized together
+  for (size_t a = 0; a < m; a++)
+    for (size_t b = a + 1; b < m; b++)
+      if (l.live[0][a] && l.live[0][b]) {
+        adj[a].insert(b);
+        adj[b].insert(a);
+      }
+
+  vector<set<int> > adj0(adj);
+  vector<bool> callee0(callee);
+
+  /* coalesce move-related candidates if the merged node has fewer
+   * neighbors of significant degree than it has registers (Briggs) or if
+   * every neighbor of one of them of significant degree already interferes
+   * with the other (George)
+   */
+  vector<int> alias(m);
+  vector<double> cost(l.weight);
+  for (size_t k = 0; k < m; k++) alias[k] = k;
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto &mv : moves) {
+      int a = mv.first, b = mv.second;
+      while (alias[a] != a) a = alias[a];
+      while (alias[b] != b) b = alias[b];
+      if ((a == b) || (adj[a].count(b) > 0)) continue;
+
+      bool c = callee[a] || callee[b];
+      set<int> nb(adj[a]);
+      nb.insert(adj[b].begin(), adj[b].end());
+
+      int significant = 0;
+      for (const auto &x : nb) {
+        int degree = adj[x].size();
+        if ((adj[x].count(a) > 0) && (adj[x].count(b) > 0)) degree--;
+        if (degree >= (callee[x] ? ncallee : nregs)) significant++;
+      }
+
+      // George: every neighbor of y of significant degree interferes with x
+      // already, and y does not restrict the registers of x
+      bool george = false;
+      for (int t = 0; (t < 2) && !george; t++) {
+        int x = t == 0 ? a : b, y = t == 0 ? b : a;
+        george = callee[x] || !callee[y];
+        for (const auto &z : adj[y])
+          if ((adj[x].count(z) == 0) &&
+              ((int)adj[z].size() >= (callee[z] ? ncallee : nregs)))
+            george = false;
+      }
+
+      if ((significant >= (c ? ncallee : nregs)) && !george) continue;
+
+      for (const auto &x : adj[b]) {
+        adj[x].erase(b);
+        adj[x].insert(a);
+        adj[a].insert(x);
+      }
+      adj[b].clear();
+      alias[b] = a;
+      callee[a] = c;
+      cost[a] += cost[b];
+      changed = true;
+    }
+  }
+
+  /* simplify: remove nodes of insignificant degree; if there are none,
+   * optimistically push the node with the lowest cost per degree
+   */
+  vector<int> degree(m, 0), stack;
+  vector<bool> removed(m, false);
+  size_t left = 0;
+  for (size_t k = 0; k < m; k++) {
+    if (alias[k] != (int)k) { removed[k] = true; continue; }
+    degree[k] = adj[k].size();
+    left++;
+  }
+
+  while (left > 0) {
+    int pick = -1;
+    for (size_t k = 0; (k < m) && (pick < 0); k++)
+      if (!removed[k] && (degree[k] < (callee[k] ? ncallee : nregs))) pick = k;
+
+    if (pick < 0) {
+      for (size_t k = 0; k < m; k++) {
+        if (removed[k]) continue;
+        if ((pick < 0) || (cost[k] / degree[k] < cost[pick] / degree[pick])) pick = k;
+      }
+    }
+
+    stack.push_back(pick);
+    removed[pick] = true;
+    left--;
+    for (const auto &x : adj[pick]) degree[x]--;
+  }
+
+  /* select: color in reverse order; nodes without a free register stay in
+   * memory
+   */
+  vector<int> color(m, -1);
+  while (!stack.empty()) {
+    int k = stack.back();
+    stack.pop_back();
+
+    vector<bool> used(nregs, false);
+    for (const auto &x : adj[k])
+      if (color[x] >= 0) used[color[x]] = true;
+
+    int first = callee[k] ? nregs - ncallee : 0;
+    int a = ArgRegister(l.cand[k]);
+    if ((a >= first) && !used[a]) color[k] = a;
+    for (int j = first; (j < nregs) && (color[k] < 0); j++)
+      if (!used[j]) color[k] = j;
+  }
+
+  reg.assign(m, -1);
+  for (size_t k = 0; k < m; k++) {
+    int a = k;
+    while (alias[a] != a) a = alias[a];
+    reg[k] = color[a];
+  }
+
+  /* give spilled candidates a second chance on their own, most expensive
+   * first; this undoes the coalescing of nodes that did not get a register
+   */
+  vector<pair<double, int> > spilled;
+  for (size_t k = 0; k < m; k++)
+    if (reg[k] < 0) spilled.push_back(make_pair(-l.weight[k], k));
+  sort(spilled.begin(), spilled.end());
+
+  for (const auto &sp : spilled) {
+    int k = sp.second;
+
+    vector<bool> used(nregs, false);
+    for (const auto &x : adj0[k])
+      if (reg[x] >= 0) used[reg[x]] = true;
+
+    for (int j = callee0[k] ? nregs - ncallee : 0; (j < nregs) && (reg[k] < 0); j++)
+      if (!used[j]) reg[k] = j;
+  }
+}
+
+/// @brief returns true if @a op computes a value tiled by the selector
+static bool IsArithmetic(EOperation op)
+{
+  return (op == opAdd) || (op == opSub) || (op == opMul) || (op == opDiv) ||
+         (op == opUDiv) || (op == opNeg) || (op == opPos);
+}
+
+/// @brief returns true if @a a and @a b name the same scalar variable
+static bool SameVar(const CTac *a, const CTac *b)
+{
+  const CTacName *na = dynamic_cast<const CTacName*>(a);
+  const CTacName *nb = dynamic_cast<const CTacName*>(b);
+
+  if ((na == NULL) || (nb == NULL)) return false;
+  if ((dynamic_cast<const CTacReference*>(na) != NULL) ||
+      (dynamic_cast<const CTacReference*>(nb) != NULL)) return false;
+
+  return na->GetSymbol() == nb->GetSymbol();
+}
+
+/// @brief return the value of the constant leaf @a a
+static int ConstValue(const CTacAddr *a)
+{
+  const CTacConst *c = dynamic_cast<const CTacConst*>(a);
+  assert(c != NULL);
+
+  return c->GetValue();
+}
+
+void CBackendx86::ClearTrees(void)
+{
+  for (const auto &n : _nodes) delete n;
+
+  _nodes.clear();
+  _tree.clear();
+  _fold.clear();
+  _skip.clear();
+}
+
+CBackendx86::CNode* CBackendx86::NewNode(EOperation op, CTacAddr *leaf,
+                                         CNode *kid0, CNode *kid1)
+{
+  CNode *n = new CNode;
+
+  n->op = op;
+  n->leaf = leaf;
+  n->kid[0] = kid0;
+  n->kid[1] = kid1;
+  _nodes.push_back(n);
+
+  return n;
+}
+
+void CBackendx86::BuildTrees(CScope *scope)
+{
+  assert(scope != NULL);
+
+  ClearTrees();
+  if (_level < 1) return;
+
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  vector<CTacInstr*> instr(il.begin(), il.end());
+  size_t n = instr.size();
+
+  /* number and position of the definitions and uses of each variable */
+  map<const CSymbol*, int> ndef, nuse;
+  map<const CSymbol*, size_t> defpos, usepos;
+
+  for (size_t p = 0; p < n; p++) {
+    const CSymbol *d = GetDefinedSymbol(instr[p]);
+    if (d != NULL) {
+      ndef[d]++;
+      defpos[d] = p;
+    }
+
+    vector<const CSymbol*> used;
+    GetUsedSymbols(instr[p], used);
+    for (const auto &u : used) {
+      nuse[u]++;
+      usepos[u] = p;
+    }
+  }
+
+  /* build the trees in program order so that folded definitions already
+   * carry their own trees
+   */
+  for (size_t q = 0; q < n; q++) {
+    CTacInstr *i = instr[q];
+    EOperation op = i->GetOperation();
+    int nsrc;
+
+    // the arguments of inlined DIM calls and register arguments are read by
+    // the call
+    if ((_dimargs.count(i) > 0) || (_regparams.count(i) > 0)) continue;
+
+    if ((op == opNeg) || (op == opPos) || (op == opAssign) || (op == opParam))
+      nsrc = 1;
+    else if ((op == opReturn) && (i->GetSrc(1) != NULL))
+      nsrc = 1;
+    else if (IsArithmetic(op) || IsRelOp(op) || (op == opCheck))
+      nsrc = 2;
+    else
+      continue;
+
+    CNode *kid[2] = { NULL, NULL };
+    for (int j = 0; j < nsrc; j++) {
+      CTacAddr *a = i->GetSrc(j+1);
+
+      // keep trees linear: the second operand is only folded if the first
+      // one is a leaf
+      const CTacName *t = dynamic_cast<const CTacName*>(a);
+      bool fold = (t != NULL) && (dynamic_cast<const CTacReference*>(t) == NULL) &&
+                  ((j == 0) || (kid[0]->leaf != NULL));
+
+      const CSymbol *s = fold ? t->GetSymbol() : NULL;
+      fold = fold && (s->GetSymbolType() == stLocal) && IsScalarVar(s) &&
+             (ndef[s] == 1) && (nuse[s] == 1) && (usepos[s] == q) &&
+             (defpos[s] < q);
+
+      CTacInstr *d = fold ? instr[defpos[s]] : NULL;
+      map<const CTacInstr*, CNode*>::iterator it = fold ? _tree.find(d) : _tree.end();
+      fold = fold && (it != _tree.end()) &&
+             (IsArithmetic(d->GetOperation()) || (d->GetOperation() == opAssign));
+
+      if (fold) {
+        // the operands of the definition must be unchanged at the use
+        vector<const CSymbol*> leaves;
+        int ninner = 0;
+        bool memory = false, division = false;
+        GetTreeOperands(it->second, leaves, ninner, memory, division);
+
+        for (size_t p = defpos[s] + 1; fold && (p < q); p++) {
+          const CTacInstr *b = instr[p];
+          EOperation bop = b->GetOperation();
+          const CSymbol *bd = GetDefinedSymbol(b);
+
+          if ((bop == opLabel) || b->IsBranch() || (bop == opReturn) ||
+              (bop == opCall))
+            fold = false;
+          else if ((bop == opCheck) && division)
+            fold = false;
+          else if (memory && WritesMemory(b))
+            fold = false;
+          else if ((bd != NULL) && (find(leaves.begin(), leaves.end(), bd) != leaves.end()))
+            fold = false;
+        }
+      }
+
+      if (fold) {
+        kid[j] = it->second;
+        _skip.insert(d);
+        _fold[s] = it->second;
+      }
+      else
+        kid[j] = NewNode(opNop, a);
+    }
+
+    if (IsArithmetic(op) || IsRelOp(op) || (op == opCheck))
+      _tree[i] = NewNode(op, NULL, kid[0], kid[1]);
+    else
+      _tree[i] = kid[0];
+  }
+}
+
+void CBackendx86::GetTreeOperands(const CNode *n, vector<const CSymbol*> &syms,
+                                  int &ninner, bool &memory, bool &division) const
+{
+  if (n == NULL) return;
+
+  if (n->leaf != NULL) {
+    const CTacName *t = dynamic_cast<const CTacName*>(n->leaf);
+    const CTacReference *r = dynamic_cast<const CTacReference*>(n->leaf);
+
+    if (r != NULL) {
+      syms.push_back(r->GetSymbol());
+      memory = true;
+    }
+    else if ((t != NULL) && IsScalarVar(t->GetSymbol()))
+      syms.push_back(t->GetSymbol());
+    return;
+  }
+
+  ninner++;
+  if ((n->op == opDiv) || (n->op == opUDiv)) division = true;
+
+  GetTreeOperands(n->kid[0], syms, ninner, memory, division);
+  GetTreeOperands(n->kid[1], syms, ninner, memory, division);
+}
+
+bool CBackendx86::MatchLeaf(const CNode *n, int pattern) const
+{
+  const CTacConst *c = dynamic_cast<const CTacConst*>(n->leaf);
+  const CTacName *t = dynamic_cast<const CTacName*>(n->leaf);
+  const CTacReference *r = dynamic_cast<const CTacReference*>(n->leaf);
+
+  switch (pattern) {
+    case lfConst:
+      return c != NULL;
+
+    case lfScale:
+      return (c != NULL) &&
+             ((c->GetValue() == 1) || (c->GetValue() == 2) ||
+              (c->GetValue() == 4) || (c->GetValue() == 8));
+
+    case lfReg:
+      return (t != NULL) && (r == NULL) && (Register(t->GetSymbol()) != "");
+
+    case lfMem:
+      // references are only memory operands if the pointer is in a register
+      if ((t == NULL) || (OperandSize(n->leaf) != 4)) return false;
+      if (r != NULL) return Register(r->GetSymbol()) != "";
+      return Register(t->GetSymbol()) == "";
+
+    case lfAny:
+      return true;
+  }
+
+  return false;
+}
+
+void CBackendx86::MatchTree(CNode *n)
+{
+  assert(n != NULL);
+
+  for (int j = 0; j < 2; j++)
+    if (n->kid[j] != NULL) MatchTree(n->kid[j]);
+
+  for (int nt = 0; nt < ntCount; nt++) {
+    n->cost[nt] = INF;
+    n->rule[nt] = -1;
+  }
+
+  /* base rules: leaf patterns and operators */
+  for (int k = 0; k < nrules; k++) {
+    const SRule &r = rules[k];
+    int cost = r.cost;
+
+    if (r.op == opChain) continue;
+    if (r.op < 0) {
+      if ((n->leaf == NULL) || !MatchLeaf(n, r.op)) continue;
+    }
+    else {
+      if ((n->leaf != NULL) || (r.op != n->op)) continue;
+      if ((r.kid[1] < 0) != (n->kid[1] == NULL)) continue;
+
+      for (int j = 0; j < 2; j++)
+        if (r.kid[j] >= 0) cost += n->kid[j]->cost[r.kid[j]];
+    }
+
+    if (cost < n->cost[r.lhs]) {
+      n->cost[r.lhs] = cost;
+      n->rule[r.lhs] = k;
+    }
+  }
+
+  /* closure over the chain rules */
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    for (int k = 0; k < nrules; k++) {
+      const SRule &r = rules[k];
+      if (r.op != opChain) continue;
+
+      int cost = r.cost + n->cost[r.kid[0]];
+      if (cost < n->cost[r.lhs]) {
+        n->cost[r.lhs] = cost;
+        n->rule[r.lhs] = k;
+        changed = true;
+      }
+    }
+  }
+}
+
+string CBackendx86::ReduceTree(CNode *n, int nt)
+{
+  assert((n != NULL) && (n->rule[nt] >= 0));
+
+  const SRule &r = rules[n->rule[nt]];
+
+  switch (r.action) {
+    case aLeaf:
+      switch (nt) {
+        case ntImm:   return Imm(ConstValue(n->leaf));
+        case ntScale: return to_string(ConstValue(n->leaf));
+        case ntReg:   return Register(dynamic_cast<CTacName*>(n->leaf)->GetSymbol());
+        case ntMem:   return Operand(n->leaf, "");
+      }
+      return "";
+
+    case aChain:
+      return ReduceTree(n, r.kid[0]);
+
+    case aLoad:
+    {
+      string reg = nt == ntSrc ? "%ebx" : "%eax";
+      Load(n->leaf, reg);
+      return reg;
+    }
+
+    case aLea:
+    {
+      CAddress a = { "", "", 1, 0 };
+      ReduceAddress(n, ntAddr, a);
+      EmitInstruction("leal", Address(a) + ", %eax");
+      return "%eax";
+    }
+
+    case aBinary:
+    {
+      // the operand in %eax is computed first; the other one is a leaf
+      int acc = r.kid[0] == ntAcc ? 0 : 1;
+      CNode *o = n->kid[1-acc];
+      int ont = r.kid[1-acc];
+
+      ReduceTree(n->kid[acc], ntAcc);
+
+      if ((n->op == opDiv) || (n->op == opUDiv)) {
+        if (ont == ntImm) {
+          EmitDivConst(ConstValue(o->leaf), n->op == opUDiv);
+          return "%eax";
+        }
+
+        if (acc == 0) Load(o->leaf, "%ebx");
+        else {
+          EmitInstruction("movl", "%eax, %ebx");
+          Load(o->leaf, "%eax");
+        }
+        if (n->op == opDiv) {
+          EmitInstruction("cdq");
+          EmitInstruction("idivl", "%ebx");
+        }
+        else {
+          EmitInstruction("xorl", "%edx, %edx");
+          EmitInstruction("divl", "%ebx");
+        }
+        return "%eax";
+      }
+
+      if ((n->op == opMul) && (ont == ntImm)) {
+        EmitMulConst(ConstValue(o->leaf));
+        return "%eax";
+      }
+
+      string src = ReduceTree(o, ont);
+      if (n->op == opAdd)
+        EmitInstruction("addl", src + ", %eax");
+      else if (n->op == opMul)
+        EmitInstruction("imull", src + ", %eax");
+      else if (acc == 0)
+        EmitInstruction("subl", src + ", %eax");
+      else {
+        EmitInstruction("negl", "%eax");
+        EmitInstruction("addl", src + ", %eax");
+      }
+      return "%eax";
+    }
+
+    case aUnary:
+      ReduceTree(n->kid[0], ntAcc);
+      if (n->op == opNeg) EmitInstruction("negl", "%eax");
+      return "%eax";
+  }
+
+  assert(false);
+  return "";
+}
+
+void CBackendx86::ReduceAddress(CNode *n, int nt, CAddress &a)
+{
+  assert((n != NULL) && (n->rule[nt] >= 0));
+
+  const SRule &r = rules[n->rule[nt]];
+
+  /* index register, scaled by a multiplication */
+  if (r.op == opChain) {
+    assert(nt == ntIndex);
+    a.index = ReduceTree(n, ntReg);
+    a.scale = 1;
+    return;
+  }
+
+  if (r.op == opMul) {
+    int s = r.kid[0] == ntScale ? 0 : 1;
+    a.index = ReduceTree(n->kid[1-s], ntReg);
+    a.scale = ConstValue(n->kid[s]->leaf);
+    return;
+  }
+
+  /* base, index and displacement of a sum */
+  for (int j = 0; j < 2; j++) {
+    CNode *k = n->kid[j];
+
+    switch (r.kid[j]) {
+      case ntBase:
+        a.base = ReduceTree(k, ntBase);
+        break;
+
+      case ntIndex:
+      case ntAddr:
+        ReduceAddress(k, r.kid[j], a);
+        break;
+
+      case ntImm:
+      {
+        unsigned int v = ConstValue(k->leaf);
+        a.disp = (int)(n->op == opSub ? a.disp - v : a.disp + v);
+        break;
+      }
+    }
+  }
+}
+
+string CBackendx86::Address(const CAddress &a) const
+{
+  string s;
+
+  if ((a.disp != 0) || (a.base == "")) s = to_string(a.disp);
+  s += "(" + a.base;
+  if (a.index != "") s += "," + a.index + "," + to_string(a.scale);
+  s += ")";
+
+  return s;
+}
+
+void CBackendx86::SelectInstruction(CTacInstr *i)
+{
+  assert(i != NULL);
+
+  // folded into the tree of a later instruction
+  if (_skip.count(i) > 0) return;
+
+  ostringstream cmt;
+  cmt << i;
+  _cmt = cmt.str();
+
+  EOperation op = i->GetOperation();
+  map<const CTacInstr*, CNode*>::const_iterator it = _tree.find(i);
+
+  if (it == _tree.end()) {
+    const CTacName *dst = dynamic_cast<const CTacName*>(i->GetDest());
+    string reg;
+    if ((op == opAddress) && (dynamic_cast<const CTacReference*>(dst) == NULL))
+      reg = Register(dst->GetSymbol());
+
+    if (reg != "")
+      EmitInstruction("leal", Operand(i->GetSrc(1), "%eax") + ", " + reg);
+    else {
+      _cmt = "";
+      EmitInstruction(i);
+    }
+    _cmt = "";
+    return;
+  }
+
+  CNode *n = it->second;
+  MatchTree(n);
+
+  if (IsRelOp(op))
+    SelectCompare(op, n->kid[0], n->kid[1],
+                  Label(dynamic_cast<const CTacLabel*>(i->GetDest())));
+  else if (op == opCheck)
+    SelectCompare(op, n->kid[0], n->kid[1], "BoundsError");
+  else if (op == opParam) {
+    if ((n->leaf != NULL) && (OperandSize(n->leaf) == 4))
+      EmitInstruction("pushl", Operand(n->leaf, "%eax"));
+    else {
+      ReduceTree(n, ntAcc);
+      EmitInstruction("pushl", "%eax");
+    }
+  }
+  else if (op == opReturn) {
+    ReduceTree(n, ntAcc);
+    EmitInstruction("jmp", Label("exit"));
+  }
+  else
+    SelectAssign(i->GetDest(), n);
+
+  _cmt = "";
+}
+
+void CBackendx86::SelectAssign(CTac *dst, CNode *n)
+{
+  assert((dst != NULL) && (n != NULL));
+
+  const CTacName *d = dynamic_cast<const CTacName*>(dst);
+  string reg;
+  if ((d != NULL) && (dynamic_cast<const CTacReference*>(d) == NULL))
+    reg = Register(d->GetSymbol());
+
+  /* copies */
+  if (n->leaf != NULL) {
+    const CTacName *s = dynamic_cast<const CTacName*>(n->leaf);
+
+    if (reg != "") {
+      if ((s == NULL) || (dynamic_cast<const CTacReference*>(s) != NULL) ||
+          (Register(s->GetSymbol()) != reg))
+        Load(n->leaf, reg);
+      return;
+    }
+
+    if ((OperandSize(dst) == 4) && (n->cost[ntImm] == 0 || n->cost[ntReg] == 0)) {
+      string src = ReduceTree(n, n->cost[ntImm] == 0 ? ntImm : ntReg);
+      string opnd = Operand(dst, "%ebx");
+      EmitInstruction("movl", src + ", " + opnd);
+      return;
+    }
+  }
+
+  /* two-address forms updating the destination in place */
+  else if ((d != NULL) && (reg != "" || OperandSize(dst) == 4)) {
+    CNode *l = n->kid[0], *r = n->kid[1];
+
+    if ((r != NULL) && (l->leaf != NULL) && !SameVar(dst, l->leaf) &&
+        IsCommutative(n->op) && SameVar(dst, r->leaf))
+      swap(l, r);
+
+    if ((n->op == opNeg) && SameVar(dst, l->leaf)) {
+      EmitInstruction("negl", Operand(dst, "%ebx"));
+      return;
+    }
+
+    if ((r != NULL) && SameVar(dst, l->leaf)) {
+      string mnm;
+      if (n->op == opAdd) mnm = "addl";
+      else if (n->op == opSub) mnm = "subl";
+      else if ((n->op == opMul) && (reg != "")) mnm = "imull";
+
+      // register destinations take any source, memory ones no memory
+      int nt = -1;
+      if ((reg != "") && (r->cost[ntSrc] < INF)) nt = ntSrc;
+      else if (r->cost[ntImm] == 0) nt = ntImm;
+      else if (r->cost[ntReg] == 0) nt = ntReg;
+
+      if ((mnm != "") && (nt >= 0)) {
+        string src = ReduceTree(r, nt);
+        string opnd = Operand(dst, "%ebx");
+        EmitInstruction(mnm, src + ", " + opnd);
+        return;
+      }
+    }
+  }
+
+  /* address arithmetic straight into the destination register */
+  if ((reg != "") && (n->cost[ntAddr] + 1 <= n->cost[ntAcc])) {
+    CAddress a = { "", "", 1, 0 };
+    ReduceAddress(n, ntAddr, a);
+    EmitInstruction("leal", Address(a) + ", " + reg);
+    return;
+  }
+
+  ReduceTree(n, ntAcc);
+  if (reg != "") EmitInstruction("movl", "%eax, " + reg);
+  else Store(dst, 'a');
+}
+
+void CBackendx86::SelectCompare(EOperation op, CNode *l, CNode *r, string target)
+{
+  assert((l != NULL) && (r != NULL));
+
+  string cc = op == opCheck ? "ae" : Condition(op);
+
+  /* computed values and variables go left; the relation is mirrored */
+  if ((r->leaf == NULL) || ((l->leaf != NULL) && (l->cost[ntImm] == 0) &&
+                            (r->cost[ntImm] != 0))) {
+    swap(l, r);
+    if (op == opCheck) cc = "be";
+    else if (op == opLessThan) cc = Condition(opBiggerThan);
+    else if (op == opLessEqual) cc = Condition(opBiggerEqual);
+    else if (op == opBiggerThan) cc = Condition(opLessThan);
+    else if (op == opBiggerEqual) cc = Condition(opLessEqual);
+  }
+
+  bool zero = (op != opCheck) && (r->leaf != NULL) && (r->cost[ntImm] == 0) &&
+              (ConstValue(r->leaf) == 0);
+
+  if (zero) {
+    // compare against zero: test a register
+    string x = l->cost[ntReg] == 0 ? ReduceTree(l, ntReg) : ReduceTree(l, ntAcc);
+    EmitInstruction("testl", x + ", " + x);
+  }
+  else if ((l->cost[ntRM] == 0) && ((r->cost[ntReg] == 0) ||
+           ((r->cost[ntImm] == 0) && (l->cost[ntReg] == 0)))) {
+    // cmp mem, imm does not fuse with the jcc; such operands are loaded
+    string lhs = ReduceTree(l, ntRM);
+    string rhs = ReduceTree(r, r->cost[ntImm] == 0 ? ntImm : ntReg);
+    EmitInstruction("cmpl", rhs + ", " + lhs);
+  }
+  else if ((l->cost[ntReg] == 0) && (r->cost[ntMem] == 0)) {
+    string lhs = ReduceTree(l, ntReg);
+    string rhs = ReduceTree(r, ntMem);
+    EmitInstruction("cmpl", rhs + ", " + lhs);
+  }
+  else {
+    ReduceTree(l, ntAcc);
+    string rhs = ReduceTree(r, ntSrc);
+    EmitInstruction("cmpl", rhs + ", %eax");
+  }
+
+  EmitInstruction("j" + cc, target);
+}
+
+
+//------------------------------------------------------------------------------
+// peephole optimization
+//
+
+void CBackendx86::Peephole(void)
+{
+  bool changed = true;
+
+  while (changed) {
+    changed = false;
+
+    size_t k = 0;
+    while (k < _code.size()) {
+      CMachInstr &a = _code[k];
+      if (a.mnemonic == "") { k++; continue; }
+
+      // the next instruction and the line following it
+      size_t n = k + 1;
+      while ((n < _code.size()) && (_code[n].mnemonic == "") &&
+             (_code[n].label == ""))
+        n++;
+      CMachInstr *b = (n < _code.size()) && (_code[n].mnemonic != "") ?
+                      &_code[n] : NULL;
+
+      // jmp to a label that follows: drop the jump
+      if (a.mnemonic == "jmp") {
+        size_t l = k + 1;
+        while ((l < _code.size()) && (_code[l].mnemonic == "") &&
+               (_code[l].label != a.ops[0]))
+          l++;
+        if ((l < _code.size()) && (_code[l].label == a.ops[0])) {
+          _code.erase(_code.begin() + k);
+          changed = true;
+          continue;
+        }
+      }
+
+      // movl $0, r -> xorl r, r (changes the flags)
+      if ((a.mnemonic == "movl") && (a.ops[0] == "$0") &&
+          (Register32(a.ops[1]) >= 0) && FlagsDead(k)) {
+        a.mnemonic = "xorl";
+        a.ops[0] = a.ops[1];
+        changed = true;
+      }
+
+      // op ..., r; testl r, r; jcc: the arithmetic has already set ZF and SF
+      // for r. Drop the test so that op and jcc can fuse; the sign tests
+      // become js/jns since op sets OF differently than test
+      if ((b != NULL) && (a.ops.size() > 0) && (Register32(a.ops.back()) >= 0) &&
+          ((a.mnemonic == "addl") || (a.mnemonic == "subl") ||
+           (a.mnemonic == "andl") || (a.mnemonic == "orl") ||
+           (a.mnemonic == "xorl") || (a.mnemonic == "negl") ||
+           (a.mnemonic == "incl") || (a.mnemonic == "decl")) &&
+          (b->ops.size() == 2) && (b->ops[1] == a.ops.back()) &&
+          (((b->mnemonic == "testl") && (b->ops[0] == b->ops[1])) ||
+           ((b->mnemonic == "cmpl") && (b->ops[0] == "$0")))) {
+        size_t j = n + 1;
+        while ((j < _code.size()) && (_code[j].mnemonic == "") &&
+               (_code[j].label == ""))
+          j++;
+        size_t l = j + 1;
+        while ((l < _code.size()) && (_code[l].mnemonic == "") &&
+               (_code[l].label == ""))
+          l++;
+        string cc = j < _code.size() ? _code[j].mnemonic : "";
+        bool single = (l >= _code.size()) || (_code[l].mnemonic == "jmp") ||
+                      (_code[l].mnemonic[0] != 'j');
+        if (single && ((cc == "je") || (cc == "jne") || (cc == "jl") || (cc == "jge"))) {
+          if (cc == "jl") _code[j].mnemonic = "js";
+          if (cc == "jge") _code[j].mnemonic = "jns";
+          if (_code[j].comment == "") _code[j].comment = b->comment;
+          _code.erase(_code.begin() + n);
+          changed = true;
+          continue;
+        }
+      }
+
+      if ((b == NULL) || (a.ops.size() != 2) || (b->ops.size() != 2)) {
+        k++;
+        continue;
+      }
+
+      // mov r, x; mov x, r: drop the reload
+      if (((a.mnemonic == "movl") || (a.mnemonic == "movb")) &&
+          (b->mnemonic == a.mnemonic) && (a.ops[0][0] == '%') &&
+          (b->ops[0] == a.ops[1]) && (b->ops[1] == a.ops[0])) {
+        if ((b->comment != "") && (n + 1 < _code.size()) &&
+            (_code[n+1].mnemonic != "") && (_code[n+1].comment == ""))
+          _code[n+1].comment = b->comment;
+        _code.erase(_code.begin() + n);
+        changed = true;
+        continue;
+      }
+
+      // movl m, r; op r, d: fold the load into op if r is dead afterwards
+      int r = Register32(a.ops[1]);
+      const string &m = b->mnemonic;
+      if ((a.mnemonic == "movl") && (a.ops[0][0] != '%') && (r >= 0) &&
+          ((m == "addl") || (m == "subl") || (m == "imull") ||
+           (m == "andl") || (m == "orl") || (m == "xorl") ||
+           (m == "cmpl") || (m == "testl")) &&
+          (b->ops[0] == a.ops[1]) && (Register32(b->ops[1]) >= 0) &&
+          (b->ops[1] != a.ops[1]) && IsDead(n, a.ops[1])) {
+        b->ops[0] = a.ops[0];
+        if (b->comment == "") b->comment = a.comment;
+        _code.erase(_code.begin() + k);
+        changed = true;
+        continue;
+      }
+
+      k++;
+    }
+  }
+}
+
+bool CBackendx86::IsDead(size_t k, string reg) const
+{
+  int r = Register32(reg);
+  assert(r >= 0);
+
+  // the code never keeps scratch registers live across labels and jumps;
+  // %eax holds the return value when jumping to the epilogue
+  bool scratch = r != 0;
+  for (const auto &v : _reg)
+    if (v.second == reg) scratch = false;
+
+  for (size_t j = k + 1; j < _code.size(); j++) {
+    const CMachInstr &mi = _code[j];
+    const string &m = mi.mnemonic;
+
+    if (mi.label != "") return scratch;
+    if (m == "") continue;
+
+    if (m == "ret") return r != 0;
+    if (m == "jmp") return scratch;
+    if (m[0] == 'j') {
+      if (!scratch) return false;
+      continue;
+    }
+    if (m == "call") {
+      // the call reads the arguments passed in registers
+      const CSymProc *p = dynamic_cast<const CSymProc*>(
+        _m->GetSymbolTable()->FindSymbol(mi.ops[0]));
+      for (int a = 0; (p != NULL) && (a < RegisterArgs(p)); a++)
+        if (Register32(fastregs[a]) == r) return false;
+      if ((r == 0) || (r == 2) || (r == 3)) return true;
+      continue;
+    }
+
+    // implicit operands
+    if ((m == "cdq") || (m == "cltd")) {
+      if (r == 0) return false;
+      if (r == 3) return true;
+      continue;
+    }
+    if ((m == "rep") && ((r == 0) || (r == 2) || (r == 5))) return false;
+    if ((mi.ops.size() == 1) && ((r == 0) || (r == 3)) &&
+        ((m == "idivl") || (m == "divl") || (m == "imull") || (m == "mull")))
+      return false;
+
+    // explicit operands: a write of the whole register kills it
+    if ((mi.ops.size() == 2) && (mi.ops[1] == reg) &&
+        !Mentions(mi.ops[0], r) &&
+        ((m == "movl") || (m == "leal") || (m == "movzbl") ||
+         (m == "movzwl") || (m == "movsbl") || (m == "movswl")))
+      return true;
+    if ((mi.ops.size() == 2) && (mi.ops[0] == reg) && (mi.ops[1] == reg) &&
+        (m == "xorl"))
+      return true;
+    if ((mi.ops.size() == 1) && (mi.ops[0] == reg) && (m == "popl"))
+      return true;
+
+    for (const auto &op : mi.ops)
+      if (Mentions(op, r)) return false;
+  }
+
+  return false;
+}
+
+bool CBackendx86::FlagsDead(size_t k) const
+{
+  // like scratch registers, the flags are never live across labels and jumps
+  for (size_t j = k + 1; j < _code.size(); j++) {
+    const string &m = _code[j].mnemonic;
+
+    if (_code[j].label != "") return true;
+    if (m == "") continue;
+
+    if ((m == "jmp") || (m == "call") || (m == "ret")) return true;
+    if ((m[0] == 'j') || (m.compare(0, 3, "set") == 0) ||
+        (m.compare(0, 4, "cmov") == 0) || (m == "adcl") || (m == "sbbl"))
+      return false;
+    if ((m == "addl") || (m == "subl") || (m == "andl") || (m == "orl") ||
+        (m == "xorl") || (m == "cmpl") || (m == "cmpb") || (m == "testl") ||
+        (m == "testb") || (m == "negl") || (m == "incl") || (m == "decl"))
+      return true;
+  }
+
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+// CBackendx86_64
+//
+
+// general-purpose registers by operand size: 8, 4, 2 and 1 bytes
+static const char *gprs[][4] = {
+  { "%rax", "%eax",  "%ax",   "%al"   },
+  { "%rcx", "%ecx",  "%cx",   "%cl"   },
+  { "%rdx", "%edx",  "%dx",   "%dl"   },
+  { "%rbx", "%ebx",  "%bx",   "%bl"   },
+  { "%rsi", "%esi",  "%si",   "%sil"  },
+  { "%rdi", "%edi",  "%di",   "%dil"  },
+  { "%r8",  "%r8d",  "%r8w",  "%r8b"  },
+  { "%r9",  "%r9d",  "%r9w",  "%r9b"  },
+  { "%r10", "%r10d", "%r10w", "%r10b" },
+  { "%r11", "%r11d", "%r11w", "%r11b" },
+  { "%r12", "%r12d", "%r12w", "%r12b" },
+  { "%r13", "%r13d", "%r13w", "%r13b" },
+  { "%r14", "%r14d", "%r14w", "%r14b" },
+  { "%r15", "%r15d", "%r15w", "%r15b" },
+};
+static const int ngprs = sizeof(gprs) / sizeof(gprs[0]);
+
+// argument registers of the System V ABI
+static const char *argregs[] = { "%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9" };
+static const int nargregs = 6;
+
+// registers available to the register allocator. The callee-saved ones come
+// first; %r10 and %r11 are neither used for arguments nor by the code
+// generator (which only needs %rax, %rcx and %rdx) and survive as long as
+// there are no calls
+static const char *regs64[] = { "%rbx", "%r12", "%r13", "%r14", "%r15",
+                                "%r10", "%r11" };
+static const int nregs64 = 7;     // number of registers
+static const int ncallee64 = 5;   // number of callee-saved registers (first)
+
+/// @brief return the name of the @a size-byte part of 64-bit register @a r
+static string Reg(string r, int size)
+{
+  int col = size == 8 ? 0 : size == 4 ? 1 : size == 2 ? 2 : 3;
+
+  for (int i = 0; i < ngprs; i++)
+    if (r == gprs[i][0]) return gprs[i][col];
+
+  assert(false);
+  return r;
+}
+
+/// @brief return the instruction suffix for @a size-byte operands
+static string Suffix(int size)
+{
+  switch (size) {
+    case 1:  return "b";
+    case 2:  return "w";
+    case 4:  return "l";
+    default: return "q";
+  }
+}
+
+CBackendx86_64::CBackendx86_64(ostream &out, int level)
+  : CBackend(out), _curr_scope(NULL), _level(level), _depth(0)
+{
+  _ind = string(4, ' ');
+}
+
+CBackendx86_64::~CBackendx86_64(void)
+{
+}
+
+void CBackendx86_64::EmitHeader(void)
+{
+  _out << "##################################################" << endl
+       << "# " << _m->GetName() << endl
+       << "#" << endl
+       << endl;
+}
+
+void CBackendx86_64::EmitCode(void)
+{
+  _out << _ind << "#-----------------------------------------" << endl
+       << _ind << "# text section" << endl
+       << _ind << "#" << endl
+       << _ind << ".text" << endl
+       << _ind << ".align 16" << endl
+       << endl
+       << _ind << "# entry point and pre-defined functions" << endl
+       << _ind << ".global main" << endl
+       << _ind << ".extern DIM" << endl
+       << _ind << ".extern DOFS" << endl
+       << _ind << ".extern BoundsError" << endl
+       << _ind << ".extern ReadInt" << endl
+       << _ind << ".extern WriteInt" << endl
+       << _ind << ".extern WriteStr" << endl
+       << _ind << ".extern WriteChar" << endl
+       << _ind << ".extern WriteLn" << endl
+       << endl;
+
+  const vector<CScope*> &subscopes = _m->GetSubscopes();
+  for (const auto &s : subscopes) {
+    SetScope(s);
+    EmitScope(s);
+  }
+  SetScope(_m);
+  EmitScope(_m);
+
+  _out << _ind << "# end of text section" << endl
+       << _ind << "#-----------------------------------------" << endl
+       << endl;
+}
+
+void CBackendx86_64::EmitData(void)
+{
+  _out << _ind << "#-----------------------------------------" << endl
+       << _ind << "# global data section" << endl
+       << _ind << "#" << endl
+       << _ind << ".data" << endl
+       << _ind << ".align 4" << endl
+       << endl;
+
+  EmitGlobalData(_m);
+
+  _out << _ind << "# end of global data section" << endl
+       << _ind << "#-----------------------------------------" << endl
+       << endl;
+}
+
+void CBackendx86_64::EmitFooter(void)
+{
+  _out << _ind << ".section .note.GNU-stack,\"\",@progbits" << endl
+       << _ind << ".end" << endl
+       << "##################################################" << endl;
+}
+
+void CBackendx86_64::SetScope(CScope *scope)
+{
+  _curr_scope = scope;
+}
+
+CScope* CBackendx86_64::GetScope(void) const
+{
+  return _curr_scope;
+}
+
+void CBackendx86_64::EmitScope(CScope *scope)
+{
+  assert(scope != NULL);
+
+  string label;
+
+  if (scope->GetParent() == NULL) label = "main";
+  else label = scope->GetName();
+
+  /* label */
+  _out << _ind << "# scope " << scope->GetName() << endl
+       << label << ":" << endl;
+
+  /* FindAddresses(scope), AllocateRegisters(scope), FindCalls(scope) */
+  FindDimCalls(scope, _dim, _dimargs);
+  FindAddresses(scope);
+  AllocateRegisters(scope);
+  FindCalls(scope);
+
+  /* ComputeStackOffsets(scope)
+   * the locals lie below the saved registers; the local area is padded
+   * such that %rsp is 16-byte aligned after the prologue
+   */
+  int saved = 8 * _saved.size();
+
+  _out << _ind << "# stack offsets:" << endl;
+  size_t size = ComputeStackOffsets(scope->GetSymbolTable(), -saved);
+  if ((size + saved) % 16 != 0) size += 16 - (size + saved) % 16;
+  _out << endl;
+
+  /* emit function prologue */
+  _out << _ind << "# prologue" << endl;
+  EmitInstruction("pushq", "%rbp");
+  EmitInstruction("movq", "%rsp, %rbp");
+  for (size_t k = 0; k < _saved.size(); k++)
+    EmitInstruction("pushq", _saved[k], k == 0 ? "save callee saved registers" : "");
+  if (size > 0)
+    EmitInstruction("subq", Imm(size) + ", %rsp", "make room for locals");
+
+  /* memset local stack area to 0
+   * the argument registers are still live; larger areas are cleared by a
+   * loop counting %rax up to zero
+   */
+  if (size >= 40) {
+    _out << endl;
+    EmitInstruction("movq", Imm(-(int)(size / 8)) + ", %rax", "memset local stack area to 0");
+    _out << "1:" << endl;
+    EmitInstruction("movq", "$0, " + to_string(size) + "(%rsp,%rax,8)");
+    EmitInstruction("incq", "%rax");
+    EmitInstruction("jnz", "1b");
+  }
+  else if (size > 0) {
+    _out << endl;
+    EmitInstruction("xorl", "%eax, %eax", "memset local stack area to 0");
+    for (int i = size - 8; i >= 0; i -= 8)
+      EmitInstruction("movq", "%rax, " + to_string(i) + "(%rsp)");
+  }
+
+  /* move the arguments into their registers or stack slots and clear the
+   * register variables
+   */
+  vector<CSymbol*> slist = scope->GetSymbolTable()->GetSymbols();
+  bool first = true;
+
+  for (const auto &s : slist) {
+    ESymbolType stype = s->GetSymbolType();
+    string reg = Register(s);
+    int sz = _wide.count(s) > 0 ? 8 : s->GetDataType()->GetDataSize();
+    string slot = to_string(s->GetOffset()) + "(" + s->GetBaseRegister() + ")";
+    string src, dst;
+
+    if (stype == stParam) {
+      int idx = dynamic_cast<CSymParam*>(s)->GetIndex();
+      src = idx < nargregs ? Reg(argregs[idx], sz) : slot;
+      dst = reg != "" ? Reg(reg, sz) : slot;
+      if (src == dst) continue;
+    }
+    else if ((stype == stLocal) && (reg != "")) {
+      src = Reg(reg, 4);
+      dst = src;
+    }
+    else continue;
+
+    if (first) _out << endl;
+    first = false;
+
+    if (stype == stParam)
+      EmitInstruction("mov" + Suffix(sz), src + ", " + dst,
+                      "parameter '" + s->GetName() + "'");
+    else
+      EmitInstruction("xorl", src + ", " + dst,
+                      "register variable '" + s->GetName() + "'");
+  }
+
+  /* emit local data */
+  if (scope->GetParent())
+    EmitLocalData(scope);
+
+  _out << endl;
+
+  /* emit function body */
+  _out << _ind << "# function body" << endl;
+  const list<CTacInstr*> &instructions = scope->GetCodeBlock()->GetInstr();
+
+  _depth = 0;
+  for (const auto &i : instructions) EmitInstruction(i);
+  _out << endl;
+
+  /* emit function epilogue */
+  _out << Label("exit") << ":" << endl
+       << _ind << "# epilogue" << endl;
+  if (scope->GetParent() == NULL)
+    EmitInstruction("xorl", "%eax, %eax", "exit code 0");
+  if (size > 0)
+    EmitInstruction("addq", Imm(size) + ", %rsp", "remove locals");
+  for (size_t k = _saved.size(); k > 0; k--)
+    EmitInstruction("popq", _saved[k-1]);
+  EmitInstruction("popq", "%rbp");
+  EmitInstruction("ret");
+  _out << endl;
+}
+
+void CBackendx86_64::EmitGlobalData(CScope *scope)
+{
+  assert(scope != NULL);
+
+  // emit the globals for the current scope
+  CSymtab *st = scope->GetSymbolTable();
+  assert(st != NULL);
+
+  bool header = false;
+
+  vector<CSymbol*> slist = st->GetSymbols();
+
+  _out << dec;
+
+  size_t size = 0;
+
+  for (size_t i = 0; i < slist.size(); i++) {
+    CSymbol *s = slist[i];
+    const CType *t = s->GetDataType();
+
+    if (s->GetSymbolType() == stGlobal) {
+      if (!header) {
+        _out << _ind << "# scope: " << scope->GetName() << endl;
+        header = true;
+      }
+
+      // insert alignment only when necessary
+      if ((t->GetAlign() > 1) && (size % t->GetAlign() != 0)) {
+        size += t->GetAlign() - size % t->GetAlign();
+        _out << setw(4) << " " << ".align "
+             << right << setw(3) << t->GetAlign() << endl;
+      }
+
+      _out << left << setw(36) << s->GetName() + ":" << "# " << t << endl;
+
+      if (t->IsArray()) {
+        const CArrayType *a = dynamic_cast<const CArrayType*>(t);
+        assert(a != NULL);
+        int dim = a->GetNDim();
+
+        _out << setw(4) << " "
+          << ".long " << right << setw(4) << dim << endl;
+
+        for (int d=0; d<dim; d++) {
+          assert(a != NULL);
+
+          _out << setw(4) << " "
+            << ".long " << right << setw(4) << a->GetNElem() << endl;
+
+          a = dynamic_cast<const CArrayType*>(a->GetInnerType());
+        }
+      }
+
+      const CDataInitializer *di = s->GetData();
+      if (di != NULL) {
+        const CDataInitString *sdi = dynamic_cast<const CDataInitString*>(di);
+        assert(sdi != NULL);  // only support string data initializers for now
+
+        _out << left << setw(4) << " "
+          << ".asciz " << '"' << sdi->GetData() << '"' << endl;
+      } else {
+        _out  << left << setw(4) << " "
+          << ".skip " << dec << right << setw(4) << t->GetDataSize()
+          << endl;
+      }
+
+      size += t->GetSize();
+    }
+  }
+
+  _out << endl;
+
+  // emit globals in subscopes (necessary if we support static local variables)
+  vector<CScope*>::const_iterator sit = scope->GetSubscopes().begin();
+  while (sit != scope->GetSubscopes().end()) EmitGlobalData(*sit++);
+}
+
+void CBackendx86_64::EmitLocalData(CScope *scope)
+{
+  assert(scope != NULL);
+
+  CSymtab *st = scope->GetSymbolTable();
+  assert(st != NULL);
+
+  vector<CSymbol*> slist = st->GetSymbols();
+
+  _out << dec;
+
+  for (size_t i = 0; i < slist.size(); i++) {
+    CSymbol *s = slist[i];
+    const CType *t = s->GetDataType();
+
+    if (t->IsArray()) {
+      const CArrayType *a = dynamic_cast<const CArrayType*>(t);
+      assert(a != NULL);
+
+      int dim = a->GetNDim();
+      int ofs = s->GetOffset();
+      string reg = s->GetBaseRegister();
+
+      string arg = Imm(dim) + ", " + to_string(ofs) + "(" + reg + ")";
+      string cmt = "local array '" + s->GetName() + "': " + to_string(dim) + " dimensions";
+      EmitInstruction("movl", arg, cmt);
+
+      for (int j = 0; j < dim; j++) {
+        int nelem = a->GetNElem();
+        ofs += 4;
+
+        string arg = Imm(nelem) + ", " + to_string(ofs) + "(" + reg + ")";
+        string cmt = "  dimension " + to_string(j + 1) + ": " + to_string(nelem) + " elements";
+        EmitInstruction("movl", arg, cmt);
+
+        a = dynamic_cast<const CArrayType*>(a->GetInnerType());
+      }
+    }
+  }
+}
+
+void CBackendx86_64::EmitInstruction(CTacInstr *i)
+{
+  assert(i != NULL);
+
+  ostringstream cmt;
+  cmt << i;
+
+  EOperation op = i->GetOperation();
+
+  switch (op) {
+    // binary operators
+    // dst = src1 op src2
+    // addresses are computed with 64 bits, integers with 32 bits
+    case opAdd:
+    case opSub:
+    case opMul:
+    case opDiv:
+    case opUDiv:
+    case opAnd:
+    case opOr:
+    {
+      int size = OperandSize(i->GetDest()) == 8 ? 8 : 4;
+      string sfx = Suffix(size), acc = Reg("%rax", size), src;
+      CTacConst *c2 = dynamic_cast<CTacConst*>(i->GetSrc(2));
+
+      Load(i->GetSrc(1), "%rax", cmt.str());
+      if ((c2 != NULL) && ((op == opAdd) || (op == opSub) || (op == opMul)))
+        src = Imm(c2->GetValue());
+      else {
+        Load(i->GetSrc(2), "%rcx");
+        src = Reg("%rcx", size);
+      }
+
+      if (op == opAdd)
+        EmitInstruction("add" + sfx, src + ", " + acc);
+      else if (op == opSub)
+        EmitInstruction("sub" + sfx, src + ", " + acc);
+      else if (op == opMul)
+        EmitInstruction("imul" + sfx, src + ", " + acc);
+      else if (op == opDiv) {
+        EmitInstruction("cltd");
+        EmitInstruction("idivl", "%ecx");
+      }
+      else if (op == opUDiv) {
+        EmitInstruction("xorl", "%edx, %edx");
+        EmitInstruction("divl", "%ecx");
+      }
+      else if (op == opAnd) {
+        /* opAnd will not be appeared */
+        EmitInstruction("and" + sfx, src + ", " + acc);
+      }
+      else {
+        /* opOr will not be appeared */
+        EmitInstruction("or" + sfx, src + ", " + acc);
+      }
+
+      Store(i->GetDest());
+      break;
+    }
+
+    // unary operators
+    // dst = op src1
+    case opPos:
+    case opNeg:
+    case opNot:
+    {
+      int size = OperandSize(i->GetDest()) == 8 ? 8 : 4;
+
+      Load(i->GetSrc(1), "%rax", cmt.str());
+      if (op == opNeg)
+        EmitInstruction("neg" + Suffix(size), Reg("%rax", size));
+      else if (op == opNot) {
+        /* opNot will not be appeared */
+        EmitInstruction("not" + Suffix(size), Reg("%rax", size));
+      }
+      Store(i->GetDest());
+      break;
+    }
+
+    // memory operations
+    // dst = src1
+    case opAssign:
+    {
+      // register variables are loaded directly
+      const CTacName *dst = dynamic_cast<const CTacName*>(i->GetDest());
+      const CTacName *src = dynamic_cast<const CTacName*>(i->GetSrc(1));
+      string reg;
+      if ((dst != NULL) && (dynamic_cast<const CTacReference*>(dst) == NULL))
+        reg = Register(dst->GetSymbol());
+
+      if (reg != "") {
+        if ((src == NULL) || (dynamic_cast<const CTacReference*>(src) != NULL) ||
+            (Register(src->GetSymbol()) != reg))
+          Load(i->GetSrc(1), reg, cmt.str());
+        break;
+      }
+
+      Load(i->GetSrc(1), "%rax", cmt.str());
+      Store(i->GetDest());
+      break;
+    }
+
+    // pointer operations
+    // dst = &src1
+    case opAddress:
+      EmitInstruction("leaq", Operand(i->GetSrc(1), "%rax") + ", %rax", cmt.str());
+      Store(i->GetDest());
+      break;
+    // dst = *src1
+    case opDeref:
+      // opDeref not generated for now
+      EmitInstruction("# opDeref", "not implemented", cmt.str());
+      break;
+
+    // unconditional branching
+    // goto dst
+    case opGoto:
+      EmitInstruction("jmp", Label(dynamic_cast<const CTacLabel*>(i->GetDest())), cmt.str());
+      break;
+
+    // conditional branching
+    // if src1 relOp src2 then goto dst
+    case opEqual:
+    case opNotEqual:
+    case opLessThan:
+    case opLessEqual:
+    case opBiggerThan:
+    case opBiggerEqual:
+    case opCheck:
+    {
+      // both operands are extended to 64 bits; integers are compared with
+      // 32 bits, the bounds check compares unsigned to catch negative indices.
+      // A right operand of the compared size is used from memory unless it is
+      // %rip-relative (which does not fuse with the jcc); zero is tested for
+      int size = (OperandSize(i->GetSrc(1)) == 8) ||
+                 (OperandSize(i->GetSrc(2)) == 8) ? 8 : 4;
+      CTacConst *c2 = dynamic_cast<CTacConst*>(i->GetSrc(2));
+      CTacName *n2 = dynamic_cast<CTacName*>(i->GetSrc(2));
+      string src;
+
+      Load(i->GetSrc(1), "%rax", cmt.str());
+      if (c2 != NULL) src = Imm(c2->GetValue());
+      else if ((OperandSize(n2) == size) &&
+               ((dynamic_cast<CTacReference*>(n2) != NULL) ||
+                (n2->GetSymbol()->GetSymbolType() != stGlobal)))
+        src = Operand(n2, "%rcx");
+      else {
+        Load(i->GetSrc(2), "%rcx");
+        src = Reg("%rcx", size);
+      }
+
+      if ((src == "$0") && (op != opCheck))
+        EmitInstruction("test" + Suffix(size), Reg("%rax", size) + ", " + Reg("%rax", size));
+      else
+        EmitInstruction("cmp" + Suffix(size), src + ", " + Reg("%rax", size));
+
+      if (op == opCheck)
+        EmitInstruction("jae", "BoundsError");
+      else
+        EmitInstruction("j" + Condition(op), Label(dynamic_cast<const CTacLabel*>(i->GetDest())));
+      break;
+    }
+
+    // function call-related operations
+    // the arguments have been pushed in reverse order; the ones passed in
+    // registers are popped into them
+    case opCall:
+    {
+      const CTacName *fun = dynamic_cast<const CTacName*>(i->GetSrc(1));
+      const CSymProc *sym = dynamic_cast<const CSymProc*>(fun->GetSymbol());
+      assert(fun != NULL);
+      assert(sym != NULL);
+
+      string c = cmt.str();
+
+      // inlined DIM: load the size of the dimension from the array header
+      map<const CTacInstr*, pair<CTacAddr*, int> >::const_iterator d = _dim.find(i);
+      if (d != _dim.end()) {
+        string base = Operand(d->second.first, "%rax");
+        if (base[0] != '%') {
+          Load(d->second.first, "%rax", c);
+          base = "%rax";
+          c = "";
+        }
+        EmitInstruction("movl", to_string(d->second.second) + "(" + base + "), %eax", c);
+        if (i->GetDest())
+          Store(i->GetDest());
+        break;
+      }
+
+      int n = sym->GetNParams(), r = min(n, nargregs);
+      int pad = _pad.count(i) > 0 ? _pad[i] : 0;
+
+      for (int k = 0; k < r; k++) {
+        EmitInstruction("popq", argregs[k], c);
+        c = "";
+      }
+      EmitInstruction("call", sym->GetName(), c);
+      if (n - r + pad > 0)
+        EmitInstruction("addq", Imm(8 * (n - r + pad)) + ", %rsp");
+      _depth -= n + pad;
+
+      if (i->GetDest())
+        Store(i->GetDest());
+      break;
+    }
+    case opReturn:
+      if (i->GetSrc(1)) {
+        Load(i->GetSrc(1), "%rax", cmt.str());
+        EmitInstruction("jmp", Label("exit"));
+      }
+      else
+        EmitInstruction("jmp", Label("exit"), cmt.str());
+      break;
+    case opParam:
+    {
+      if (_dimargs.count(i) > 0) break;
+
+      // the stack must be 16-byte aligned at the call once the register
+      // arguments are popped
+      string c = cmt.str();
+      map<const CTacInstr*, const CTacInstr*>::const_iterator f = _first.find(i);
+
+      if (f != _first.end()) {
+        int n = GetCallee(f->second)->GetNParams();
+        int pad = (_depth + n - min(n, nargregs)) % 2;
+
+        _pad[f->second] = pad;
+        if (pad > 0) {
+          EmitInstruction("subq", "$8, %rsp", c);
+          c = "";
+        }
+        _depth += pad;
+      }
+
+      CTacAddr *src = i->GetSrc(1);
+      if ((OperandSize(src) == 8) || (dynamic_cast<CTacConst*>(src) != NULL))
+        EmitInstruction("pushq", Operand(src, "%rax"), c);
+      else {
+        Load(src, "%rax", c);
+        EmitInstruction("pushq", "%rax");
+      }
+      _depth++;
+      break;
+    }
+
+    // special
+    case opLabel:
+      _out << Label(dynamic_cast<CTacLabel*>(i)) << ":" << endl;
+      break;
+
+    case opNop:
+      EmitInstruction("nop", "", cmt.str());
+      break;
+
+    default:
+      EmitInstruction("# ???", "not implemented", cmt.str());
+  }
+}
+
+void CBackendx86_64::EmitInstruction(string mnemonic, string args, string comment)
+{
+  _out << left
+       << _ind
+       << setw(7) << mnemonic << " "
+       << setw(23) << args;
+  if (comment != "") _out << " # " << comment;
+  _out << endl;
+}
+
+void CBackendx86_64::Load(CTacAddr *src, string dst, string comment)
+{
+  assert(src != NULL);
+
+  const CTacConst *c = dynamic_cast<const CTacConst*>(src);
+  if (c != NULL) {
+    EmitInstruction("movq", Imm(c->GetValue()) + ", " + dst, comment);
+    return;
+  }
+
+  string opnd = Operand(src, dst);
+
+  // extend the operand to 64 bits
+  switch (OperandSize(src)) {
+    case 1:  EmitInstruction("movzbl", opnd + ", " + Reg(dst, 4), comment); break;
+    case 2:  EmitInstruction("movzwl", opnd + ", " + Reg(dst, 4), comment); break;
+    case 4:  EmitInstruction("movslq", opnd + ", " + dst, comment); break;
+    default: EmitInstruction("movq", opnd + ", " + dst, comment); break;
+  }
+}
+
+void CBackendx86_64::Store(CTac *dst, string comment)
+{
+  assert(dst != NULL);
+
+  int size = OperandSize(dst);
+  string opnd = Operand(dst, "%rcx");
+
+  EmitInstruction("mov" + Suffix(size), Reg("%rax", size) + ", " + opnd, comment);
+}
+
+string CBackendx86_64::Operand(const CTac *op, string scratch)
+{
+  /* op : type CTacReference
+   * the pointer is loaded into the scratch register unless it is held in one
+   */
+  const CTacReference *opRef = dynamic_cast<const CTacReference*>(op);
+  if (opRef) {
+    const CSymbol *sym = opRef->GetSymbol();
+    string reg = Register(sym);
+    if (reg == "") {
+      EmitInstruction("movq", to_string(sym->GetOffset()) + "(" + sym->GetBaseRegister() + "), " + scratch);
+      reg = scratch;
+    }
+
+    return "(" + reg + ")";
+  }
+
+  /* op : type CTacName
+   * globals are addressed relative to %rip
+   */
+  const CTacName *opName = dynamic_cast<const CTacName*>(op);
+  if (opName) {
+    const CSymbol *sym = opName->GetSymbol();
+    ESymbolType symbolType = sym->GetSymbolType();
+
+    if (symbolType == stGlobal || symbolType == stProcedure)
+      return sym->GetName() + "(%rip)";
+    if (Register(sym) != "")
+      return Reg(Register(sym), OperandSize(op));
+    return to_string(sym->GetOffset()) + "(" + sym->GetBaseRegister() + ")";
+  }
+
+  /* op : type CTacConst */
+  const CTacConst *opConst = dynamic_cast<const CTacConst*>(op);
+  if (opConst) return Imm(opConst->GetValue());
+
+  return "";
+}
+
+string CBackendx86_64::Register(const CSymbol *sym) const
+{
+  map<const CSymbol*, string>::const_iterator it = _reg.find(sym);
+
+  return it != _reg.end() ? it->second : "";
+}
+
+string CBackendx86_64::Imm(int value) const
+{
+  ostringstream o;
+  o << "$" << dec << value;
+  return o.str();
+}
+
+string CBackendx86_64::Label(const CTacLabel* label) const
+{
+  CScope *cs = GetScope();
+  assert(cs != NULL);
+
+  return "l_" + cs->GetName() + "_" + label->GetLabel();
+}
+
+string CBackendx86_64::Label(string label) const
+{
+  CScope *cs = GetScope();
+  assert(cs != NULL);
+
+  return "l_" + cs->GetName() + "_" + label;
+}
+
+string CBackendx86_64::Condition(EOperation cond) const
+{
+  switch (cond) {
+    case opEqual:       return "e";
+    case opNotEqual:    return "ne";
+    case opLessThan:    return "l";
+    case opLessEqual:   return "le";
+    case opBiggerThan:  return "g";
+    case opBiggerEqual: return "ge";
+    default:            assert(false); break;
+  }
+  return "";
+}
+
+int CBackendx86_64::OperandSize(const CTac *t) const
+{
+  /* t : type CTacReference
+   * the size of the element referenced
+   */
+  const CTacReference *tRef = dynamic_cast<const CTacReference*>(t);
+  if (tRef != NULL) {
+    const CType *dtype = tRef->GetDerefSymbol()->GetDataType();
+    if (dtype->IsPointer())
+      dtype = dynamic_cast<const CPointerType*>(dtype)->GetBaseType();
+    if (dtype->IsArray())
+      dtype = dynamic_cast<const CArrayType*>(dtype)->GetBaseType();
+
+    return dtype->GetDataSize();
+  }
+
+  /* t : type CTacName
+   * variables holding addresses are 8 bytes
+   */
+  const CTacName *tName = dynamic_cast<const CTacName*>(t);
+  if (tName != NULL) {
+    if (_wide.count(tName->GetSymbol()) > 0) return 8;
+    return tName->GetSymbol()->GetDataType()->GetDataSize();
+  }
+
+  /* t : type CTacConst */
+  return 4;
+}
+
+void CBackendx86_64::FindAddresses(CScope *scope)
+{
+  assert(scope != NULL);
+
+  _wide.clear();
+
+  vector<CSymbol*> slist = scope->GetSymbolTable()->GetSymbols();
+  for (const auto &s : slist)
+    if (s->GetDataType()->IsPointer()) _wide.insert(s);
+
+  /* propagate through sums, differences and copies until nothing changes.
+   * Only locals and temporaries are widened; the IR computes element
+   * addresses in integer temporaries
+   */
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  bool changed = true;
+
+  while (changed) {
+    changed = false;
+
+    for (const auto &i : il) {
+      EOperation op = i->GetOperation();
+      const CTacName *dst = dynamic_cast<const CTacName*>(i->GetDest());
+
+      if ((dst == NULL) || (dynamic_cast<const CTacReference*>(dst) != NULL))
+        continue;
+      if ((dst->GetSymbol()->GetSymbolType() != stLocal) ||
+          (_wide.count(dst->GetSymbol()) > 0))
+        continue;
+
+      bool wide = op == opAddress;
+      if ((op == opAdd) || (op == opSub) || (op == opAssign) || (op == opPos)) {
+        for (int k = 1; k <= 2; k++) {
+          const CTacName *n = dynamic_cast<const CTacName*>(i->GetSrc(k));
+          if ((n != NULL) && (dynamic_cast<const CTacReference*>(n) == NULL) &&
+              (_wide.count(n->GetSymbol()) > 0))
+            wide = true;
+        }
+      }
+
+      if (wide) {
+        _wide.insert(dst->GetSymbol());
+        changed = true;
+      }
+    }
+  }
+}
+
+void CBackendx86_64::AllocateRegisters(CScope *scope)
+{
+  assert(scope != NULL);
+
+  _reg.clear();
+  _saved.clear();
+  if (_level < 1) return;
+
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  vector<CTacInstr*> instr(il.begin(), il.end());
+  size_t n = instr.size();
+
+  /* loop depth (a backward branch closes a loop), calls and variables
+   * whose address is taken
+   */
+  map<const CTac*, size_t> label;
+  for (size_t p = 0; p < n; p++)
+    if (instr[p]->GetOperation() == opLabel) label[instr[p]] = p;
+
+  vector<int> depth(n, 0);
+  set<const CSymbol*> addressed;
+  bool leaf = true;
+
+  for (size_t p = 0; p < n; p++) {
+    const CTacInstr *i = instr[p];
+    const CTacName *src = dynamic_cast<const CTacName*>(i->GetSrc(1));
+
+    if ((i->GetOperation() == opCall) && (_dim.count(i) == 0)) leaf = false;
+    if ((i->GetOperation() == opAddress) && (src != NULL) &&
+        (dynamic_cast<const CTacReference*>(src) == NULL))
+      addressed.insert(src->GetSymbol());
+
+    if (i->IsBranch()) {
+      size_t target = label[i->GetDest()];
+      if (target <= p)
+        for (size_t q = target; q <= p; q++) depth[q]++;
+    }
+  }
+
+  /* uses and definitions weighted by 10^loop depth */
+  map<const CSymbol*, double> weight;
+  for (size_t p = 0; p < n; p++) {
+    double w = 1.0;
+    for (int d = 0; d < depth[p]; d++) w *= 10.0;
+
+    vector<const CSymbol*> used;
+    GetUsedSymbols(instr[p], used);
+    for (const auto &u : used) weight[u] += w;
+
+    const CSymbol *d = GetDefinedSymbol(instr[p]);
+    if (d != NULL) weight[d] += w;
+  }
+
+  /* the heaviest candidates get a register, ties in declaration order */
+  vector<CSymbol*> slist = scope->GetSymbolTable()->GetSymbols();
+  vector<pair<double, size_t> > cand;
+
+  for (size_t k = 0; k < slist.size(); k++) {
+    const CSymbol *s = slist[k];
+    ESymbolType stype = s->GetSymbolType();
+    const CType *t = s->GetDataType();
+
+    if ((stype != stLocal) && (stype != stParam)) continue;
+    if ((!t->IsInt() && !t->IsPointer()) || (addressed.count(s) > 0)) continue;
+    if (weight[s] == 0.0) continue;
+
+    cand.push_back(make_pair(-weight[s], k));
+  }
+  sort(cand.begin(), cand.end());
+
+  int nfree = leaf ? nregs64 : ncallee64;
+  for (size_t k = 0; (k < cand.size()) && ((int)k < nfree); k++) {
+    _reg[slist[cand[k].second]] = regs64[k];
+    if ((int)k < ncallee64) _saved.push_back(regs64[k]);
+  }
+}
+
+void CBackendx86_64::FindCalls(CScope *scope)
+{
+  assert(scope != NULL);
+
+  _first.clear();
+  _pad.clear();
+
+  const list<CTacInstr*> &il = scope->GetCodeBlock()->GetInstr();
+  map<const CTacInstr*, size_t> pos;
+  size_t p = 0;
+
+  for (const auto &i : il) pos[i] = p++;
+
+  for (list<CTacInstr*>::const_iterator it = il.begin(); it != il.end(); it++) {
+    if (((*it)->GetOperation() != opCall) || (_dim.count(*it) > 0)) continue;
+
+    vector<CTacInstr*> params;
+    if (!GetParams(il.begin(), it, params) || params.empty()) continue;
+
+    const CTacInstr *first = params[0];
+    for (const auto &q : params)
+      if (pos[q] < pos[first]) first = q;
+    _first[first] = *it;
+  }
+}
+
+size_t CBackendx86_64::ComputeStackOffsets(CSymtab *symtab, int local_ofs)
+{
+  assert(symtab != NULL);
+  vector<CSymbol*> slist = symtab->GetSymbols();
+
+  int start = local_ofs;
+
+  /* foreach local symbol and register parameter l in slist do
+   *   compute aligned offset on stack and store in symbol l
+   *   set base register to %rbp
+   */
+  for (const auto &l : slist) {
+    ESymbolType stype = l->GetSymbolType();
+    const CType *datatype = l->GetDataType();
+
+    if ((stype != stLocal) && (stype != stParam)) continue;
+    if (Register(l) != "") continue;
+    if ((stype == stParam) &&
+        (dynamic_cast<CSymParam*>(l)->GetIndex() >= nargregs)) continue;
+
+    int size, align;
+    if (datatype->IsArray()) {
+      size = datatype->GetSize();
+      align = 4;
+    }
+    else {
+      size = _wide.count(l) > 0 ? 8 : datatype->GetDataSize();
+      align = size;
+    }
+
+    local_ofs -= size;
+    while (local_ofs % align != 0) local_ofs--;
+    l->SetOffset(local_ofs);
+    l->SetBaseRegister("%rbp");
+  }
+
+  /* foreach stack parameter p in slist do
+   *   the 7th and following arguments are above the return address
+   */
+  for (const auto &p : slist) {
+    if (p->GetSymbolType() != stParam) continue;
+
+    int idx = dynamic_cast<CSymParam*>(p)->GetIndex();
+    if (idx < nargregs) continue;
+
+    p->SetOffset(16 + 8 * (idx - nargregs));
+    p->SetBaseRegister("%rbp");
+  }
+
+  /* dump stack frame to assembly file */
+  for (const auto &s : slist) {
+    ESymbolType stype = s->GetSymbolType();
+    if (stype != stLocal && stype != stParam)
+      continue;
+
+    int size = _wide.count(s) > 0 ? 8 : s->GetDataType()->GetSize();
+
+    if (Register(s) != "")
+      _out << _ind << "#" << setw(13) << std::right << Register(s);
+    else
+      _out << _ind << "#" << setw(7) << std::right << s->GetOffset() << "(" << s->GetBaseRegister() << ")";
+    _out << setw(4) << std::right << size << setw(2) << s << endl;
+  }
+
+  return start - local_ofs;
 }
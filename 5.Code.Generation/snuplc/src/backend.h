@@ -37,6 +37,8 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
+#include <set>
 
 #include "symtab.h"
 #include "ir.h"
@@ -88,12 +90,20 @@ class CBackend {
 ///
 /// backend for Intel IA32
 ///
+/// From optimization level 1 on, scalar locals, temporaries and parameters
+/// are kept in registers as assigned by a linear-scan register allocator.
+/// Level 2 uses a slower graph-coloring allocator that also coalesces moves.
+/// From level 1 on, instructions are selected by tiling expression trees
+/// built from the TAC with a cost-annotated rule table (see backend.cpp).
+/// The code of a procedure is collected in a machine instruction list that
+/// is peephole-optimized from level 1 on before it is printed.
+///
 class CBackendx86 : public CBackend {
   public:
     /// @name constructors/destructors
     /// @{
 
-    CBackendx86(ostream &out);
+    CBackendx86(ostream &out, int level=0);
     virtual ~CBackendx86(void);
 
     /// @}
@@ -140,6 +150,25 @@ class CBackendx86 : public CBackend {
     virtual void EmitInstruction(string mnemonic, string args="",
                                  string comment="");
 
+    /// @brief emit %eax = %eax * @a c for a constant @a c
+    ///
+    /// Uses shifts and lea instead of imul where possible.
+    void EmitMulConst(int c);
+
+    /// @brief emit %eax = %eax / @a d for a constant @a d
+    ///
+    /// Powers of two are divided by an arithmetic shift with a rounding
+    /// correction for negative dividends, other divisors by a multiplication
+    /// with a magic number (Hacker's Delight, 10-4). Clobbers %ecx and %edx.
+    /// @param nonneg divide unsigned (see EmitUDivConst())
+    void EmitDivConst(int d, bool nonneg=false);
+
+    /// @brief emit the unsigned division of %eax by the constant @a d.
+    ///        Powers of two are shifted, divisors of 2^31 and more compared,
+    ///        other divisors multiplied by a magic number (Hacker's Delight,
+    ///        10-8). Clobbers %ecx and %edx.
+    void EmitUDivConst(unsigned int d);
+
     /// @brief emit a load instruction
     void Load(CTacAddr *src, string dst, string comment="");
 
@@ -148,7 +177,13 @@ class CBackendx86 : public CBackend {
 
     /// @brief return an operand string for @a op
     /// @param op the operand
-    string Operand(const CTac *op);
+    /// @param scratch register to load the address of a reference into if
+    ///        the pointer is not held in a register
+    string Operand(const CTac *op, string scratch);
+
+    /// @brief return the register assigned to @a sym or "" if @a sym lives
+    ///        in memory
+    string Register(const CSymbol *sym) const;
 
     /// @brief return an immediate for @a value
     string Imm(int value) const;
@@ -168,16 +203,336 @@ class CBackendx86 : public CBackend {
     /// @brief compute the location of local variables, temporaries and
     ///        arguments on the stack. Returns the total size occupied on
     ///        the stack as well as the the number of arguments for this
-    ///        scope (if @a nargs is not NULL)
+    ///        scope (if @a nargs is not NULL). Arguments passed in
+    ///        registers are stored in the local area
     /// @param symtab symbol table
     /// @param param_ofs offset to parameters from base pointer after epilogue
     /// @param local_ofs offset to local vars from base pointer after epilogue
     size_t ComputeStackOffsets(CSymtab *symtab, int param_ofs, int local_ofs);
 
+    /// @brief liveness of the register candidates of a scope
+    struct CLiveness {
+      vector<CTacInstr*> instr;      ///< instructions
+      vector<const CSymbol*> cand;   ///< candidates
+      map<const CSymbol*, int> idx;  ///< index of a candidate
+      vector<vector<int> > use;      ///< candidates used by an instruction
+      vector<int> def;               ///< candidate defined by an instr. or -1
+      vector<vector<size_t> > succ;  ///< successors of an instruction
+      vector<bool> clobber;          ///< instruction clobbers %ecx and %edx
+      vector<bool> callee;           ///< candidate needs a callee-saved reg.
+      vector<vector<bool> > live;    ///< candidates live at an instruction
+      vector<double> weight;         ///< spill weights
+    };
+
+    /// @brief assign registers to the 4-byte scalar locals, temporaries and
+    ///        parameters of @a scope
+    ///
+    /// %ecx and %edx are only assigned to candidates that are not live
+    /// across a call or a division clobbering them.
+    /// Candidates without a register are kept in memory.
+    /// @param scope the scope
+    /// @param init receives the register-allocated symbols that are live at
+    ///        the entry of @a scope and must be initialized by the prologue
+    void AllocateRegisters(CScope *scope, vector<const CSymbol*> &init);
+
+    /// @brief compute the instruction-level liveness of the register
+    ///        candidates of @a scope. Spill weights count uses and
+    ///        definitions weighted by 10^loop depth.
+    void ComputeLiveness(CScope *scope, CLiveness &l) const;
+
+    /// @brief linear-scan register allocation (Poletto & Sarkar)
+    ///
+    /// Allocates one live interval per candidate. If no register is free,
+    /// the interval with the lowest spill weight is kept in memory.
+    /// @param reg receives the register index per candidate or -1
+    void LinearScan(const CLiveness &l, vector<int> &reg) const;
+
+    /// @brief graph-coloring register allocation (Chaitin-Briggs)
+    ///
+    /// Builds the interference graph, conservatively coalesces the operands
+    /// of moves (Briggs test), and colors optimistically; spill candidates
+    /// are chosen by lowest spill weight per degree.
+    /// @param reg receives the register index per candidate or -1
+    void ColorGraph(const CLiveness &l, vector<int> &reg) const;
+
+    /// @brief expression tree node (see backend.cpp)
+    struct CNode;
+
+    /// @brief address operand disp(base,index,scale)
+    struct CAddress {
+      string base;                   ///< base register or ""
+      string index;                  ///< index register or ""
+      int scale;                     ///< scale of the index
+      int disp;                      ///< displacement
+    };
+
+    /// @brief build the expression trees of @a scope
+    ///
+    /// Every instruction computing a value, comparing or passing one gets a
+    /// tree. Temporaries that are defined and used exactly once in the same
+    /// basic block are folded into the tree of their use if no instruction
+    /// in between may change the operands of their definition. Trees are
+    /// kept linear: at most one operand of a node is an inner node.
+    void BuildTrees(CScope *scope);
+
+    /// @brief free the expression trees of the current scope
+    void ClearTrees(void);
+
+    /// @brief return a new tree node
+    CNode* NewNode(EOperation op, CTacAddr *leaf, CNode *kid0=NULL,
+                   CNode *kid1=NULL);
+
+    /// @brief collect the variables read by tree @a n
+    /// @param syms receives the variables (incl. pointers of references)
+    /// @param ninner number of inner nodes (incremented)
+    /// @param memory set if the tree reads through a reference
+    /// @param division set if the tree contains a division
+    void GetTreeOperands(const CNode *n, vector<const CSymbol*> &syms,
+                         int &ninner, bool &memory, bool &division) const;
+
+    /// @brief check whether leaf @a n matches the leaf pattern @a pattern
+    bool MatchLeaf(const CNode *n, int pattern) const;
+
+    /// @brief label @a n with the cheapest rule per nonterminal
+    void MatchTree(CNode *n);
+
+    /// @brief emit the code deriving nonterminal @a nt from @a n
+    /// @retval operand holding the result
+    string ReduceTree(CNode *n, int nt);
+
+    /// @brief derive the address nonterminal @a nt from @a n into @a a
+    void ReduceAddress(CNode *n, int nt, CAddress &a);
+
+    /// @brief return the assembly string for address @a a
+    string Address(const CAddress &a) const;
+
+    /// @brief select the instructions for @a i by tiling its tree
+    void SelectInstruction(CTacInstr *i);
+
+    /// @brief select the instructions storing the value of @a n in @a dst
+    void SelectAssign(CTac *dst, CNode *n);
+
+    /// @brief select the instructions comparing @a l and @a r and jumping
+    ///        to @a target if relation @a op (or the bounds check) holds
+    void SelectCompare(EOperation op, CNode *l, CNode *r, string target);
+
+    /// @brief line of the machine code of a procedure: an instruction, a
+    ///        label, or verbatim text (comments and empty lines)
+    struct CMachInstr {
+      string label;                  ///< label defined by this line or ""
+      string mnemonic;               ///< mnemonic or "" if no instruction
+      vector<string> ops;            ///< operands in AT&T order
+      string comment;                ///< comment (verbatim text if neither
+                                     ///< label nor instruction)
+    };
+
+    /// @brief emit label @a label
+    void EmitLabel(string label);
+
+    /// @brief emit a line of verbatim text
+    void EmitLine(string text="");
+
+    /// @brief print and clear the machine code of the current procedure
+    void EmitMachineCode(void);
+
+    /// @brief peephole optimization of the machine code of the current
+    ///        procedure
+    ///
+    /// Removes reloads of a just stored value and jumps to the next label,
+    /// folds loads into the memory operand of the arithmetic instruction
+    /// using them, and clears registers with xorl.
+    void Peephole(void);
+
+    /// @brief check whether register @a reg is dead after line @a k
+    bool IsDead(size_t k, string reg) const;
+
+    /// @brief check whether the condition flags are dead after line @a k
+    bool FlagsDead(size_t k) const;
+
+    /// @brief move the stack slots of @a symtab and the operands of @a code
+    ///        addressing them to the actual frame layout
+    ///
+    /// ComputeStackOffsets() places the locals below all three callee-saved
+    /// registers; only @a nsaved of them are saved. Without a @a frame,
+    /// the parameters are addressed relative to %esp.
+    void AdjustFrame(CSymtab *symtab, vector<CMachInstr> &code, int nsaved,
+                     bool frame);
+
+    /// @brief emit the stack offsets of the symbols in @a symtab as comments
+    void EmitStackOffsets(CSymtab *symtab);
+
+    /// @brief collect the locals of @a scope on the stack that may be read
+    ///        before they are written in @a uninit
+    ///
+    /// Scalars are subject to a definite-assignment analysis; arrays are
+    /// collected if their elements are read or their address is passed to
+    /// a procedure other than DIM.
+    void FindUninitialized(CScope *scope, set<const CSymbol*> &uninit) const;
+
+    /// @brief emit the code clearing the stack slots of @a uninit in the
+    ///        local area of @a size bytes. Long runs are cleared by
+    ///        rep stosl if @a rep is set (clobbers %ecx and %edi)
+    void ZeroLocals(CSymtab *symtab, size_t size,
+                    const set<const CSymbol*> &uninit, bool rep);
+
+    /// @brief emit the code moving the arguments passed in %ecx and %edx
+    ///        to their stack slots or, if they are in @a init, register
+    ///        variables
+    void EmitRegisterArgs(CSymtab *symtab, const vector<const CSymbol*> &init);
+
+    /// @}
+
+    string _ind;                    ///< indentation
+    CScope *_curr_scope;            ///< current scope
+    int _level;                     ///< optimization level
+    map<const CSymbol*, string> _reg; ///< registers of the current scope
+    map<const CTacInstr*, CNode*> _tree; ///< expression trees
+    map<const CSymbol*, CNode*> _fold; ///< temporaries folded into trees
+    set<const CTacInstr*> _skip;    ///< instructions folded into trees
+    vector<CNode*> _nodes;          ///< nodes of all trees
+    string _cmt;                    ///< comment for the next instruction
+    vector<CMachInstr> _code;       ///< machine code of the current scope
+    map<const CTacInstr*, pair<CTacAddr*, int> > _dim;
+                                    ///< inlined DIM calls: array and offset
+    set<const CTacInstr*> _dimargs; ///< arguments of inlined DIM calls
+    map<const CTacInstr*, vector<const CTacInstr*> > _regargs;
+                                    ///< register arguments loaded by calls
+    set<const CTacInstr*> _regparams; ///< arguments loaded by their call
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief x86-64 backend
+///
+/// backend for AMD64 following the System V ABI
+///
+/// Integers keep their IA32 size of 4 bytes; variables holding addresses
+/// (pointer parameters and the temporaries computing element addresses)
+/// are widened to 8 bytes. The first six arguments are passed in %rdi,
+/// %rsi, %rdx, %rcx, %r8 and %r9, the remaining ones on the stack.
+/// From optimization level 1 on, the most frequently used scalar locals,
+/// temporaries and parameters are kept in the callee-saved registers %rbx
+/// and %r12-%r15 for the whole procedure; procedures without calls also
+/// use %r10 and %r11.
+///
+class CBackendx86_64 : public CBackend {
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    CBackendx86_64(ostream &out, int level=0);
+    virtual ~CBackendx86_64(void);
+
+    /// @}
+
+  protected:
+    /// @name detailed output methods
+    /// @{
+
+    virtual void EmitHeader(void);
+    virtual void EmitCode(void);
+    virtual void EmitData(void);
+    virtual void EmitFooter(void);
+
+    /// @}
+
+    /// @name additional methods
+    /// @{
+
+    /// @brief set the current scope
+    void SetScope(CScope *scope);
+
+    /// @brief get the current scope
+    CScope* GetScope(void) const;
+
+    /// @brief emit a scope
+    virtual void EmitScope(CScope *scope);
+
+    /// @brief emit global data
+    virtual void EmitGlobalData(CScope *s);
+
+    /// @brief emit local data
+    ///
+    /// EmitLocalData() initializes local data (i.e., arrays)
+    virtual void EmitLocalData(CScope *s);
+
+    /// @brief emit instruction @i
+    virtual void EmitInstruction(CTacInstr *i);
+
+    /// @brief emit an instruction
+    virtual void EmitInstruction(string mnemonic, string args="",
+                                 string comment="");
+
+    /// @brief emit a load of @a src into the 64-bit register @a dst
+    ///
+    /// 4-byte values are sign-extended, smaller ones zero-extended.
+    void Load(CTacAddr *src, string dst, string comment="");
+
+    /// @brief emit a store of %rax (sized to @a dst) into @a dst
+    void Store(CTac *dst, string comment="");
+
+    /// @brief return an operand string for @a op
+    /// @param op the operand
+    /// @param scratch register to load the pointer of a reference into if
+    ///        the pointer is not held in a register
+    string Operand(const CTac *op, string scratch);
+
+    /// @brief return the register assigned to @a sym or "" if @a sym lives
+    ///        in memory
+    string Register(const CSymbol *sym) const;
+
+    /// @brief return an immediate for @a value
+    string Imm(int value) const;
+
+    /// @brief return a x86-label for CTaclabel @a label
+    string Label(const CTacLabel *label) const;
+
+    /// @brief return a x86-label for string @a label
+    string Label(string label) const;
+
+    /// @brief return the condition suffix for a binary comparison operation
+    string Condition(EOperation cond) const;
+
+    /// @brief compute the size of operator @t (8 for addresses)
+    int OperandSize(const CTac *t) const;
+
+    /// @brief find the variables of @a scope that hold addresses
+    ///
+    /// Pointers and the results of opAddress are addresses; sums,
+    /// differences and copies of addresses are addresses as well.
+    void FindAddresses(CScope *scope);
+
+    /// @brief assign the callee-saved registers (and the caller-saved
+    ///        registers in procedures without calls) to the scalar
+    ///        candidates with the highest use counts weighted by 10^loop
+    ///        depth
+    void AllocateRegisters(CScope *scope);
+
+    /// @brief map the first argument pushed for each call of @a scope to
+    ///        the call; the stack is aligned there
+    void FindCalls(CScope *scope);
+
+    /// @brief compute the location of locals, temporaries and parameters
+    ///        on the stack. Parameters passed in registers are stored in
+    ///        the local area. Returns the size of the local area.
+    /// @param symtab symbol table
+    /// @param local_ofs offset to local vars from base pointer
+    size_t ComputeStackOffsets(CSymtab *symtab, int local_ofs);
+
     /// @}
 
     string _ind;                    ///< indentation
     CScope *_curr_scope;            ///< current scope
+    int _level;                     ///< optimization level
+    map<const CSymbol*, string> _reg; ///< registers of the current scope
+    vector<string> _saved;          ///< callee-saved registers used
+    set<const CSymbol*> _wide;      ///< variables holding addresses
+    map<const CTacInstr*, const CTacInstr*> _first; ///< first arg. -> call
+    map<const CTacInstr*, int> _pad; ///< stack padding of a call
+    int _depth;                     ///< 8-byte words pushed by calls
+    map<const CTacInstr*, pair<CTacAddr*, int> > _dim;
+                                    ///< inlined DIM calls: array and offset
+    set<const CTacInstr*> _dimargs; ///< arguments of inlined DIM calls
 };
 
 
@@ -0,0 +1,1162 @@
+//------------------------------------------------------------------------------
+/// @brief SnuPL control flow graph
+/// @section changelog Change Log
+/// 2026/10/19 created
+///
+/// @section license_section License
+/// Copyright (c) 2012-2016 Bernhard Egger
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms,  with or without modifi-
+/// cation, are permitted provided that the following conditions are met:
+///
+/// - Redistributions of source code must retain the above copyright notice,
+///   this list of conditions and the following disclaimer.
+/// - Redistributions in binary form must reproduce the above copyright notice,
+///   this list of conditions and the following disclaimer in the documentation
+///   and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY  AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER  OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT,  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+/// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF  SUBSTITUTE
+/// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+/// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN  CONTRACT, STRICT
+/// LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY
+/// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+/// DAMAGE.
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iomanip>
+#include <climits>
+#include <cassert>
+
+#include "cfg.h"
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// TAC operand queries
+//
+bool IsScalarVar(const CSymbol *sym)
+{
+  if (sym == NULL) return false;
+  if (sym->GetSymbolType() == stProcedure) return false;
+
+  return !sym->GetDataType()->IsArray();
+}
+
+const CSymbol* GetDefinedSymbol(const CTacInstr *instr)
+{
+  EOperation op = instr->GetOperation();
+
+  if (instr->IsBranch() || (op == opParam) || (op == opLabel)) return NULL;
+
+  const CTacName *dst = dynamic_cast<const CTacName*>(instr->GetDest());
+  if ((dst == NULL) || (dynamic_cast<const CTacReference*>(dst) != NULL))
+    return NULL;
+
+  return IsScalarVar(dst->GetSymbol()) ? dst->GetSymbol() : NULL;
+}
+
+void GetUsedSymbols(const CTacInstr *instr, vector<const CSymbol*> &used)
+{
+  EOperation op = instr->GetOperation();
+
+  for (int i=1; i<=2; i++) {
+    const CTacName *n = dynamic_cast<const CTacName*>(instr->GetSrc(i));
+
+    // the source of an opAddress is a storage location, not a value
+    if ((n == NULL) || (op == opCall)) continue;
+    if ((op == opAddress) && (dynamic_cast<const CTacReference*>(n) == NULL))
+      continue;
+
+    if (IsScalarVar(n->GetSymbol())) used.push_back(n->GetSymbol());
+  }
+
+  // a store through a reference reads the address
+  const CTacReference *r = dynamic_cast<const CTacReference*>(instr->GetDest());
+  if (r != NULL) used.push_back(r->GetSymbol());
+}
+
+bool ReadsMemory(const CTacInstr *instr)
+{
+  if (instr->GetOperation() == opAddress) return false;
+
+  return (dynamic_cast<const CTacReference*>(instr->GetSrc(1)) != NULL) ||
+         (dynamic_cast<const CTacReference*>(instr->GetSrc(2)) != NULL);
+}
+
+bool WritesMemory(const CTacInstr *instr)
+{
+  return dynamic_cast<const CTacReference*>(instr->GetDest()) != NULL;
+}
+
+const CSymProc* GetCallee(const CTacInstr *instr)
+{
+  assert(instr->GetOperation() == opCall);
+
+  const CTacName *n = dynamic_cast<const CTacName*>(instr->GetSrc(1));
+  assert(n != NULL);
+
+  return dynamic_cast<const CSymProc*>(n->GetSymbol());
+}
+
+bool GetParams(list<CTacInstr*>::const_iterator begin,
+               list<CTacInstr*>::const_iterator call,
+               vector<CTacInstr*> &params)
+{
+  const CSymProc *proc = GetCallee(*call);
+  int n = proc->GetNParams(), skip = 0;
+
+  params.assign(n, NULL);
+
+  list<CTacInstr*>::const_iterator it = call;
+  while ((n > 0) && (it != begin)) {
+    it--;
+    if ((*it)->GetOperation() == opCall) {
+      skip += GetCallee(*it)->GetNParams();
+    } else if ((*it)->GetOperation() == opParam) {
+      if (skip > 0) skip--;
+      else {
+        const CTacConst *p = dynamic_cast<const CTacConst*>((*it)->GetDest());
+        assert((p != NULL) && (p->GetValue() < proc->GetNParams()));
+        params[p->GetValue()] = *it;
+        n--;
+      }
+    }
+  }
+
+  return n == 0;
+}
+
+/// @brief return the integer variable @a a, or NULL
+static const CSymbol* GetIntVar(const CTacAddr *a)
+{
+  const CTacName *n = dynamic_cast<const CTacName*>(a);
+  if ((n == NULL) || (dynamic_cast<const CTacReference*>(n) != NULL)) return NULL;
+
+  const CSymbol *sym = n->GetSymbol();
+  return IsScalarVar(sym) && sym->GetDataType()->IsInt() ? sym : NULL;
+}
+
+bool GetIncrement(const CTacInstr *instr, const CSymbol *sym, int &c)
+{
+  EOperation op = instr->GetOperation();
+  const CTacConst *c1 = dynamic_cast<const CTacConst*>(instr->GetSrc(1));
+  const CTacConst *c2 = dynamic_cast<const CTacConst*>(instr->GetSrc(2));
+
+  if ((op == opAdd) && (c2 != NULL) && (GetIntVar(instr->GetSrc(1)) == sym)) {
+    c = c2->GetValue();
+  } else if ((op == opAdd) && (c1 != NULL) && (GetIntVar(instr->GetSrc(2)) == sym)) {
+    c = c1->GetValue();
+  } else if ((op == opSub) && (c2 != NULL) && (GetIntVar(instr->GetSrc(1)) == sym)) {
+    c = -c2->GetValue();
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+// CBasicBlock
+//
+CBasicBlock::CBasicBlock(CTacLabel *label)
+  : _id(-1), _label(label), _target(NULL), _fallthrough(NULL),
+    _idom(NULL), _loop(NULL)
+{
+}
+
+CBasicBlock::~CBasicBlock(void)
+{
+}
+
+int CBasicBlock::GetId(void) const
+{
+  return _id;
+}
+
+CTacLabel* CBasicBlock::GetLabel(void) const
+{
+  return _label;
+}
+
+list<CTacInstr*>& CBasicBlock::GetInstr(void)
+{
+  return _instr;
+}
+
+CTacInstr* CBasicBlock::GetTerminator(void) const
+{
+  if (_instr.empty()) return NULL;
+
+  CTacInstr *last = _instr.back();
+  if (IsRelOp(last->GetOperation()) || (last->GetOperation() == opReturn))
+    return last;
+
+  return NULL;
+}
+
+CBasicBlock* CBasicBlock::GetTarget(void) const
+{
+  return _target;
+}
+
+CBasicBlock* CBasicBlock::GetFallthrough(void) const
+{
+  return _fallthrough;
+}
+
+void CBasicBlock::SetFallthrough(CBasicBlock *bb)
+{
+  _fallthrough = bb;
+}
+
+const vector<CBasicBlock*>& CBasicBlock::GetSucc(void) const
+{
+  return _succ;
+}
+
+const vector<CBasicBlock*>& CBasicBlock::GetPred(void) const
+{
+  return _pred;
+}
+
+CBasicBlock* CBasicBlock::GetIDom(void) const
+{
+  return _idom;
+}
+
+CLoop* CBasicBlock::GetLoop(void) const
+{
+  return _loop;
+}
+
+int CBasicBlock::GetLoopDepth(void) const
+{
+  return _loop == NULL ? 0 : _loop->GetDepth();
+}
+
+ostream& CBasicBlock::print(ostream &out, int indent) const
+{
+  string ind(indent, ' ');
+
+  out << ind << "BB" << _id;
+  if (_label != NULL) out << " (" << _label->GetLabel() << ")";
+  out << "  depth " << GetLoopDepth() << "  pred:";
+  for (size_t i=0; i<_pred.size(); i++) out << " BB" << _pred[i]->GetId();
+  out << endl;
+
+  list<CTacInstr*>::const_iterator it = _instr.begin();
+  while (it != _instr.end()) {
+    (*it++)->print(out, indent+2);
+    out << endl;
+  }
+
+  out << ind << "  -> ";
+  if (_fallthrough != NULL) out << "BB" << _fallthrough->GetId();
+  else if ((GetTerminator() == NULL) ||
+           (GetTerminator()->GetOperation() != opReturn)) out << "exit";
+  out << endl;
+
+  return out;
+}
+
+
+//------------------------------------------------------------------------------
+// CLoop
+//
+CLoop::CLoop(CBasicBlock *header)
+  : _header(header), _parent(NULL), _depth(1), _latch(NULL), _iv(NULL),
+    _step(0), _cond(opNop), _bound(NULL), _init(NULL)
+{
+}
+
+CLoop::~CLoop(void)
+{
+}
+
+CBasicBlock* CLoop::GetHeader(void) const
+{
+  return _header;
+}
+
+const vector<CBasicBlock*>& CLoop::GetBlocks(void) const
+{
+  return _blocks;
+}
+
+bool CLoop::Contains(const CBasicBlock *bb) const
+{
+  return _member.find(bb) != _member.end();
+}
+
+CLoop* CLoop::GetParent(void) const
+{
+  return _parent;
+}
+
+int CLoop::GetDepth(void) const
+{
+  return _depth;
+}
+
+int CLoop::GetSize(void) const
+{
+  int size = 0;
+
+  for (size_t i=0; i<_blocks.size(); i++) size += _blocks[i]->GetInstr().size();
+
+  return size;
+}
+
+bool CLoop::Defines(const CSymbol *sym) const
+{
+  for (size_t i=0; i<_blocks.size(); i++) {
+    const list<CTacInstr*> &instr = _blocks[i]->GetInstr();
+    for (list<CTacInstr*>::const_iterator it=instr.begin(); it!=instr.end(); it++)
+      if (GetDefinedSymbol(*it) == sym) return true;
+  }
+
+  return false;
+}
+
+bool CLoop::CallsModify(const CSymbol *sym) const
+{
+  for (size_t i=0; i<_blocks.size(); i++) {
+    const list<CTacInstr*> &instr = _blocks[i]->GetInstr();
+    for (list<CTacInstr*>::const_iterator it=instr.begin(); it!=instr.end(); it++)
+      if (((*it)->GetOperation() == opCall) && GetCallee(*it)->MayModify(sym))
+        return true;
+  }
+
+  return false;
+}
+
+CBasicBlock* CLoop::GetLatch(void) const
+{
+  return _latch;
+}
+
+const CSymbol* CLoop::GetInductionVar(void) const
+{
+  return _iv;
+}
+
+int CLoop::GetStep(void) const
+{
+  return _step;
+}
+
+EOperation CLoop::GetCondition(void) const
+{
+  return _cond;
+}
+
+CTacAddr* CLoop::GetBound(void) const
+{
+  return _bound;
+}
+
+bool CLoop::GetInitial(int &init) const
+{
+  if ((_iv == NULL) || (_init == NULL)) return false;
+
+  init = _init->GetValue();
+  return true;
+}
+
+bool CLoop::GetTripCount(int &trip) const
+{
+  const CTacConst *bound = dynamic_cast<const CTacConst*>(_bound);
+  if ((_iv == NULL) || (_init == NULL) || (bound == NULL)) return false;
+
+  long long i = _init->GetValue(), b = bound->GetValue(), s = _step;
+  long long d, n;
+
+  // d: distance to the first value of i for which the condition fails
+  switch (_cond) {
+    case opLessThan:    if (s < 0) return false; d = b - i; break;
+    case opLessEqual:   if (s < 0) return false; d = b - i + 1; break;
+    case opBiggerThan:  if (s > 0) return false; d = i - b; s = -s; break;
+    case opBiggerEqual: if (s > 0) return false; d = i - b + 1; s = -s; break;
+    case opNotEqual:
+      if (((b - i) % s != 0) || ((b - i) / s < 1)) return false;
+      d = (b - i) / s; s = 1;
+      break;
+    default:
+      return false;
+  }
+
+  // the body is executed at least once
+  n = d > 0 ? (d + s - 1) / s : 1;
+
+  // the induction variable must not overflow
+  long long last = i + n*_step;
+  if ((n > INT_MAX) || (last < INT_MIN) || (last > INT_MAX)) return false;
+
+  trip = (int)n;
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+// CCfg
+//
+CCfg::CCfg(CCodeBlock *cb)
+  : _cb(cb)
+{
+  assert(cb != NULL);
+
+  // split the instruction list into basic blocks. Labels start a new block,
+  // conditional branches, gotos and returns end one.
+  CBasicBlock *bb = NULL;
+  bool open = false;
+
+  const list<CTacInstr*> &instr = cb->GetInstr();
+  list<CTacInstr*>::const_iterator it = instr.begin();
+
+  while (it != instr.end()) {
+    CTacInstr *i = *it++;
+    EOperation op = i->GetOperation();
+
+    if (op == opLabel) {
+      bb = new CBasicBlock(dynamic_cast<CTacLabel*>(i));
+      _blocks.push_back(bb);
+      open = true;
+      continue;
+    }
+
+    if (!open) {
+      bb = new CBasicBlock();
+      _blocks.push_back(bb);
+      open = true;
+    }
+
+    if (op == opGoto) {
+      // represented by the fall-through edge; the instruction is
+      // removed once the target block is known
+      bb->_instr.push_back(i);
+      open = false;
+    } else {
+      bb->_instr.push_back(i);
+      if (IsRelOp(op) || (op == opReturn)) open = false;
+    }
+  }
+
+  if (_blocks.empty()) _blocks.push_back(new CBasicBlock());
+
+  // resolve fall-through successors
+  map<CTacLabel*, CBasicBlock*> lbl2bb;
+  for (size_t b=0; b<_blocks.size(); b++) {
+    if (_blocks[b]->_label != NULL) lbl2bb[_blocks[b]->_label] = _blocks[b];
+  }
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    bb = _blocks[b];
+    CBasicBlock *next = b+1 < _blocks.size() ? _blocks[b+1] : NULL;
+    CTacInstr *last = bb->_instr.empty() ? NULL : bb->_instr.back();
+
+    if ((last != NULL) && (last->GetOperation() == opGoto)) {
+      bb->_fallthrough = lbl2bb[dynamic_cast<CTacLabel*>(last->GetDest())];
+      assert(bb->_fallthrough != NULL);
+      bb->_instr.pop_back();
+      delete last;
+    } else if ((last != NULL) && (last->GetOperation() == opReturn)) {
+      bb->_fallthrough = NULL;
+    } else {
+      bb->_fallthrough = next;
+    }
+  }
+
+  Update();
+}
+
+CCfg::~CCfg(void)
+{
+  for (size_t l=0; l<_loops.size(); l++) delete _loops[l];
+  for (size_t b=0; b<_blocks.size(); b++) delete _blocks[b];
+}
+
+CCodeBlock* CCfg::GetCodeBlock(void) const
+{
+  return _cb;
+}
+
+const vector<CBasicBlock*>& CCfg::GetBlocks(void) const
+{
+  return _blocks;
+}
+
+CBasicBlock* CCfg::GetEntry(void) const
+{
+  return _blocks[0];
+}
+
+const vector<CLoop*>& CCfg::GetLoops(void) const
+{
+  return _loops;
+}
+
+bool CCfg::Dominates(const CBasicBlock *a, const CBasicBlock *b) const
+{
+  while (b != NULL) {
+    if (a == b) return true;
+    b = b->_idom;
+  }
+
+  return false;
+}
+
+CBasicBlock* CCfg::CreateBlock(CBasicBlock *after)
+{
+  CBasicBlock *bb = new CBasicBlock();
+
+  vector<CBasicBlock*>::iterator pos = _blocks.end();
+  if (after != NULL) {
+    pos = find(_blocks.begin(), _blocks.end(), after);
+    assert(pos != _blocks.end());
+    pos++;
+  }
+  _blocks.insert(pos, bb);
+
+  return bb;
+}
+
+CBasicBlock* CCfg::CreateBlockBefore(CBasicBlock *before)
+{
+  CBasicBlock *bb = new CBasicBlock();
+
+  vector<CBasicBlock*>::iterator pos =
+    find(_blocks.begin(), _blocks.end(), before);
+  assert(pos != _blocks.end());
+  _blocks.insert(pos, bb);
+
+  return bb;
+}
+
+CTacLabel* CCfg::GetLabel(CBasicBlock *bb)
+{
+  if (bb->_label == NULL) bb->_label = _cb->CreateLabel();
+
+  return bb->_label;
+}
+
+void CCfg::Retarget(CBasicBlock *bb, CBasicBlock *from, CBasicBlock *to)
+{
+  if (bb->_target == from) {
+    CTacInstr *br = bb->GetTerminator();
+    assert((br != NULL) && IsRelOp(br->GetOperation()));
+    br->SetDest(GetLabel(to));
+    bb->_target = to;
+  }
+
+  if (bb->_fallthrough == from) bb->_fallthrough = to;
+}
+
+void CCfg::RemoveBranch(CBasicBlock *bb, CBasicBlock *succ)
+{
+  CTacInstr *br = bb->GetTerminator();
+  assert((br != NULL) && IsRelOp(br->GetOperation()));
+
+  bb->_instr.pop_back();
+  delete br;
+
+  bb->_target = NULL;
+  bb->_fallthrough = succ;
+}
+
+CBasicBlock* CCfg::GetPreheader(CLoop *l)
+{
+  CBasicBlock *header = l->GetHeader();
+  vector<CBasicBlock*> outside;
+
+  for (size_t p=0; p<header->_pred.size(); p++) {
+    if (!l->Contains(header->_pred[p])) outside.push_back(header->_pred[p]);
+  }
+
+  if ((outside.size() == 1) && (outside[0]->_succ.size() == 1)) {
+    return outside[0];
+  }
+
+  CBasicBlock *pre = CreateBlockBefore(header);
+  pre->_fallthrough = header;
+  for (size_t p=0; p<outside.size(); p++) Retarget(outside[p], header, pre);
+
+  Update();
+
+  return pre;
+}
+
+void CCfg::ComputeEdges(void)
+{
+  map<const CTacLabel*, CBasicBlock*> lbl2bb;
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    bb->_succ.clear();
+    bb->_pred.clear();
+    if (bb->_label != NULL) lbl2bb[bb->_label] = bb;
+  }
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    CTacInstr *term = bb->GetTerminator();
+
+    bb->_target = NULL;
+    if ((term != NULL) && IsRelOp(term->GetOperation())) {
+      bb->_target = lbl2bb[dynamic_cast<const CTacLabel*>(term->GetDest())];
+      assert(bb->_target != NULL);
+      bb->_succ.push_back(bb->_target);
+    }
+
+    if ((term != NULL) && (term->GetOperation() == opReturn)) {
+      bb->_fallthrough = NULL;
+    } else if ((bb->_fallthrough != NULL) && (bb->_fallthrough != bb->_target)) {
+      bb->_succ.push_back(bb->_fallthrough);
+    }
+  }
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    for (size_t s=0; s<bb->_succ.size(); s++) bb->_succ[s]->_pred.push_back(bb);
+  }
+}
+
+void CCfg::RemoveUnreachable(void)
+{
+  set<CBasicBlock*> reached;
+  vector<CBasicBlock*> work;
+
+  work.push_back(GetEntry());
+  reached.insert(GetEntry());
+  while (!work.empty()) {
+    CBasicBlock *bb = work.back();
+    work.pop_back();
+    for (size_t s=0; s<bb->_succ.size(); s++) {
+      if (reached.insert(bb->_succ[s]).second) work.push_back(bb->_succ[s]);
+    }
+  }
+
+  if (reached.size() == _blocks.size()) return;
+
+  // first delete the instructions (branches drop their label references),
+  // then the blocks and their labels
+  vector<CBasicBlock*> live;
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    if (reached.find(bb) != reached.end()) {
+      live.push_back(bb);
+    } else {
+      list<CTacInstr*>::iterator it = bb->_instr.begin();
+      while (it != bb->_instr.end()) delete *it++;
+      bb->_instr.clear();
+    }
+  }
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    if (reached.find(bb) == reached.end()) {
+      delete bb->_label;
+      delete bb;
+    }
+  }
+
+  _blocks = live;
+  ComputeEdges();
+}
+
+void CCfg::ComputeDominators(void)
+{
+  // Cooper, Harvey, Kennedy: "A Simple, Fast Dominance Algorithm"
+  vector<CBasicBlock*> rpo;
+  vector<int> order(_blocks.size(), -1);
+  vector<size_t> next(_blocks.size(), 0);
+  vector<CBasicBlock*> stack;
+  vector<bool> visited(_blocks.size(), false);
+
+  stack.push_back(GetEntry());
+  visited[GetEntry()->_id] = true;
+  while (!stack.empty()) {
+    CBasicBlock *bb = stack.back();
+    if (next[bb->_id] < bb->_succ.size()) {
+      CBasicBlock *s = bb->_succ[next[bb->_id]++];
+      if (!visited[s->_id]) {
+        visited[s->_id] = true;
+        stack.push_back(s);
+      }
+    } else {
+      rpo.push_back(bb);
+      stack.pop_back();
+    }
+  }
+  reverse(rpo.begin(), rpo.end());
+  for (size_t i=0; i<rpo.size(); i++) order[rpo[i]->_id] = i;
+
+  for (size_t b=0; b<_blocks.size(); b++) _blocks[b]->_idom = NULL;
+  GetEntry()->_idom = GetEntry();
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i=1; i<rpo.size(); i++) {
+      CBasicBlock *bb = rpo[i];
+      CBasicBlock *idom = NULL;
+
+      for (size_t p=0; p<bb->_pred.size(); p++) {
+        CBasicBlock *q = bb->_pred[p];
+        if (q->_idom == NULL) continue;
+        if (idom == NULL) { idom = q; continue; }
+
+        CBasicBlock *a = q, *b = idom;
+        while (a != b) {
+          while (order[a->_id] > order[b->_id]) a = a->_idom;
+          while (order[b->_id] > order[a->_id]) b = b->_idom;
+        }
+        idom = a;
+      }
+
+      if (bb->_idom != idom) {
+        bb->_idom = idom;
+        changed = true;
+      }
+    }
+  }
+
+  GetEntry()->_idom = NULL;
+}
+
+void CCfg::ComputeLoops(void)
+{
+  for (size_t l=0; l<_loops.size(); l++) delete _loops[l];
+  _loops.clear();
+
+  map<CBasicBlock*, CLoop*> header2loop;
+
+  // collect the natural loop of each back edge; back edges sharing the
+  // same header form a single loop
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *latch = _blocks[b];
+    latch->_loop = NULL;
+
+    for (size_t s=0; s<latch->_succ.size(); s++) {
+      CBasicBlock *header = latch->_succ[s];
+      if (!Dominates(header, latch)) continue;
+
+      CLoop *l = header2loop[header];
+      if (l == NULL) {
+        l = new CLoop(header);
+        l->_member.insert(header);
+        header2loop[header] = l;
+        _loops.push_back(l);
+      }
+
+      vector<CBasicBlock*> work;
+      if (l->_member.insert(latch).second) work.push_back(latch);
+      while (!work.empty()) {
+        CBasicBlock *bb = work.back();
+        work.pop_back();
+        for (size_t p=0; p<bb->_pred.size(); p++) {
+          if (l->_member.insert(bb->_pred[p]).second) work.push_back(bb->_pred[p]);
+        }
+      }
+    }
+  }
+
+  // blocks in layout order
+  for (size_t b=0; b<_blocks.size(); b++) {
+    for (size_t l=0; l<_loops.size(); l++) {
+      if (_loops[l]->Contains(_blocks[b])) _loops[l]->_blocks.push_back(_blocks[b]);
+    }
+  }
+
+  // nesting: the parent is the smallest loop that contains the header
+  for (size_t l=0; l<_loops.size(); l++) {
+    CLoop *loop = _loops[l];
+    for (size_t k=0; k<_loops.size(); k++) {
+      CLoop *outer = _loops[k];
+      if ((outer == loop) || !outer->Contains(loop->_header)) continue;
+      if ((loop->_parent == NULL) ||
+          (outer->_blocks.size() < loop->_parent->_blocks.size())) {
+        loop->_parent = outer;
+      }
+    }
+  }
+
+  for (size_t l=0; l<_loops.size(); l++) {
+    CLoop *loop = _loops[l];
+    loop->_depth = 1;
+    for (CLoop *p = loop->_parent; p != NULL; p = p->_parent) loop->_depth++;
+  }
+
+  // innermost loops first
+  stable_sort(_loops.begin(), _loops.end(),
+              [](const CLoop *a, const CLoop *b) { return a->_depth > b->_depth; });
+
+  // the innermost loop of each block is the first one containing it
+  for (size_t b=0; b<_blocks.size(); b++) {
+    for (size_t l=0; l<_loops.size(); l++) {
+      if (_loops[l]->Contains(_blocks[b])) {
+        _blocks[b]->_loop = _loops[l];
+        break;
+      }
+    }
+  }
+
+  for (size_t l=0; l<_loops.size(); l++) ComputeInduction(_loops[l]);
+}
+
+void CCfg::ComputeInduction(CLoop *l)
+{
+  l->_latch = NULL;
+  l->_iv = NULL;
+  l->_step = 0;
+  l->_cond = opNop;
+  l->_bound = NULL;
+  l->_init = NULL;
+
+  // the loop must be left through a single block
+  CBasicBlock *latch = NULL;
+  for (size_t b=0; b<l->_blocks.size(); b++) {
+    CBasicBlock *bb = l->_blocks[b];
+    CTacInstr *term = bb->GetTerminator();
+
+    if ((term != NULL) && (term->GetOperation() == opReturn)) return;
+    if ((bb->_fallthrough == NULL) && !l->Contains(bb->_target)) return;
+
+    for (size_t s=0; s<bb->_succ.size(); s++) {
+      if (l->Contains(bb->_succ[s])) continue;
+      if ((latch != NULL) && (latch != bb)) return;
+      latch = bb;
+    }
+  }
+
+  // ...whose conditional branch either continues with the header or
+  // leaves the loop
+  if (latch == NULL) return;
+
+  CTacInstr *br = latch->GetTerminator();
+  if ((br == NULL) || !IsRelOp(br->GetOperation())) return;
+
+  EOperation cond = br->GetOperation();
+  if (latch->_target == l->_header) {
+    if ((latch->_fallthrough != NULL) && l->Contains(latch->_fallthrough)) return;
+  } else if (latch->_fallthrough == l->_header) {
+    if (l->Contains(latch->_target)) return;
+    cond = InvertRelOp(cond);
+  } else {
+    return;
+  }
+
+  // the branch compares a variable modified in the loop with an invariant
+  CTacAddr *bound = br->GetSrc(2);
+  const CSymbol *iv = GetIntVar(br->GetSrc(1));
+  if ((iv == NULL) || !l->Defines(iv)) {
+    bound = br->GetSrc(1);
+    iv = GetIntVar(br->GetSrc(2));
+    cond = SwapRelOp(cond);
+  }
+  if ((iv == NULL) || !l->Defines(iv)) return;
+
+  if (dynamic_cast<const CTacConst*>(bound) == NULL) {
+    const CSymbol *b = GetIntVar(bound);
+    if ((b == NULL) || l->Defines(b)) return;
+    if ((b->GetSymbolType() == stGlobal) && l->CallsModify(b)) return;
+  }
+
+  // the variable is incremented by a constant exactly once per iteration.
+  // The increment is either computed in place or in a temporary right
+  // before it is assigned to the variable.
+  CBasicBlock *defbb = NULL;
+  list<CTacInstr*>::iterator def;
+  for (size_t b=0; b<l->_blocks.size(); b++) {
+    list<CTacInstr*> &instr = l->_blocks[b]->_instr;
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+      if (GetDefinedSymbol(*it) != iv) continue;
+      if (defbb != NULL) return;
+      defbb = l->_blocks[b];
+      def = it;
+    }
+  }
+
+  if ((defbb->_loop != l) || !Dominates(defbb, latch)) return;
+  if ((iv->GetSymbolType() == stGlobal) && l->CallsModify(iv)) return;
+
+  int step;
+  if (!GetIncrement(*def, iv, step)) {
+    const CSymbol *t = NULL;
+    if ((*def)->GetOperation() == opAssign) t = GetIntVar((*def)->GetSrc(1));
+    if ((t == NULL) || (def == defbb->_instr.begin())) return;
+
+    list<CTacInstr*>::iterator prev = def;
+    prev--;
+    if ((GetDefinedSymbol(*prev) != t) || !GetIncrement(*prev, iv, step)) return;
+  }
+  if (step == 0) return;
+
+  l->_latch = latch;
+  l->_iv = iv;
+  l->_step = step;
+  l->_cond = cond;
+  l->_bound = bound;
+
+  // the initial value is the last constant assigned to the variable on the
+  // straight-line path into the loop
+  CBasicBlock *pre = NULL;
+  for (size_t p=0; p<l->_header->_pred.size(); p++) {
+    if (l->Contains(l->_header->_pred[p])) continue;
+    if (pre != NULL) return;
+    pre = l->_header->_pred[p];
+  }
+
+  set<CBasicBlock*> visited;
+  while ((pre != NULL) && visited.insert(pre).second) {
+    list<CTacInstr*> &instr = pre->_instr;
+    for (list<CTacInstr*>::reverse_iterator it=instr.rbegin(); it!=instr.rend(); it++) {
+      if (((*it)->GetOperation() == opCall) &&
+          (iv->GetSymbolType() == stGlobal) &&
+          GetCallee(*it)->MayModify(iv)) return;
+      if (GetDefinedSymbol(*it) != iv) continue;
+
+      if ((*it)->GetOperation() == opAssign) {
+        l->_init = dynamic_cast<const CTacConst*>((*it)->GetSrc(1));
+      }
+      return;
+    }
+
+    pre = pre->_pred.size() == 1 ? pre->_pred[0] : NULL;
+  }
+}
+
+void CCfg::Update(void)
+{
+  for (size_t b=0; b<_blocks.size(); b++) _blocks[b]->_id = b;
+
+  ComputeEdges();
+  RemoveUnreachable();
+
+  for (size_t b=0; b<_blocks.size(); b++) _blocks[b]->_id = b;
+
+  ComputeDominators();
+  ComputeLoops();
+}
+
+void CCfg::RemoveEmptyBlocks(void)
+{
+  bool changed = true;
+
+  while (changed) {
+    changed = false;
+
+    for (size_t b=1; b<_blocks.size(); b++) {
+      CBasicBlock *bb = _blocks[b];
+      CBasicBlock *ft = bb->_fallthrough;
+
+      if (!bb->_instr.empty() || (ft == NULL) || (ft == bb)) continue;
+
+      vector<CBasicBlock*> pred(bb->_pred);
+      for (size_t p=0; p<pred.size(); p++) Retarget(pred[p], bb, ft);
+
+      ComputeEdges();
+      RemoveUnreachable();
+      changed = true;
+      break;
+    }
+  }
+}
+
+void CCfg::Commit(void)
+{
+  list<CTacInstr*> instr;
+
+  RemoveEmptyBlocks();
+
+  // fall-through successors that do not follow their predecessor in the
+  // layout are reached by a goto; they need a label before being emitted
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    CBasicBlock *next = b+1 < _blocks.size() ? _blocks[b+1] : NULL;
+
+    if ((bb->_fallthrough != NULL) && (bb->_fallthrough != next))
+      GetLabel(bb->_fallthrough);
+  }
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    CBasicBlock *bb = _blocks[b];
+    CBasicBlock *next = b+1 < _blocks.size() ? _blocks[b+1] : NULL;
+    CTacInstr *term = bb->GetTerminator();
+
+    if (bb->_label != NULL) instr.push_back(bb->_label);
+    instr.insert(instr.end(), bb->_instr.begin(), bb->_instr.end());
+
+    if ((term != NULL) && (term->GetOperation() == opReturn)) continue;
+
+    if (bb->_fallthrough != next) {
+      if (bb->_fallthrough == NULL) {
+        instr.push_back(new CTacInstr(opReturn, NULL));
+      } else {
+        instr.push_back(new CTacInstr(opGoto, GetLabel(bb->_fallthrough)));
+      }
+    }
+  }
+
+  _cb->SetInstr(instr);
+  _cb->CleanupControlFlow();
+
+  for (size_t b=0; b<_blocks.size(); b++) {
+    _blocks[b]->_label = NULL;
+    _blocks[b]->_instr.clear();
+  }
+}
+
+ostream& CCfg::print(ostream &out, int indent) const
+{
+  string ind(indent, ' ');
+
+  out << ind << "[[ CFG " << _cb->GetName() << endl;
+  for (size_t b=0; b<_blocks.size(); b++) _blocks[b]->print(out, indent+2);
+  for (size_t l=0; l<_loops.size(); l++) {
+    CLoop *loop = _loops[l];
+    out << ind << "  loop BB" << loop->GetHeader()->GetId()
+        << " depth " << loop->GetDepth() << ":";
+    for (size_t b=0; b<loop->GetBlocks().size(); b++)
+      out << " BB" << loop->GetBlocks()[b]->GetId();
+    out << endl;
+
+    if (loop->GetInductionVar() != NULL) {
+      int init, trip;
+      out << ind << "    " << loop->GetInductionVar()->GetName()
+          << " += " << loop->GetStep() << " while "
+          << loop->GetInductionVar()->GetName() << " " << loop->GetCondition()
+          << " " << loop->GetBound();
+      if (loop->GetInitial(init)) out << ", initially " << init;
+      if (loop->GetTripCount(trip)) out << ", " << trip << " iterations";
+      out << endl;
+    }
+  }
+  out << ind << "]]" << endl;
+
+  return out;
+}
+
+ostream& operator<<(ostream &out, const CCfg &t)
+{
+  return t.print(out);
+}
+
+ostream& operator<<(ostream &out, const CCfg *t)
+{
+  return t->print(out);
+}
+
+
+//------------------------------------------------------------------------------
+// CCallGraph
+//
+CCallGraph::CCallGraph(CModule *m)
+  : _module(m)
+{
+  assert(m != NULL);
+
+  vector<CScope*> work(m->GetSubscopes());
+  while (!work.empty()) {
+    CScope *s = work.back();
+    work.pop_back();
+
+    _scope[s->GetDeclaration()] = s;
+    work.insert(work.end(), s->GetSubscopes().begin(), s->GetSubscopes().end());
+  }
+
+  Visit(m);
+}
+
+CCallGraph::~CCallGraph(void)
+{
+}
+
+void CCallGraph::Visit(CScope *s)
+{
+  vector<CScope*> &callees = _callees[s];
+
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    if ((*it)->GetOperation() != opCall) continue;
+
+    CScope *callee = GetScope(GetCallee(*it));
+    if ((callee == NULL) ||
+        (find(callees.begin(), callees.end(), callee) != callees.end()))
+      continue;
+
+    callees.push_back(callee);
+    _callers[callee].push_back(s);
+    if (_callees.find(callee) == _callees.end()) Visit(callee);
+  }
+
+  _scopes.push_back(s);
+}
+
+const vector<CScope*>& CCallGraph::GetScopes(void) const
+{
+  return _scopes;
+}
+
+bool CCallGraph::IsReachable(const CScope *s) const
+{
+  return _callees.find(s) != _callees.end();
+}
+
+CScope* CCallGraph::GetScope(const CSymProc *proc) const
+{
+  map<const CSymbol*, CScope*>::const_iterator it = _scope.find(proc);
+
+  return it != _scope.end() ? it->second : NULL;
+}
+
+const vector<CScope*>& CCallGraph::GetCallees(const CScope *s) const
+{
+  static const vector<CScope*> none;
+  map<const CScope*, vector<CScope*> >::const_iterator it = _callees.find(s);
+
+  return it != _callees.end() ? it->second : none;
+}
+
+const vector<CScope*>& CCallGraph::GetCallers(const CScope *s) const
+{
+  static const vector<CScope*> none;
+  map<const CScope*, vector<CScope*> >::const_iterator it = _callers.find(s);
+
+  return it != _callers.end() ? it->second : none;
+}
+
+ostream& CCallGraph::print(ostream &out, int indent) const
+{
+  string ind(indent, ' ');
+
+  out << ind << "[[ call graph" << endl;
+  for (size_t i=0; i<_scopes.size(); i++) {
+    const vector<CScope*> &callees = GetCallees(_scopes[i]);
+
+    out << ind << "  " << _scopes[i]->GetName() << " ->";
+    for (size_t c=0; c<callees.size(); c++) out << " " << callees[c]->GetName();
+    out << endl;
+  }
+  out << ind << "]]" << endl;
+
+  return out;
+}
+
+ostream& operator<<(ostream &out, const CCallGraph &t)
+{
+  return t.print(out);
+}
+
+ostream& operator<<(ostream &out, const CCallGraph *t)
+{
+  return t->print(out);
+}
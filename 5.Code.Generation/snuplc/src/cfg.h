@@ -0,0 +1,490 @@
+//------------------------------------------------------------------------------
+/// @brief SnuPL control flow graph
+/// @section changelog Change Log
+/// 2026/10/19 created
+///
+/// @section license_section License
+/// Copyright (c) 2012-2016 Bernhard Egger
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms,  with or without modifi-
+/// cation, are permitted provided that the following conditions are met:
+///
+/// - Redistributions of source code must retain the above copyright notice,
+///   this list of conditions and the following disclaimer.
+/// - Redistributions in binary form must reproduce the above copyright notice,
+///   this list of conditions and the following disclaimer in the documentation
+///   and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY  AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER  OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT,  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+/// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF  SUBSTITUTE
+/// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+/// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN  CONTRACT, STRICT
+/// LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY
+/// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+/// DAMAGE.
+//------------------------------------------------------------------------------
+
+#ifndef __SnuPL_CFG_H__
+#define __SnuPL_CFG_H__
+
+#include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "ir.h"
+
+
+//------------------------------------------------------------------------------
+/// @name TAC operand queries
+/// @{
+
+/// @brief returns true if @a sym is a scalar variable (local, parameter,
+///        temporary or global) that can only be modified by assignment
+bool IsScalarVar(const CSymbol *sym);
+
+/// @brief return the scalar variable defined by @a instr, or NULL if the
+///        instruction does not define a variable
+///
+/// Stores through a CTacReference do not define a variable.
+const CSymbol* GetDefinedSymbol(const CTacInstr *instr);
+
+/// @brief collect the scalar variables read by @a instr in @a used
+///
+/// This includes the symbols holding the address of CTacReferences.
+void GetUsedSymbols(const CTacInstr *instr, vector<const CSymbol*> &used);
+
+/// @brief returns true if @a instr reads memory through a reference
+bool ReadsMemory(const CTacInstr *instr);
+
+/// @brief returns true if @a instr writes memory through a reference
+bool WritesMemory(const CTacInstr *instr);
+
+/// @brief return the called procedure of the opCall @a instr
+const CSymProc* GetCallee(const CTacInstr *instr);
+
+/// @brief collect the opParam instructions passing the arguments of the
+///        opCall @a call in @a params (indexed by parameter number)
+///
+/// The arguments are passed in front of the call; the parameters of calls
+/// evaluating an argument are skipped.
+/// @param begin first instruction that is searched
+/// @retval false if not all parameters are found between @a begin and
+///         @a call
+bool GetParams(list<CTacInstr*>::const_iterator begin,
+               list<CTacInstr*>::const_iterator call,
+               vector<CTacInstr*> &params);
+
+/// @brief returns true if @a instr computes @a sym + @a c for a constant c
+bool GetIncrement(const CTacInstr *instr, const CSymbol *sym, int &c);
+
+/// @}
+
+
+class CLoop;
+
+//------------------------------------------------------------------------------
+/// @brief basic block
+///
+/// A basic block holds a sequence of non-branching instructions optionally
+/// terminated by a conditional branch or a return. Unconditional branches
+/// are not stored explicitly; they are represented by the fall-through
+/// successor and materialized by CCfg::Commit() when necessary.
+///
+class CBasicBlock {
+  friend class CCfg;
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    /// @brief constructor
+    /// @param label label at the beginning of this block (may be NULL)
+    CBasicBlock(CTacLabel *label=NULL);
+
+    /// @brief destructor
+    virtual ~CBasicBlock(void);
+
+    /// @}
+
+
+    /// @name properties
+    /// @{
+
+    /// @brief return the block id (its position in the layout)
+    int GetId(void) const;
+
+    /// @brief return the label of this block or NULL if it has none
+    CTacLabel* GetLabel(void) const;
+
+    /// @brief return (a reference to) the list of instructions
+    list<CTacInstr*>& GetInstr(void);
+
+    /// @brief return the conditional branch or return instruction that
+    ///        terminates this block, or NULL
+    CTacInstr* GetTerminator(void) const;
+
+    /// @brief return the target block of the conditional branch
+    CBasicBlock* GetTarget(void) const;
+
+    /// @brief return the fall-through successor (NULL: procedure exit)
+    CBasicBlock* GetFallthrough(void) const;
+
+    /// @brief set the fall-through successor to @a bb
+    void SetFallthrough(CBasicBlock *bb);
+
+    /// @brief return the list of successors
+    const vector<CBasicBlock*>& GetSucc(void) const;
+
+    /// @brief return the list of predecessors
+    const vector<CBasicBlock*>& GetPred(void) const;
+
+    /// @brief return the immediate dominator (NULL for the entry block)
+    CBasicBlock* GetIDom(void) const;
+
+    /// @brief return the innermost loop containing this block, or NULL
+    CLoop* GetLoop(void) const;
+
+    /// @brief return the loop nesting depth of this block
+    int GetLoopDepth(void) const;
+
+    /// @}
+
+    /// @brief print the block to an output stream
+    /// @param out output stream
+    /// @param indent indentation
+    virtual ostream& print(ostream &out, int indent=0) const;
+
+  protected:
+    int _id;                         ///< block id
+    CTacLabel *_label;               ///< leading label
+    list<CTacInstr*> _instr;         ///< instructions
+    CBasicBlock *_target;            ///< target of the conditional branch
+    CBasicBlock *_fallthrough;       ///< fall-through successor
+    vector<CBasicBlock*> _succ;      ///< successors
+    vector<CBasicBlock*> _pred;      ///< predecessors
+    CBasicBlock *_idom;              ///< immediate dominator
+    CLoop *_loop;                    ///< innermost loop
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief natural loop
+///
+class CLoop {
+  friend class CCfg;
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    /// @brief constructor
+    /// @param header loop header
+    CLoop(CBasicBlock *header);
+
+    /// @brief destructor
+    virtual ~CLoop(void);
+
+    /// @}
+
+
+    /// @name properties
+    /// @{
+
+    /// @brief return the loop header
+    CBasicBlock* GetHeader(void) const;
+
+    /// @brief return the blocks of the loop (in layout order)
+    const vector<CBasicBlock*>& GetBlocks(void) const;
+
+    /// @brief returns true if @a bb belongs to this loop
+    bool Contains(const CBasicBlock *bb) const;
+
+    /// @brief return the enclosing loop, or NULL
+    CLoop* GetParent(void) const;
+
+    /// @brief return the loop nesting depth (outermost loops: 1)
+    int GetDepth(void) const;
+
+    /// @brief return the number of instructions in the loop
+    int GetSize(void) const;
+
+    /// @brief returns true if @a sym is assigned inside the loop
+    bool Defines(const CSymbol *sym) const;
+
+    /// @brief returns true if the loop calls a procedure that may modify
+    ///        the global variable @a sym
+    bool CallsModify(const CSymbol *sym) const;
+
+    /// @}
+
+
+    /// @name induction variable and trip count
+    ///
+    /// A loop is countable if it is left only by the conditional branch
+    /// terminating its latch, and the branch compares a basic induction
+    /// variable i (incremented by a constant step exactly once in every
+    /// iteration) against a loop-invariant bound. The loop continues while
+    /// 'i <cond> bound' holds for the incremented value of i.
+    ///
+    /// @{
+
+    /// @brief return the block containing the back edge and the exit
+    ///        branch of a countable loop, or NULL
+    CBasicBlock* GetLatch(void) const;
+
+    /// @brief return the induction variable, or NULL if the loop is not
+    ///        countable
+    const CSymbol* GetInductionVar(void) const;
+
+    /// @brief return the step of the induction variable
+    int GetStep(void) const;
+
+    /// @brief return the condition under which the loop continues
+    EOperation GetCondition(void) const;
+
+    /// @brief return the bound of the induction variable
+    CTacAddr* GetBound(void) const;
+
+    /// @brief return the constant initial value of the induction variable
+    /// @retval true if the initial value is known
+    bool GetInitial(int &init) const;
+
+    /// @brief return the number of times the body is executed once the
+    ///        loop has been entered
+    /// @retval true if the trip count is a compile-time constant
+    bool GetTripCount(int &trip) const;
+
+    /// @}
+
+  protected:
+    CBasicBlock *_header;            ///< header
+    vector<CBasicBlock*> _blocks;    ///< member blocks
+    set<const CBasicBlock*> _member; ///< member blocks (for lookup)
+    CLoop *_parent;                  ///< enclosing loop
+    int _depth;                      ///< nesting depth
+
+    CBasicBlock *_latch;             ///< latch (countable loops)
+    const CSymbol *_iv;              ///< induction variable
+    int _step;                       ///< step of the induction variable
+    EOperation _cond;                ///< loop condition
+    CTacAddr *_bound;                ///< bound of the induction variable
+    const CTacConst *_init;          ///< initial value (NULL: unknown)
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief control flow graph
+///
+/// The control flow graph of a code block. Analyses (edges, dominators,
+/// loops) are recomputed by Update(); all changes are written back to the
+/// code block by Commit().
+///
+class CCfg {
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    /// @brief constructor
+    /// @param cb code block
+    CCfg(CCodeBlock *cb);
+
+    /// @brief destructor
+    virtual ~CCfg(void);
+
+    /// @}
+
+
+    /// @name properties
+    /// @{
+
+    /// @brief return the code block
+    CCodeBlock* GetCodeBlock(void) const;
+
+    /// @brief return the blocks in layout order
+    const vector<CBasicBlock*>& GetBlocks(void) const;
+
+    /// @brief return the entry block
+    CBasicBlock* GetEntry(void) const;
+
+    /// @brief return the loops, innermost loops first
+    const vector<CLoop*>& GetLoops(void) const;
+
+    /// @brief returns true if @a a dominates @a b
+    bool Dominates(const CBasicBlock *a, const CBasicBlock *b) const;
+
+    /// @}
+
+
+    /// @name modification
+    /// @{
+
+    /// @brief create a new, empty block and insert it into the layout
+    ///        after @a after (at the end if NULL)
+    CBasicBlock* CreateBlock(CBasicBlock *after=NULL);
+
+    /// @brief create a new, empty block and insert it into the layout
+    ///        before @a before
+    CBasicBlock* CreateBlockBefore(CBasicBlock *before);
+
+    /// @brief return the label of @a bb; creates one if necessary
+    CTacLabel* GetLabel(CBasicBlock *bb);
+
+    /// @brief let the edge @a bb -> @a from point to @a to instead
+    void Retarget(CBasicBlock *bb, CBasicBlock *from, CBasicBlock *to);
+
+    /// @brief remove the terminating conditional branch of @a bb; control
+    ///        continues at @a succ
+    void RemoveBranch(CBasicBlock *bb, CBasicBlock *succ);
+
+    /// @brief return a preheader of loop @a l
+    ///
+    /// The preheader is the only predecessor of the loop header outside of
+    /// the loop; it is not terminated by a branch. A new block is created
+    /// if necessary, in which case the analyses are updated.
+    CBasicBlock* GetPreheader(CLoop *l);
+
+    /// @brief recompute edges, remove unreachable blocks, and recompute
+    ///        dominators and loops
+    void Update(void);
+
+    /// @brief write the instructions back to the code block
+    ///
+    /// The control flow graph must not be used after Commit().
+    void Commit(void);
+
+    /// @}
+
+    /// @brief print the control flow graph to an output stream
+    /// @param out output stream
+    /// @param indent indentation
+    virtual ostream& print(ostream &out, int indent=0) const;
+
+  protected:
+    /// @brief compute successor and predecessor edges
+    void ComputeEdges(void);
+
+    /// @brief remove blocks not reachable from the entry block
+    void RemoveUnreachable(void);
+
+    /// @brief compute the dominator tree
+    void ComputeDominators(void);
+
+    /// @brief find the natural loops
+    void ComputeLoops(void);
+
+    /// @brief find the induction variable and the bounds of loop @a l
+    void ComputeInduction(CLoop *l);
+
+    /// @brief redirect the predecessors of empty blocks to their successor
+    void RemoveEmptyBlocks(void);
+
+    CCodeBlock *_cb;                 ///< code block
+    vector<CBasicBlock*> _blocks;    ///< blocks in layout order
+    vector<CLoop*> _loops;           ///< loops, innermost first
+};
+
+/// @name CCfg output operators
+/// @{
+
+/// @brief CCfg output operator
+///
+/// @param out output stream
+/// @param t reference to CCfg
+/// @retval output stream
+ostream& operator<<(ostream &out, const CCfg &t);
+
+/// @brief CCfg output operator
+///
+/// @param out output stream
+/// @param t reference to CCfg
+/// @retval output stream
+ostream& operator<<(ostream &out, const CCfg *t);
+
+/// @}
+
+
+//------------------------------------------------------------------------------
+/// @brief call graph
+///
+/// The procedures reachable from the module body through opCall
+/// instructions. Calls to the runtime library are not part of the graph.
+///
+class CCallGraph {
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    /// @brief constructor
+    /// @param m module
+    CCallGraph(CModule *m);
+
+    /// @brief destructor
+    virtual ~CCallGraph(void);
+
+    /// @}
+
+
+    /// @name properties
+    /// @{
+
+    /// @brief return the reachable scopes, callees before their callers
+    ///        (except in cycles); the module is last
+    const vector<CScope*>& GetScopes(void) const;
+
+    /// @brief returns true if @a s is reachable from the module body
+    bool IsReachable(const CScope *s) const;
+
+    /// @brief return the scope implementing @a proc, or NULL if @a proc is
+    ///        a runtime library function
+    CScope* GetScope(const CSymProc *proc) const;
+
+    /// @brief return the procedures called by @a s
+    const vector<CScope*>& GetCallees(const CScope *s) const;
+
+    /// @brief return the reachable procedures calling @a s
+    const vector<CScope*>& GetCallers(const CScope *s) const;
+
+    /// @}
+
+    /// @brief print the call graph to an output stream
+    /// @param out output stream
+    /// @param indent indentation
+    virtual ostream& print(ostream &out, int indent=0) const;
+
+  protected:
+    /// @brief add @a s and its callees to the graph (depth-first)
+    void Visit(CScope *s);
+
+    CModule *_module;                ///< module
+    vector<CScope*> _scopes;         ///< reachable scopes in post order
+    map<const CSymbol*, CScope*> _scope; ///< scopes of procedures
+    map<const CScope*, vector<CScope*> > _callees; ///< called procedures
+    map<const CScope*, vector<CScope*> > _callers; ///< calling procedures
+};
+
+/// @name CCallGraph output operators
+/// @{
+
+/// @brief CCallGraph output operator
+///
+/// @param out output stream
+/// @param t reference to CCallGraph
+/// @retval output stream
+ostream& operator<<(ostream &out, const CCallGraph &t);
+
+/// @brief CCallGraph output operator
+///
+/// @param out output stream
+/// @param t reference to CCallGraph
+/// @retval output stream
+ostream& operator<<(ostream &out, const CCallGraph *t);
+
+/// @}
+
+
+#endif // __SnuPL_CFG_H__
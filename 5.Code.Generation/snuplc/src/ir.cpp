@@ -34,7 +34,9 @@
 /// DAMAGE.
 //------------------------------------------------------------------------------
 
+#include <algorithm>
 #include <iomanip>
+#include <map>
 #include <cassert>
 
 #include "ir.h"
@@ -54,6 +56,7 @@ char EOperationName[][OPERATION_STRLEN] = {
   "sub",                            ///< -  subtraction
   "mul",                            ///< *  multiplication
   "div",                            ///< /  division
+  "udiv",                           ///< /  division of non-negative values
   "and",                            ///< && binary and
   "or",                             ///< || binary or
 
@@ -90,6 +93,10 @@ char EOperationName[][OPERATION_STRLEN] = {
   "return",                         ///< return: return optional src1
   "param",                          ///< parameter: dst = index, src1 = parameter
 
+  // runtime checks
+  // trap unless 0 <= src1 < src2
+  "check",                          ///< array bounds check
+
   // special
   "label",                          ///< jump label; no arguments
   "nop",                            ///< no operation
@@ -105,6 +112,42 @@ bool IsRelOp(EOperation t)
          (t == opBiggerEqual);
 }
 
+EOperation InvertRelOp(EOperation t)
+{
+  switch (t) {
+    case opEqual:       return opNotEqual;
+    case opNotEqual:    return opEqual;
+    case opLessThan:    return opBiggerEqual;
+    case opLessEqual:   return opBiggerThan;
+    case opBiggerThan:  return opLessEqual;
+    case opBiggerEqual: return opLessThan;
+    default:            assert(false); break;
+  }
+  return t;
+}
+
+EOperation SwapRelOp(EOperation t)
+{
+  switch (t) {
+    case opEqual:       return opEqual;
+    case opNotEqual:    return opNotEqual;
+    case opLessThan:    return opBiggerThan;
+    case opLessEqual:   return opBiggerEqual;
+    case opBiggerThan:  return opLessThan;
+    case opBiggerEqual: return opLessEqual;
+    default:            assert(false); break;
+  }
+  return t;
+}
+
+bool IsCommutative(EOperation t)
+{
+  return (t == opAdd) ||
+         (t == opMul) ||
+         (t == opAnd) ||
+         (t == opOr);
+}
+
 ostream& operator<<(ostream &out, EOperation t)
 {
   out << EOperationName[t];
@@ -289,11 +332,53 @@ CTac* CTacInstr::GetDest(void) const
   return _dst;
 }
 
+void CTacInstr::SetOperation(EOperation op)
+{
+  bool was_branch = IsBranch();
+
+  _op = op;
+
+  if (was_branch != IsBranch()) {
+    CTacLabel *lbl = dynamic_cast<CTacLabel*>(_dst);
+    assert(lbl != NULL);
+    lbl->AddReference(was_branch ? -1 : 1);
+  }
+}
+
+void CTacInstr::SetSrc(int index, CTacAddr *src)
+{
+  switch (index) {
+    case 1: _src1 = src; break;
+    case 2: _src2 = src; break;
+    default: assert(false);
+  }
+}
+
 void CTacInstr::SetDest(CTac* dst)
 {
+  if (IsBranch()) {
+    CTacLabel *lbl = dynamic_cast<CTacLabel*>(_dst);
+    assert(lbl != NULL);
+    lbl->AddReference(-1);
+
+    lbl = dynamic_cast<CTacLabel*>(dst);
+    assert(lbl != NULL);
+    lbl->AddReference(1);
+  }
+
   _dst = dst;
 }
 
+CTacInstr* CTacInstr::Clone(void) const
+{
+  assert(_op != opLabel);
+
+  CTacInstr *i = new CTacInstr(_op, _dst, _src1, _src2);
+  i->_name = _name;
+
+  return i;
+}
+
 ostream& CTacInstr::print(ostream &out, int indent) const
 {
   string ind(indent, ' ');
@@ -375,8 +460,9 @@ ostream& CTacLabel::print(ostream &out, int indent) const
 //------------------------------------------------------------------------------
 // CScope
 //
-CScope::CScope(CAstNode *ast, CScope *parent)
-  : _ast(ast), _parent(parent), _temp_id(0), _label_id(0)
+CScope::CScope(CAstNode *ast, CScope *parent, bool bounds_check)
+  : _ast(ast), _parent(parent), _bounds_check(bounds_check), _temp_id(0),
+    _label_id(0)
 {
   CAstScope *s = dynamic_cast<CAstScope*>(ast);
   assert(s != NULL);
@@ -392,6 +478,81 @@ CScope::CScope(CAstNode *ast, CScope *parent)
   }
 }
 
+/// @brief return operand @a a with the symbols in @a sym replaced
+static CTacAddr* Remap(CTacAddr *a, const map<const CSymbol*, CSymbol*> &sym)
+{
+  CTacName *n = dynamic_cast<CTacName*>(a);
+  if (n == NULL) return a;
+
+  map<const CSymbol*, CSymbol*>::const_iterator s = sym.find(n->GetSymbol());
+  const CSymbol *symbol = s != sym.end() ? s->second : n->GetSymbol();
+
+  CTacReference *r = dynamic_cast<CTacReference*>(n);
+  if (r != NULL) {
+    map<const CSymbol*, CSymbol*>::const_iterator d =
+      sym.find(r->GetDerefSymbol());
+    return new CTacReference(symbol,
+                             d != sym.end() ? d->second : r->GetDerefSymbol());
+  }
+
+  if (s == sym.end()) return a;
+  if (dynamic_cast<CTacTemp*>(n) != NULL) return new CTacTemp(symbol);
+  return new CTacName(symbol);
+}
+
+CScope::CScope(const CScope *scope, const string name)
+  : _ast(scope->_ast), _name(name), _parent(scope->_parent),
+    _bounds_check(scope->_bounds_check), _temp_id(scope->_temp_id),
+    _label_id(scope->_label_id)
+{
+  assert(_parent != NULL);
+
+  // copy the local symbols
+  map<const CSymbol*, CSymbol*> sym;
+  _symtab = new CSymtab(_parent->GetSymbolTable());
+
+  vector<CSymbol*> symbols = scope->GetSymbolTable()->GetSymbols();
+  for (size_t i=0; i<symbols.size(); i++) {
+    CSymbol *s = symbols[i];
+    CSymParam *p = dynamic_cast<CSymParam*>(s);
+
+    if (p != NULL) {
+      sym[s] = new CSymParam(p->GetIndex(), p->GetName(), p->GetDataType());
+    } else {
+      assert(s->GetSymbolType() == stLocal);
+      sym[s] = new CSymLocal(s->GetName(), s->GetDataType());
+    }
+    _symtab->AddSymbol(sym[s]);
+  }
+
+  // copy the code
+  const list<CTacInstr*> &instr = scope->GetCodeBlock()->GetInstr();
+  map<const CTac*, CTacLabel*> label;
+  list<CTacInstr*>::const_iterator it;
+
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    CTacLabel *l = dynamic_cast<CTacLabel*>(*it);
+    if (l != NULL) label[l] = new CTacLabel(l->GetLabel());
+  }
+
+  _cb = new CCodeBlock(this);
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    if ((*it)->GetOperation() == opLabel) {
+      _cb->AddInstr(label[*it]);
+      continue;
+    }
+
+    CTacInstr *i = (*it)->Clone();
+    if (i->IsBranch()) i->SetDest(label[i->GetDest()]);
+    else i->SetDest(Remap(dynamic_cast<CTacAddr*>(i->GetDest()), sym));
+    for (int s=1; s<=2; s++) i->SetSrc(s, Remap(i->GetSrc(s), sym));
+
+    _cb->AddInstr(i);
+  }
+
+  _parent->_children.push_back(this);
+}
+
 CScope::~CScope(void)
 {
   delete _cb;
@@ -412,11 +573,24 @@ const vector<CScope*>& CScope::GetSubscopes(void) const
   return _children;
 }
 
+void CScope::RemoveSubscope(CScope *s)
+{
+  vector<CScope*>::iterator it = find(_children.begin(), _children.end(), s);
+  assert(it != _children.end());
+
+  _children.erase(it);
+}
+
 CSymtab* CScope::GetSymbolTable(void) const
 {
   return _symtab;
 }
 
+bool CScope::GetBoundsCheck(void) const
+{
+  return _bounds_check;
+}
+
 CCodeBlock* CScope::GetCodeBlock(void) const
 {
   return _cb;
@@ -479,8 +653,8 @@ ostream& operator<<(ostream &out, const CScope *t)
 //------------------------------------------------------------------------------
 // CModule
 //
-CModule::CModule(CAstNode *ast)
-  : CScope(ast, NULL)
+CModule::CModule(CAstNode *ast, bool bounds_check)
+  : CScope(ast, NULL, bounds_check)
 {
 }
 
@@ -516,8 +690,28 @@ ostream& CModule::print(ostream &out, int indent) const
 // CProcedure
 //
 CProcedure::CProcedure(CAstNode *ast, CScope *parent)
-  : CScope(ast, parent)
+  : CScope(ast, parent, parent->GetBoundsCheck())
 {
+  CAstProcedure *s = dynamic_cast<CAstProcedure*>(_ast);
+  assert(s != NULL);
+
+  _decl = s->GetSymbol();
+}
+
+CProcedure::CProcedure(const CProcedure *proc, const string name)
+  : CScope(proc, name)
+{
+  const CSymProc *orig = proc->_decl;
+
+  _decl = new CSymProc(name, orig->GetDataType());
+  for (int i=0; i<orig->GetNParams(); i++) {
+    const CSymbol *p =
+      GetSymbolTable()->FindSymbol(orig->GetParam(i)->GetName(), sLocal);
+    _decl->AddParam(dynamic_cast<CSymParam*>(const_cast<CSymbol*>(p)));
+  }
+  _decl->SetPure(orig->IsPure());
+  _decl->SetConst(orig->IsConst());
+  _parent->GetSymbolTable()->AddSymbol(_decl);
 }
 
 CProcedure::~CProcedure(void)
@@ -526,10 +720,7 @@ CProcedure::~CProcedure(void)
 
 CSymbol* CProcedure::GetDeclaration(void) const
 {
-  CAstProcedure *s = dynamic_cast<CAstProcedure*>(_ast);
-  assert(s != NULL);
-
-  return s->GetSymbol();
+  return _decl;
 }
 
 ostream& CProcedure::print(ostream &out, int indent) const
@@ -597,6 +788,15 @@ const list<CTacInstr*>& CCodeBlock::GetInstr(void) const
   return _ops;
 }
 
+void CCodeBlock::SetInstr(const list<CTacInstr*> &instr)
+{
+  _ops = instr;
+
+  _inst_id = 0;
+  list<CTacInstr*>::iterator it = _ops.begin();
+  while (it != _ops.end()) (*it++)->SetId(_inst_id++);
+}
+
 void CCodeBlock::CleanupControlFlow(void)
 {
   list<CTacInstr*>::iterator it = _ops.begin();
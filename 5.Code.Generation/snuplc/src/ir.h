@@ -54,6 +54,7 @@ enum EOperation {
   opSub,                            ///< -  subtraction
   opMul,                            ///< *  multiplication
   opDiv,                            ///< /  division
+  opUDiv,                           ///< /  unsigned division
   opAnd,                            ///< && binary and
   opOr,                             ///< || binary or
 
@@ -90,6 +91,10 @@ enum EOperation {
   opReturn,                         ///< return: return optional src1
   opParam,                          ///< parameter: dst = index,src1 = parameter
 
+  // runtime checks
+  // trap unless 0 <= src1 < src2
+  opCheck,                          ///< array bounds check
+
   // special
   opLabel,                          ///< jump label; no arguments
   opNop,                            ///< no operation
@@ -98,6 +103,16 @@ enum EOperation {
 /// @brief returns true if @a op is a relational operation
 bool IsRelOp(EOperation t);
 
+/// @brief return the relational operation that is true iff @a t is false
+EOperation InvertRelOp(EOperation t);
+
+/// @brief return the relational operation to use when the operands of
+///        @a t are swapped
+EOperation SwapRelOp(EOperation t);
+
+/// @brief returns true if the binary operation @a t is commutative
+bool IsCommutative(EOperation t);
+
 /// @brief EOperation output operator
 ///
 /// @param out output stream
@@ -359,6 +374,32 @@ class CTacInstr : public CTac {
 
     /// @}
 
+    /// @name modification
+    /// @{
+
+    /// @brief change the operation to @a op
+    ///
+    /// Label reference counts are adjusted if the instruction turns into
+    /// or stops being a branch.
+    void SetOperation(EOperation op);
+
+    /// @brief set source @a index (index = 1/2) to @a src
+    void SetSrc(int index, CTacAddr *src);
+
+    /// @brief set the destination operand to @a dst
+    ///
+    /// For branches, the reference counts of the old and the new target
+    /// label are adjusted.
+    void SetDest(CTac *dst);
+
+    /// @brief return a copy of this instruction
+    ///
+    /// The copy shares the operands with the original; branch targets are
+    /// referenced once more. Labels cannot be cloned.
+    CTacInstr* Clone(void) const;
+
+    /// @}
+
     /// @name output
     /// @{
 
@@ -373,9 +414,6 @@ class CTacInstr : public CTac {
     /// @brief set the instruction @a id (unique per procedure)
     void SetId(int unsigned id);
 
-    /// @brief set the destination operand to @a dst
-    void SetDest(CTac *dst);
-
     unsigned int   _id;              ///< unique instruction id
     EOperation     _op;              ///< opcode
     string         _name;            ///< name (for debugging purposes)
@@ -456,7 +494,16 @@ class CScope {
     /// @brief constructor
     /// @param ast abstract syntax tree for this scope
     /// @param parent superordinate scope, or NULL if none
-    CScope(CAstNode *ast, CScope *parent=NULL);
+    /// @param bounds_check check array indices at runtime
+    CScope(CAstNode *ast, CScope *parent=NULL, bool bounds_check=false);
+
+    /// @brief constructor for a copy of @a scope
+    ///
+    /// The copy has its own symbol table and code and is added to the
+    /// subscopes of the parent of @a scope.
+    /// @param scope scope to copy (must have a parent)
+    /// @param name name of the copy
+    CScope(const CScope *scope, const string name);
 
     /// @brief destructor
     virtual ~CScope(void);
@@ -476,6 +523,9 @@ class CScope {
     /// @brief return a reference to the list of subscopes
     const vector<CScope*>& GetSubscopes(void) const;
 
+    /// @brief remove @a s from the list of subscopes. @a s is not deleted.
+    void RemoveSubscope(CScope *s);
+
     /// @brief return a reference to the symbol table
     CSymtab* GetSymbolTable(void) const;
 
@@ -484,6 +534,9 @@ class CScope {
     /// Only set for procedures/functions; a module will return null.
     virtual CSymbol* GetDeclaration(void) const = 0;
 
+    /// @brief returns true if array indices are checked at runtime
+    bool GetBoundsCheck(void) const;
+
     /// @}
 
 
@@ -540,6 +593,7 @@ class CScope {
     CScope *_parent;                 ///< superordinate scope
     vector<CScope*> _children;       ///< list of functions
     CCodeBlock* _cb;                 ///< list of code blocks
+    bool _bounds_check;              ///< runtime bounds checks
 
     unsigned int _temp_id;           ///< next id for temporaries
     unsigned int _label_id;          ///< next id for labels
@@ -579,7 +633,8 @@ class CModule : public CScope {
 
     /// @brief constructor
     /// @param ast abstract syntax tree (must be a CAstModule instance)
-    CModule(CAstNode *ast);
+    /// @param bounds_check check array indices at runtime
+    CModule(CAstNode *ast, bool bounds_check=false);
 
     /// @brief destructor
     virtual ~CModule(void);
@@ -622,6 +677,13 @@ class CProcedure : public CScope {
     /// @param ast abstract syntax tree (must be a CAstProcedure instance)
     CProcedure(CAstNode *ast, CScope *parent);
 
+    /// @brief constructor for a copy of @a proc
+    ///
+    /// The declaration of the copy is added to the global symbol table.
+    /// @param proc procedure to copy
+    /// @param name name of the copy
+    CProcedure(const CProcedure *proc, const string name);
+
     /// @brief destructor
     virtual ~CProcedure(void);
 
@@ -645,6 +707,9 @@ class CProcedure : public CScope {
     virtual ostream&  print(ostream &out, int indent=0) const;
 
     /// @}
+
+  protected:
+    CSymProc *_decl;                 ///< declaration
 };
 
 
@@ -705,6 +770,13 @@ class CCodeBlock {
     /// @brief return (a reference) to the list of instructions
     const list<CTacInstr*>& GetInstr(void) const;
 
+    /// @brief replace the list of instructions by @a instr
+    ///
+    /// The code block takes ownership of the instructions in @a instr and
+    /// renumbers them. Instructions of the old list that are not contained
+    /// in @a instr must have been disposed of by the caller.
+    void SetInstr(const list<CTacInstr*> &instr);
+
     /// @brief remove unused/superfluous labels and goto instructions
     void CleanupControlFlow(void);
 
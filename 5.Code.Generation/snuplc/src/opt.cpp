@@ -0,0 +1,4297 @@
+//------------------------------------------------------------------------------
+/// @brief SnuPL TAC optimizer
+/// @section changelog Change Log
+/// 2026/10/19 created
+///
+/// @section license_section License
+/// Copyright (c) 2012-2016 Bernhard Egger
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms,  with or without modifi-
+/// cation, are permitted provided that the following conditions are met:
+///
+/// - Redistributions of source code must retain the above copyright notice,
+///   this list of conditions and the following disclaimer.
+/// - Redistributions in binary form must reproduce the above copyright notice,
+///   this list of conditions and the following disclaimer in the documentation
+///   and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY  AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER  OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT,  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+/// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF  SUBSTITUTE
+/// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+/// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN  CONTRACT, STRICT
+/// LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY
+/// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+/// DAMAGE.
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <cassert>
+
+#include "opt.h"
+using namespace std;
+
+
+/// @brief 32-bit wrap-around arithmetic
+static int WrapAdd(int a, int b) { return (int)((unsigned int)a + (unsigned int)b); }
+static int WrapMul(int a, int b) { return (int)((unsigned int)a * (unsigned int)b); }
+
+/// @brief evaluate 'a op b' (unary operations ignore @a b)
+/// @retval false if @a op cannot be evaluated at compile time
+static bool Fold(EOperation op, int a, int b, int &v)
+{
+  switch (op) {
+    case opAdd:    v = WrapAdd(a, b); return true;
+    case opSub:    v = WrapAdd(a, WrapMul(b, -1)); return true;
+    case opMul:    v = WrapMul(a, b); return true;
+    case opDiv:
+      // leave the division by zero and the overflow to the runtime
+      if ((b == 0) || ((a == INT_MIN) && (b == -1))) return false;
+      v = a / b; return true;
+    case opUDiv:
+      if (b == 0) return false;
+      v = (int)((unsigned int)a / (unsigned int)b); return true;
+    case opAnd:    v = a && b; return true;
+    case opOr:     v = a || b; return true;
+    case opNeg:    v = WrapMul(a, -1); return true;
+    case opPos:
+    case opAssign: v = a; return true;
+    case opNot:    v = !a; return true;
+    default:       return false;
+  }
+}
+
+/// @brief evaluate the relational operation 'a op b'
+static bool Compare(EOperation op, int a, int b)
+{
+  switch (op) {
+    case opEqual:       return a == b;
+    case opNotEqual:    return a != b;
+    case opLessThan:    return a < b;
+    case opLessEqual:   return a <= b;
+    case opBiggerThan:  return a > b;
+    case opBiggerEqual: return a >= b;
+    default:            assert(false); return false;
+  }
+}
+
+/// @brief return the symbol of the temporary @a a, or NULL
+static const CSymbol* GetTemp(const CTac *a)
+{
+  const CTacTemp *t = dynamic_cast<const CTacTemp*>(a);
+  return t != NULL ? t->GetSymbol() : NULL;
+}
+
+/// @brief returns true if @a a is the constant @a v
+static bool IsConst(const CTacAddr *a, int v)
+{
+  const CTacConst *c = dynamic_cast<const CTacConst*>(a);
+  return (c != NULL) && (c->GetValue() == v);
+}
+
+//------------------------------------------------------------------------------
+// CPass
+//
+CPass::CPass(const string name)
+  : _name(name), _module(NULL)
+{
+}
+
+CPass::~CPass(void)
+{
+}
+
+string CPass::GetName(void) const
+{
+  return _name;
+}
+
+bool CPass::Run(CModule *m)
+{
+  assert(m != NULL);
+  _module = m;
+
+  bool changed = RunOnScope(m);
+
+  vector<CScope*> work(m->GetSubscopes());
+  while (!work.empty()) {
+    CScope *s = work.back();
+    work.pop_back();
+
+    changed = RunOnScope(s) || changed;
+    work.insert(work.end(), s->GetSubscopes().begin(), s->GetSubscopes().end());
+  }
+
+  return changed;
+}
+
+bool CPass::RunOnScope(CScope *)
+{
+  return false;
+}
+
+CScope* CPass::GetScope(const CSymProc *proc) const
+{
+  vector<CScope*> work(_module->GetSubscopes());
+  while (!work.empty()) {
+    CScope *s = work.back();
+    work.pop_back();
+
+    if (s->GetDeclaration() == proc) return s;
+    work.insert(work.end(), s->GetSubscopes().begin(), s->GetSubscopes().end());
+  }
+
+  return NULL;
+}
+
+bool CPass::CallMayModify(const CSymProc *proc, const CSymbol *sym) const
+{
+  if (sym->GetSymbolType() != stGlobal) return false;
+
+  return proc->MayModify(sym);
+}
+
+bool CPass::GetOperand(const CTacAddr *a, COperand &o) const
+{
+  const CTacConst *c = dynamic_cast<const CTacConst*>(a);
+  if (c != NULL) {
+    o = COperand(NULL, c->GetValue());
+    return true;
+  }
+
+  const CTacName *n = dynamic_cast<const CTacName*>(a);
+  if ((n == NULL) || (dynamic_cast<const CTacReference*>(n) != NULL) ||
+      !IsScalarVar(n->GetSymbol())) return false;
+
+  o = COperand(n->GetSymbol(), 0);
+  return true;
+}
+
+bool CPass::IsLoopInvariant(const CLoop *l, const CTacAddr *a) const
+{
+  if ((a == NULL) || (dynamic_cast<const CTacConst*>(a) != NULL)) return true;
+  if (dynamic_cast<const CTacReference*>(a) != NULL) return false;
+
+  const CTacName *n = dynamic_cast<const CTacName*>(a);
+  assert(n != NULL);
+
+  const CSymbol *sym = n->GetSymbol();
+  if (!IsScalarVar(sym)) return sym->GetDataType()->IsArray();
+  if (l->Defines(sym)) return false;
+
+  if (sym->GetSymbolType() == stGlobal) {
+    const vector<CBasicBlock*> &blocks = l->GetBlocks();
+    for (size_t b=0; b<blocks.size(); b++) {
+      list<CTacInstr*> &instr = blocks[b]->GetInstr();
+      for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+        if (((*it)->GetOperation() == opCall) &&
+            CallMayModify(GetCallee(*it), sym)) return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+CTacAddr* CPass::Emit(CCodeBlock *cb, list<CTacInstr*> &code, EOperation op,
+                      CTacAddr *a, CTacAddr *b)
+{
+  CTacConst *c1 = dynamic_cast<CTacConst*>(a);
+  CTacConst *c2 = dynamic_cast<CTacConst*>(b);
+
+  int v;
+  if ((c1 != NULL) && (c2 != NULL) &&
+      Fold(op, c1->GetValue(), c2->GetValue(), v)) return new CTacConst(v);
+
+  if ((op == opAdd) && (c1 != NULL) && (c1->GetValue() == 0)) return b;
+  if (((op == opAdd) || (op == opSub)) && (c2 != NULL) && (c2->GetValue() == 0))
+    return a;
+  if (op == opMul) {
+    if (((c1 != NULL) && (c1->GetValue() == 0)) ||
+        ((c2 != NULL) && (c2->GetValue() == 0))) return new CTacConst(0);
+    if ((c1 != NULL) && (c1->GetValue() == 1)) return b;
+    if ((c2 != NULL) && (c2->GetValue() == 1)) return a;
+  }
+  if ((op == opDiv) && (c2 != NULL) && (c2->GetValue() == 1)) return a;
+
+  CTacTemp *t = cb->CreateTemp(CTypeManager::Get()->GetInt());
+  code.push_back(new CTacInstr(op, t, a, b));
+
+  return t;
+}
+
+bool CPass::RemoveDeadCode(CCodeBlock *cb) const
+{
+  list<CTacInstr*> code(cb->GetInstr());
+  list<CTacInstr*>::iterator it;
+  map<const CSymbol*, int> uses;
+  bool changed = false;
+
+  for (it=code.begin(); it!=code.end(); it++) {
+    vector<const CSymbol*> used;
+    GetUsedSymbols(*it, used);
+    for (size_t u=0; u<used.size(); u++) uses[used[u]]++;
+  }
+
+  it = code.begin();
+  while (it != code.end()) {
+    CTacInstr *i = *it;
+    EOperation op = i->GetOperation();
+    const CSymbol *t = GetTemp(i->GetDest());
+
+    // divisions are kept since they may trap
+    bool pure = (op <= opAddress) &&
+                (((op != opDiv) && (op != opUDiv)) ||
+                 (!IsConst(i->GetSrc(2), 0) && !IsConst(i->GetSrc(2), -1) &&
+                  (dynamic_cast<CTacConst*>(i->GetSrc(2)) != NULL)));
+
+    if ((t != NULL) && pure && (uses[t] == 0)) {
+      it = code.erase(it);
+      delete i;
+      changed = true;
+    } else {
+      it++;
+    }
+  }
+
+  cb->SetInstr(code);
+
+  return changed;
+}
+
+//------------------------------------------------------------------------------
+// CCfgCleanup
+//
+CCfgCleanup::CCfgCleanup(void)
+  : CPass("cfg-cleanup")
+{
+}
+
+bool CCfgCleanup::RunOnScope(CScope *s)
+{
+  // building the control flow graph removes unreachable blocks, committing
+  // it straightens the remaining branches
+  CCfg cfg(s->GetCodeBlock());
+  cfg.Commit();
+
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+// CPurityAnalysis
+//
+CPurityAnalysis::CPurityAnalysis(void)
+  : CPass("purity")
+{
+}
+
+bool CPurityAnalysis::Run(CModule *m)
+{
+  assert(m != NULL);
+  _module = m;
+
+  CCallGraph cg(m);
+  const vector<CScope*> &scopes = cg.GetScopes();
+
+  for (size_t s=0; s<scopes.size(); s++) {
+    CSymProc *proc = dynamic_cast<CSymProc*>(scopes[s]->GetDeclaration());
+    if (proc == NULL) continue;
+    proc->SetPure(true);
+    proc->SetConst(true);
+  }
+
+  // callees are analyzed before their callers; recursive procedures are
+  // revisited until nothing changes
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    for (size_t s=0; s<scopes.size(); s++) {
+      CSymProc *proc = dynamic_cast<CSymProc*>(scopes[s]->GetDeclaration());
+      if (proc == NULL) continue;
+
+      bool pure, cnst;
+      Analyze(scopes[s], pure, cnst);
+      if ((pure != proc->IsPure()) || (cnst != proc->IsConst())) {
+        proc->SetPure(pure);
+        proc->SetConst(cnst);
+        changed = true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/// @brief returns true if the reference @a r accesses a local array
+static bool IsLocalMemory(const CTacReference *r)
+{
+  const CSymbol *sym = r->GetDerefSymbol();
+  return (sym != NULL) && (sym->GetSymbolType() == stLocal);
+}
+
+void CPurityAnalysis::Analyze(CScope *s, bool &pure, bool &cnst) const
+{
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+
+  // temporaries holding the address of a local array
+  set<const CSymbol*> local;
+
+  pure = cnst = true;
+
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    const CTacInstr *i = *it;
+    EOperation op = i->GetOperation();
+    const CSymbol *def = GetDefinedSymbol(i);
+
+    if (op == opAddress) {
+      const CTacName *n = dynamic_cast<const CTacName*>(i->GetSrc(1));
+      if ((def != NULL) && (n != NULL) &&
+          (dynamic_cast<const CTacReference*>(n) == NULL) &&
+          (n->GetSymbol()->GetSymbolType() == stLocal)) local.insert(def);
+    }
+
+    // writes
+    if ((def != NULL) && (def->GetSymbolType() == stGlobal)) pure = false;
+
+    const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetDest());
+    if ((r != NULL) && !IsLocalMemory(r)) pure = false;
+
+    // reads
+    vector<const CSymbol*> used;
+    GetUsedSymbols(i, used);
+    for (size_t u=0; u<used.size(); u++) {
+      if (used[u]->GetSymbolType() == stGlobal) cnst = false;
+    }
+
+    for (int k=1; (op != opAddress) && (k<=2); k++) {
+      r = dynamic_cast<const CTacReference*>(i->GetSrc(k));
+      if ((r != NULL) && !IsLocalMemory(r)) cnst = false;
+    }
+
+    // traps
+    if (op == opCheck) pure = false;
+    if (((op == opDiv) || (op == opUDiv)) &&
+        ((dynamic_cast<const CTacConst*>(i->GetSrc(2)) == NULL) ||
+         IsConst(i->GetSrc(2), 0) || IsConst(i->GetSrc(2), -1))) pure = false;
+
+    if (op == opCall) {
+      const CSymProc *proc = GetCallee(i);
+
+      if (!proc->IsPure()) {
+        pure = false;
+      } else if (!proc->IsConst()) {
+        // the runtime library only reads the arrays passed to it
+        vector<CTacInstr*> params;
+        bool own = proc->IsExternal() && GetParams(instr.begin(), it, params);
+
+        for (size_t p=0; own && (p<params.size()); p++) {
+          const CTacName *n = dynamic_cast<const CTacName*>(params[p]->GetSrc(1));
+          if ((n != NULL) && n->GetSymbol()->GetDataType()->IsPointer())
+            own = local.count(n->GetSymbol()) > 0;
+        }
+        if (!own) cnst = false;
+      }
+    }
+  }
+
+  cnst = cnst && pure;
+}
+
+
+//------------------------------------------------------------------------------
+// CModRefAnalysis
+//
+CModRefAnalysis::CModRefAnalysis(void)
+  : CPass("modref")
+{
+}
+
+bool CModRefAnalysis::Run(CModule *m)
+{
+  assert(m != NULL);
+  _module = m;
+
+  CCallGraph cg(m);
+  const vector<CScope*> &scopes = cg.GetScopes();
+  map<const CScope*, set<const CSymbol*> > mod, ref;
+
+  for (size_t s=0; s<scopes.size(); s++) {
+    Collect(scopes[s], mod[scopes[s]], ref[scopes[s]]);
+  }
+
+  // add the accesses of the callees; recursive procedures are revisited
+  // until nothing changes
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    for (size_t s=0; s<scopes.size(); s++) {
+      set<const CSymbol*> &smod = mod[scopes[s]], &sref = ref[scopes[s]];
+      size_t size = smod.size() + sref.size();
+
+      const vector<CScope*> &callees = cg.GetCallees(scopes[s]);
+      for (size_t c=0; c<callees.size(); c++) {
+        smod.insert(mod[callees[c]].begin(), mod[callees[c]].end());
+        sref.insert(ref[callees[c]].begin(), ref[callees[c]].end());
+      }
+
+      changed = changed || (smod.size() + sref.size() != size);
+    }
+  }
+
+  for (size_t s=0; s<scopes.size(); s++) {
+    CSymProc *proc = dynamic_cast<CSymProc*>(scopes[s]->GetDeclaration());
+    if (proc != NULL) proc->SetModRef(mod[scopes[s]], ref[scopes[s]]);
+  }
+
+  return false;
+}
+
+void CModRefAnalysis::Collect(CScope *s, set<const CSymbol*> &mod,
+                              set<const CSymbol*> &ref) const
+{
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    const CTacInstr *i = *it;
+    EOperation op = i->GetOperation();
+
+    const CSymbol *def = GetDefinedSymbol(i);
+    if ((def != NULL) && (def->GetSymbolType() == stGlobal)) mod.insert(def);
+
+    vector<const CSymbol*> used;
+    GetUsedSymbols(i, used);
+    for (size_t u=0; u<used.size(); u++) {
+      if (used[u]->GetSymbolType() == stGlobal) ref.insert(used[u]);
+    }
+
+    // global arrays accessed through references
+    const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetDest());
+    if ((r != NULL) && (r->GetDerefSymbol() != NULL) &&
+        (r->GetDerefSymbol()->GetSymbolType() == stGlobal))
+      mod.insert(r->GetDerefSymbol());
+
+    for (int k=1; k<=2; k++) {
+      const CTacName *n = dynamic_cast<const CTacName*>(i->GetSrc(k));
+      if ((n == NULL) || (op == opCall)) continue;
+
+      r = dynamic_cast<const CTacReference*>(n);
+      if ((r != NULL) && (op != opAddress)) {
+        if ((r->GetDerefSymbol() != NULL) &&
+            (r->GetDerefSymbol()->GetSymbolType() == stGlobal))
+          ref.insert(r->GetDerefSymbol());
+      } else if ((r == NULL) && (op == opAddress) &&
+                 (n->GetSymbol()->GetSymbolType() == stGlobal)) {
+        mod.insert(n->GetSymbol());
+        ref.insert(n->GetSymbol());
+      }
+    }
+  }
+}
+
+
+//------------------------------------------------------------------------------
+// CConstCallEval
+//
+
+/// @brief return the value of the constant or scalar variable @a a in @a env
+/// @retval false if the value is not known
+static bool GetValue(const map<const CSymbol*, int> &env, const CTacAddr *a,
+                     int &v)
+{
+  const CTacConst *c = dynamic_cast<const CTacConst*>(a);
+  if (c != NULL) {
+    v = c->GetValue();
+    return true;
+  }
+
+  const CTacName *n = dynamic_cast<const CTacName*>(a);
+  if ((n == NULL) || (dynamic_cast<const CTacReference*>(n) != NULL)) return false;
+
+  map<const CSymbol*, int>::const_iterator it = env.find(n->GetSymbol());
+  if (it == env.end()) return false;
+
+  v = it->second;
+  return true;
+}
+
+CConstCallEval::CConstCallEval(int budget)
+  : CPass("const-call-eval"), _budget(budget)
+{
+}
+
+bool CConstCallEval::RunOnScope(CScope *s)
+{
+  CCodeBlock *cb = s->GetCodeBlock();
+  list<CTacInstr*> code(cb->GetInstr());
+  list<CTacInstr*>::iterator it;
+  bool changed = false;
+
+  // temporaries assigned once; the values of those computed from constants
+  // are known, so results of evaluated calls can be arguments of others
+  map<const CSymbol*, int> ndef, known;
+  for (it=code.begin(); it!=code.end(); it++) ndef[GetTemp((*it)->GetDest())]++;
+
+  for (it=code.begin(); it!=code.end(); it++) {
+    CTacInstr *call = *it;
+    EOperation op = call->GetOperation();
+    const CSymbol *t = GetTemp(call->GetDest());
+
+    if ((t != NULL) && (ndef[t] == 1) &&
+        ((op <= opNot) || (op == opUDiv) || (op == opAssign))) {
+      int a = 0, b = 0, v;
+      if (GetValue(known, call->GetSrc(1), a) &&
+          ((call->GetSrc(2) == NULL) || GetValue(known, call->GetSrc(2), b)) &&
+          Fold(op, a, b, v)) known[t] = v;
+    }
+
+    if ((op != opCall) || (call->GetDest() == NULL)) continue;
+
+    const CSymProc *proc = GetCallee(call);
+    vector<CTacInstr*> params;
+    if (!proc->IsConst() || proc->IsExternal() ||
+        !GetParams(code.begin(), it, params)) continue;
+
+    vector<int> args;
+    int v;
+    for (size_t p=0; p<params.size(); p++) {
+      if (!GetValue(known, params[p]->GetSrc(1), v)) break;
+      args.push_back(v);
+    }
+    if (args.size() != params.size()) continue;
+
+    int result, steps = _budget;
+    if (!Evaluate(proc, args, result, steps, 0)) continue;
+
+    for (size_t p=0; p<params.size(); p++) {
+      code.remove(params[p]);
+      delete params[p];
+    }
+    call->SetOperation(opAssign);
+    call->SetSrc(1, new CTacConst(result));
+    if (ndef[t] == 1) known[t] = result;
+    changed = true;
+
+    // the code of this scope may have been prepared for interpretation
+    _code.clear();
+  }
+
+  cb->SetInstr(code);
+
+  return changed;
+}
+
+const CConstCallEval::CCode* CConstCallEval::GetCode(const CSymProc *proc)
+{
+  map<const CSymProc*, CCode>::iterator it = _code.find(proc);
+  if (it != _code.end()) return &it->second;
+
+  CScope *s = GetScope(proc);
+  if (s == NULL) return NULL;
+
+  CCode &code = _code[proc];
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator i;
+  for (i=instr.begin(); i!=instr.end(); i++) {
+    if ((*i)->GetOperation() == opLabel) code.label[*i] = code.instr.size();
+    code.instr.push_back(*i);
+  }
+
+  return &code;
+}
+
+bool CConstCallEval::Evaluate(const CSymProc *proc, const vector<int> &args,
+                              int &result, int &steps, int depth)
+{
+  const CCode *code = GetCode(proc);
+  if ((code == NULL) || (depth > 256) ||
+      ((int)args.size() != proc->GetNParams())) return false;
+
+  map<const CSymbol*, int> env;
+  for (size_t p=0; p<args.size(); p++) env[proc->GetParam(p)] = args[p];
+
+  // pending parameters (index, value), in the order they are pushed
+  vector<pair<int, int> > stack;
+  size_t pc = 0;
+
+  while (pc < code->instr.size()) {
+    if (--steps < 0) return false;
+
+    const CTacInstr *i = code->instr[pc++];
+    EOperation op = i->GetOperation();
+    const CTacName *dst = dynamic_cast<const CTacName*>(i->GetDest());
+    int a = 0, b = 0, v;
+
+    if ((dst != NULL) && (dynamic_cast<const CTacReference*>(dst) != NULL))
+      return false;
+
+    switch (op) {
+      case opAdd: case opSub: case opMul: case opDiv: case opUDiv:
+      case opAnd: case opOr:
+        if (!GetValue(env, i->GetSrc(2), b)) return false;
+        // fall through
+      case opNeg: case opPos: case opNot: case opAssign:
+        if (!GetValue(env, i->GetSrc(1), a) || !Fold(op, a, b, v) ||
+            (dst == NULL)) return false;
+        env[dst->GetSymbol()] = v;
+        break;
+
+      case opEqual: case opNotEqual: case opLessThan: case opLessEqual:
+      case opBiggerThan: case opBiggerEqual:
+        if (!GetValue(env, i->GetSrc(1), a) ||
+            !GetValue(env, i->GetSrc(2), b)) return false;
+        if (!Compare(op, a, b)) break;
+        // fall through
+      case opGoto:
+      {
+        map<const CTac*, size_t>::const_iterator l =
+          code->label.find(i->GetDest());
+        if (l == code->label.end()) return false;
+        pc = l->second;
+        break;
+      }
+
+      case opParam:
+      {
+        const CTacConst *index = dynamic_cast<const CTacConst*>(i->GetDest());
+        if ((index == NULL) || !GetValue(env, i->GetSrc(1), a)) return false;
+        stack.push_back(make_pair(index->GetValue(), a));
+        break;
+      }
+
+      case opCall:
+      {
+        const CSymProc *callee = GetCallee(i);
+        int n = callee->GetNParams();
+        if (!callee->IsConst() || ((int)stack.size() < n)) return false;
+
+        vector<int> cargs(n, 0);
+        for (int p=0; p<n; p++) {
+          pair<int, int> arg = stack.back();
+          stack.pop_back();
+          if ((arg.first < 0) || (arg.first >= n)) return false;
+          cargs[arg.first] = arg.second;
+        }
+
+        if (!Evaluate(callee, cargs, v, steps, depth+1)) return false;
+        if (dst != NULL) env[dst->GetSymbol()] = v;
+        break;
+      }
+
+      case opReturn:
+        return GetValue(env, i->GetSrc(1), result);
+
+      case opLabel:
+      case opNop:
+        break;
+
+      default:
+        return false;
+    }
+  }
+
+  // the end of the procedure is reached without a return value
+  return false;
+}
+
+
+//------------------------------------------------------------------------------
+// CPureCallElim
+//
+CPureCallElim::CPureCallElim(void)
+  : CPass("pure-call-elim")
+{
+}
+
+bool CPureCallElim::RunOnScope(CScope *s)
+{
+  CCfg cfg(s->GetCodeBlock());
+  bool changed = false, found = true;
+
+  const vector<CBasicBlock*> &blocks = cfg.GetBlocks();
+  for (size_t b=0; b<blocks.size(); b++) changed = Reuse(blocks[b]) || changed;
+
+  // innermost loops first. Calls hoisted in front of an inner loop may be
+  // hoisted out of the enclosing loop in the next round.
+  while (found) {
+    found = false;
+
+    const vector<CLoop*> &loops = cfg.GetLoops();
+    for (size_t l=0; !found && (l<loops.size()); l++) {
+      found = Hoist(&cfg, loops[l]);
+    }
+    changed = changed || found;
+  }
+
+  cfg.Commit();
+
+  while (RemoveDead(s->GetCodeBlock())) changed = true;
+
+  return changed;
+}
+
+bool CPureCallElim::IsPureCall(const list<CTacInstr*> &instr,
+                               list<CTacInstr*>::const_iterator call,
+                               vector<CTacInstr*> &params) const
+{
+  if (((*call)->GetOperation() != opCall) || !GetCallee(*call)->IsPure() ||
+      !GetParams(instr.begin(), call, params)) return false;
+
+  COperand o;
+  for (size_t p=0; p<params.size(); p++) {
+    if (!GetOperand(params[p]->GetSrc(1), o)) return false;
+  }
+
+  return true;
+}
+
+bool CPureCallElim::Clobbers(const CTacInstr *instr) const
+{
+  const CSymbol *def = GetDefinedSymbol(instr);
+
+  if (WritesMemory(instr) ||
+      ((def != NULL) && (def->GetSymbolType() == stGlobal))) return true;
+
+  if (instr->GetOperation() != opCall) return false;
+
+  const CSymProc *proc = GetCallee(instr);
+  return !proc->IsExternal() && !proc->IsPure();
+}
+
+bool CPureCallElim::Reuse(CBasicBlock *bb) const
+{
+  list<CTacInstr*> &instr = bb->GetInstr();
+  list<CTacInstr*>::iterator it;
+  bool changed = false;
+
+  map<const CTacInstr*, int> index;
+  int idx = 0;
+  for (it=instr.begin(); it!=instr.end(); it++) index[*it] = idx++;
+
+  // available calls and the values of their arguments
+  vector<CTacInstr*> avail;
+  vector<vector<COperand> > args;
+
+  // position of the last definition of variables and of the last
+  // instruction modifying global variables or memory
+  map<const CSymbol*, int> lastdef;
+  int lastclobber = -1;
+
+  it = instr.begin();
+  while (it != instr.end()) {
+    CTacInstr *i = *it;
+    vector<CTacInstr*> params;
+
+    if (IsPureCall(instr, it, params) && (GetTemp(i->GetDest()) != NULL)) {
+      const CSymProc *proc = GetCallee(i);
+      vector<COperand> a(params.size());
+      int first = index[i];
+      bool global = false;
+
+      for (size_t p=0; p<params.size(); p++) {
+        GetOperand(params[p]->GetSrc(1), a[p]);
+        first = min(first, index[params[p]]);
+        global = global ||
+                 ((a[p].first != NULL) && (a[p].first->GetSymbolType() == stGlobal));
+      }
+
+      size_t k = 0;
+      while ((k < avail.size()) &&
+             ((GetCallee(avail[k]) != proc) || (args[k] != a) ||
+              (index[avail[k]] > first))) k++;
+
+      if (k < avail.size()) {
+        for (size_t p=0; p<params.size(); p++) {
+          instr.remove(params[p]);
+          delete params[p];
+        }
+        i->SetOperation(opAssign);
+        i->SetSrc(1, dynamic_cast<CTacAddr*>(avail[k]->GetDest()));
+        changed = true;
+        it++;
+        continue;
+      }
+
+      // the arguments must not change between the parameters and the call
+      bool stable = (!global && proc->IsConst()) || (lastclobber < first);
+      for (size_t p=0; stable && (p<a.size()); p++) {
+        stable = (a[p].first == NULL) || (lastdef.count(a[p].first) == 0) ||
+                 (lastdef[a[p].first] < first);
+      }
+
+      if (stable) {
+        avail.push_back(i);
+        args.push_back(a);
+      }
+    }
+
+    const CSymbol *def = GetDefinedSymbol(i);
+    bool clobber = Clobbers(i);
+    if (def != NULL) lastdef[def] = index[i];
+    if (clobber) lastclobber = index[i];
+
+    size_t k = 0;
+    while (k < avail.size()) {
+      bool kill = clobber && !GetCallee(avail[k])->IsConst();
+      for (size_t p=0; !kill && (p<args[k].size()); p++) {
+        const CSymbol *sym = args[k][p].first;
+        kill = (sym != NULL) &&
+               ((sym == def) || (clobber && (sym->GetSymbolType() == stGlobal)));
+      }
+
+      if (kill) {
+        avail.erase(avail.begin() + k);
+        args.erase(args.begin() + k);
+      } else {
+        k++;
+      }
+    }
+
+    it++;
+  }
+
+  return changed;
+}
+
+bool CPureCallElim::Hoist(CCfg *cfg, CLoop *l) const
+{
+  const vector<CBasicBlock*> &blocks = l->GetBlocks();
+
+  // only calls executed in every iteration are hoisted, i.e., calls
+  // dominating all blocks leaving the loop
+  vector<CBasicBlock*> exits;
+  bool clobbered = false;
+  for (size_t b=0; b<blocks.size(); b++) {
+    const vector<CBasicBlock*> &succ = blocks[b]->GetSucc();
+    bool exit = (blocks[b]->GetFallthrough() == NULL);
+    for (size_t s=0; s<succ.size(); s++) exit = exit || !l->Contains(succ[s]);
+    if (exit) exits.push_back(blocks[b]);
+
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    list<CTacInstr*>::iterator it;
+    for (it=instr.begin(); it!=instr.end(); it++) {
+      clobbered = clobbered || Clobbers(*it);
+    }
+  }
+  if (exits.empty()) return false;
+
+  // find the calls with invariant arguments. Their parameters must
+  // immediately precede them.
+  vector<CBasicBlock*> where;
+  vector<list<CTacInstr*>::iterator> which;
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    CBasicBlock *bb = blocks[b];
+    if (bb->GetLoop() != l) continue;
+
+    bool always = true;
+    for (size_t e=0; e<exits.size(); e++) {
+      always = always && cfg->Dominates(bb, exits[e]);
+    }
+    if (!always) continue;
+
+    list<CTacInstr*> &instr = bb->GetInstr();
+    list<CTacInstr*>::iterator it;
+    for (it=instr.begin(); it!=instr.end(); it++) {
+      vector<CTacInstr*> params;
+      if (!IsPureCall(instr, it, params) || (GetTemp((*it)->GetDest()) == NULL) ||
+          (clobbered && !GetCallee(*it)->IsConst())) continue;
+
+      bool ok = true;
+      list<CTacInstr*>::iterator p = it;
+      for (size_t n=0; ok && (n<params.size()); n++) {
+        ok = (p != instr.begin()) &&
+             (find(params.begin(), params.end(), *--p) != params.end());
+      }
+      for (size_t n=0; ok && (n<params.size()); n++) {
+        ok = IsLoopInvariant(l, params[n]->GetSrc(1));
+      }
+
+      if (ok) {
+        where.push_back(bb);
+        which.push_back(it);
+      }
+    }
+  }
+
+  if (where.empty()) return false;
+
+  CBasicBlock *pre = cfg->GetPreheader(l);
+  list<CTacInstr*> &code = pre->GetInstr();
+
+  for (size_t c=0; c<which.size(); c++) {
+    list<CTacInstr*>::iterator first = which[c], last = which[c];
+    for (int n=0; n<GetCallee(*which[c])->GetNParams(); n++) first--;
+    code.splice(code.end(), where[c]->GetInstr(), first, ++last);
+  }
+
+  cfg->Update();
+
+  return true;
+}
+
+bool CPureCallElim::RemoveDead(CCodeBlock *cb) const
+{
+  list<CTacInstr*> code(cb->GetInstr());
+  list<CTacInstr*>::iterator it;
+  map<const CSymbol*, int> uses;
+  bool changed = false;
+
+  for (it=code.begin(); it!=code.end(); it++) {
+    vector<const CSymbol*> used;
+    GetUsedSymbols(*it, used);
+    for (size_t u=0; u<used.size(); u++) uses[used[u]]++;
+  }
+
+  it = code.begin();
+  while (it != code.end()) {
+    CTacInstr *i = *it;
+    const CSymbol *t = GetTemp(i->GetDest());
+    vector<CTacInstr*> params;
+
+    if ((i->GetOperation() == opCall) && GetCallee(i)->IsPure() &&
+        ((i->GetDest() == NULL) || ((t != NULL) && (uses[t] == 0))) &&
+        GetParams(code.begin(), it, params)) {
+      for (size_t p=0; p<params.size(); p++) {
+        code.remove(params[p]);
+        delete params[p];
+      }
+      it = code.erase(it);
+      delete i;
+      changed = true;
+    } else {
+      it++;
+    }
+  }
+
+  cb->SetInstr(code);
+
+  return changed;
+}
+
+
+//------------------------------------------------------------------------------
+// CDeadArgElim
+//
+CDeadArgElim::CDeadArgElim(void)
+  : CPass("dead-arg-elim")
+{
+}
+
+bool CDeadArgElim::Run(CModule *m)
+{
+  assert(m != NULL);
+  _module = m;
+
+  // call sites may also be located in unreachable procedures; they are
+  // rewritten as well
+  vector<CScope*> scopes(1, m), work(m->GetSubscopes());
+  while (!work.empty()) {
+    CScope *s = work.back();
+    work.pop_back();
+
+    scopes.push_back(s);
+    work.insert(work.end(), s->GetSubscopes().begin(), s->GetSubscopes().end());
+  }
+
+  CTypeManager *tm = CTypeManager::Get();
+  bool changed = false;
+
+  for (size_t s=1; s<scopes.size(); s++) {
+    CSymProc *proc = dynamic_cast<CSymProc*>(scopes[s]->GetDeclaration());
+    assert(proc != NULL);
+
+    // the return value is dropped first; the computation of the returned
+    // value may be the only access to some of the parameters
+    bool result = proc->GetDataType()->IsNull() || ResultUsed(scopes, proc);
+    if (!result) {
+      CCodeBlock *cb = scopes[s]->GetCodeBlock();
+      const list<CTacInstr*> &code = cb->GetInstr();
+      list<CTacInstr*>::const_iterator it;
+      for (it=code.begin(); it!=code.end(); it++) {
+        if ((*it)->GetOperation() == opReturn) (*it)->SetSrc(1, NULL);
+      }
+      while (RemoveDeadCode(cb));
+      proc->SetDataType(tm->GetNull());
+    }
+
+    vector<int> index;
+    int n = 0;
+    for (int p=0; p<proc->GetNParams(); p++) {
+      index.push_back(Accesses(scopes[s], proc->GetParam(p)) ? n++ : -1);
+    }
+
+    if ((n == proc->GetNParams()) && result) continue;
+
+    // call sites
+    for (size_t c=0; c<scopes.size(); c++) {
+      CCodeBlock *cb = scopes[c]->GetCodeBlock();
+      list<CTacInstr*> code(cb->GetInstr());
+
+      // the parameters of all calls are collected before any is removed;
+      // GetParams() skips over the parameters of nested calls to the same
+      // procedure by its (old) number of parameters
+      vector<CTacInstr*> calls;
+      vector<vector<CTacInstr*> > params;
+      for (list<CTacInstr*>::iterator it=code.begin(); it!=code.end(); it++) {
+        if (((*it)->GetOperation() != opCall) || (GetCallee(*it) != proc))
+          continue;
+
+        calls.push_back(*it);
+        params.push_back(vector<CTacInstr*>());
+        bool found = GetParams(code.begin(), it, params.back());
+        assert(found);
+      }
+
+      for (size_t k=0; k<calls.size(); k++) {
+        for (size_t p=0; p<params[k].size(); p++) {
+          if (index[p] < 0) {
+            code.remove(params[k][p]);
+            delete params[k][p];
+          } else {
+            params[k][p]->SetDest(new CTacConst(index[p]));
+          }
+        }
+
+        if (!result) calls[k]->SetDest(NULL);
+      }
+
+      cb->SetInstr(code);
+    }
+
+    // the procedure
+    CSymtab *st = scopes[s]->GetSymbolTable();
+    for (int p=(int)index.size()-1; p>=0; p--) {
+      if (index[p] >= 0) continue;
+      st->RemoveSymbol(const_cast<CSymParam*>(proc->GetParam(p)));
+      proc->RemoveParam(p);
+    }
+
+    changed = true;
+  }
+
+  return changed;
+}
+
+bool CDeadArgElim::Accesses(CScope *s, const CSymbol *sym) const
+{
+  const list<CTacInstr*> &code = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+
+  for (it=code.begin(); it!=code.end(); it++) {
+    const CTac *a[3] = { (*it)->GetDest(), (*it)->GetSrc(1), (*it)->GetSrc(2) };
+
+    for (int k=0; k<3; k++) {
+      const CTacName *n = dynamic_cast<const CTacName*>(a[k]);
+      if ((n != NULL) && (n->GetSymbol() == sym)) return true;
+
+      const CTacReference *r = dynamic_cast<const CTacReference*>(a[k]);
+      if ((r != NULL) && (r->GetDerefSymbol() == sym)) return true;
+    }
+  }
+
+  return false;
+}
+
+bool CDeadArgElim::ResultUsed(const vector<CScope*> &scopes,
+                              const CSymProc *proc) const
+{
+  for (size_t s=0; s<scopes.size(); s++) {
+    const list<CTacInstr*> &code = scopes[s]->GetCodeBlock()->GetInstr();
+    list<CTacInstr*>::const_iterator it;
+
+    set<const CSymbol*> results;
+    for (it=code.begin(); it!=code.end(); it++) {
+      if (((*it)->GetOperation() != opCall) || (GetCallee(*it) != proc) ||
+          ((*it)->GetDest() == NULL)) continue;
+
+      const CSymbol *t = GetTemp((*it)->GetDest());
+      if (t == NULL) return true;
+      results.insert(t);
+    }
+    if (results.empty()) continue;
+
+    for (it=code.begin(); it!=code.end(); it++) {
+      vector<const CSymbol*> used;
+      GetUsedSymbols(*it, used);
+      for (size_t u=0; u<used.size(); u++) {
+        if (results.count(used[u]) > 0) return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+
+//------------------------------------------------------------------------------
+// CAlgebraicSimplify
+//
+CAlgebraicSimplify::CAlgebraicSimplify(void)
+  : CPass("simplify")
+{
+}
+
+bool CAlgebraicSimplify::RunOnScope(CScope *s)
+{
+  CCodeBlock *cb = s->GetCodeBlock();
+  list<CTacInstr*> code(cb->GetInstr());
+  list<CTacInstr*>::iterator it;
+  bool changed = false;
+
+  _ndef.clear();
+  _nuse.clear();
+  for (it=code.begin(); it!=code.end(); it++) {
+    const CSymbol *t = GetTemp((*it)->GetDest());
+    if (t != NULL) _ndef[t]++;
+  }
+  for (it=code.begin(); it!=code.end(); it++) {
+    vector<const CSymbol*> used;
+    GetUsedSymbols(*it, used);
+    for (size_t u=0; u<used.size(); u++) _nuse[used[u]]++;
+  }
+
+  _copy.clear();
+  _def.clear();
+
+  it = code.begin();
+  while (it != code.end()) {
+    CTacInstr *i = *it;
+    EOperation op = i->GetOperation();
+
+    // values are only tracked within basic blocks
+    if (op == opLabel) {
+      _copy.clear();
+      _def.clear();
+      it++;
+      continue;
+    }
+
+    // replace temporaries by the operands they are equal to
+    if ((op != opCall) && (op != opAddress)) {
+      for (int k=1; k<=2; k++) {
+        const CSymbol *t = GetTemp(i->GetSrc(k));
+        if ((t == NULL) || (_copy.count(t) == 0)) continue;
+
+        CTacAddr *a = _copy[t];
+        const CSymbol *u = GetTemp(a);
+        _nuse[t]--;
+        if (u != NULL) _nuse[u]++;
+        i->SetSrc(k, a);
+        changed = true;
+      }
+    }
+
+    if (IsRelOp(op)) {
+      // branches on constant conditions
+      CTacConst *c1 = dynamic_cast<CTacConst*>(i->GetSrc(1));
+      CTacConst *c2 = dynamic_cast<CTacConst*>(i->GetSrc(2));
+      COperand o1, o2;
+      int res = -1;
+
+      if ((c1 != NULL) && (c2 != NULL)) {
+        res = Compare(op, c1->GetValue(), c2->GetValue());
+      } else if (GetOperand(i->GetSrc(1), o1) && GetOperand(i->GetSrc(2), o2) &&
+                 (o1 == o2)) {
+        res = (op == opEqual) || (op == opLessEqual) || (op == opBiggerEqual);
+      }
+
+      if (res == 0) {
+        it = code.erase(it);
+        delete i;
+        changed = true;
+        continue;
+      }
+      if (res == 1) {
+        i->SetOperation(opGoto);
+        i->SetSrc(1, NULL);
+        i->SetSrc(2, NULL);
+        changed = true;
+      }
+    }
+
+    changed = Simplify(i) || changed;
+    op = i->GetOperation();
+
+    // x := x
+    COperand o1, o2;
+    if ((op == opAssign) && GetOperand(i->GetSrc(1), o1) &&
+        (o1.first != NULL) && (GetDefinedSymbol(i) == o1.first)) {
+      it = code.erase(it);
+      delete i;
+      changed = true;
+      continue;
+    }
+
+    if ((op == opAdd) || (op == opSub) || (op == opMul)) {
+      changed = Reassociate(cb, code, it, i) || changed;
+      op = i->GetOperation();
+    }
+
+    // record the value of single-assignment temporaries
+    const CSymbol *t = GetTemp(i->GetDest());
+    if ((t != NULL) && (_ndef[t] == 1)) {
+      if (((op == opAssign) || (op == opPos)) && GetOperand(i->GetSrc(1), o1)) {
+        _copy[t] = i->GetSrc(1);
+      } else if ((op < opAssign) && GetOperand(i->GetSrc(1), o1) &&
+                 ((i->GetSrc(2) == NULL) || GetOperand(i->GetSrc(2), o2))) {
+        _def[t] = i;
+      }
+    }
+
+    const CSymbol *d = GetDefinedSymbol(i);
+    if (d != NULL) Invalidate(d);
+
+    // called procedures may modify global variables
+    if (op == opCall) {
+      const CSymProc *proc = GetCallee(i);
+      vector<const CSymbol*> mod;
+
+      map<const CSymbol*, CTacAddr*>::iterator c;
+      for (c=_copy.begin(); c!=_copy.end(); c++) {
+        const CTacName *n = dynamic_cast<const CTacName*>(c->second);
+        if ((n != NULL) && CallMayModify(proc, n->GetSymbol()))
+          mod.push_back(n->GetSymbol());
+      }
+      map<const CSymbol*, CTacInstr*>::iterator e;
+      for (e=_def.begin(); e!=_def.end(); e++) {
+        for (int k=1; k<=2; k++) {
+          const CTacName *n = dynamic_cast<const CTacName*>(e->second->GetSrc(k));
+          if ((n != NULL) && CallMayModify(proc, n->GetSymbol()))
+            mod.push_back(n->GetSymbol());
+        }
+      }
+      for (size_t m=0; m<mod.size(); m++) Invalidate(mod[m]);
+    }
+
+    if (i->IsBranch()) {
+      _copy.clear();
+      _def.clear();
+    }
+
+    it++;
+  }
+
+  cb->SetInstr(code);
+
+  while (RemoveDeadCode(cb)) changed = true;
+
+  return changed;
+}
+
+bool CAlgebraicSimplify::Simplify(CTacInstr *instr) const
+{
+  EOperation op = instr->GetOperation();
+  CTacAddr *a = instr->GetSrc(1), *b = instr->GetSrc(2);
+
+  // constant operands to the right
+  if ((IsCommutative(op) || IsRelOp(op)) &&
+      (dynamic_cast<CTacConst*>(a) != NULL) &&
+      (dynamic_cast<CTacConst*>(b) == NULL)) {
+    if (IsRelOp(op)) instr->SetOperation(SwapRelOp(op));
+    instr->SetSrc(1, b);
+    instr->SetSrc(2, a);
+    Simplify(instr);
+    return true;
+  }
+
+  if (!((op < opAssign) && (GetTemp(instr->GetDest()) != NULL ||
+                            GetDefinedSymbol(instr) != NULL))) return false;
+
+  CTacConst *c1 = dynamic_cast<CTacConst*>(a);
+  CTacConst *c2 = dynamic_cast<CTacConst*>(b);
+  CTacAddr *res = NULL;
+  EOperation rop = opAssign;
+  int v;
+
+  if ((c1 != NULL) && ((c2 != NULL) || (b == NULL)) &&
+      Fold(op, c1->GetValue(), c2 != NULL ? c2->GetValue() : 0, v)) {
+    res = new CTacConst(v);
+  } else {
+    COperand o1, o2;
+    bool same = GetOperand(a, o1) && GetOperand(b, o2) && (o1 == o2);
+
+    switch (op) {
+      case opAdd:
+        if (IsConst(b, 0)) res = a;
+        break;
+
+      case opSub:
+        if (IsConst(b, 0)) res = a;
+        else if (same) res = new CTacConst(0);
+        else if (IsConst(a, 0)) { rop = opNeg; res = b; }
+        break;
+
+      case opMul:
+        if (IsConst(b, 1)) res = a;
+        else if (IsConst(b, 0)) res = new CTacConst(0);
+        else if (IsConst(b, -1)) { rop = opNeg; res = a; }
+        break;
+
+      case opDiv:
+      case opUDiv:
+        // the division by -1 may trap and is left to the backend
+        if (IsConst(b, 1)) res = a;
+        break;
+
+      case opAnd:
+        if (IsConst(b, 1) || same) res = a;
+        else if (IsConst(b, 0)) res = b;
+        break;
+
+      case opOr:
+        if (IsConst(b, 0) || same) res = a;
+        else if (IsConst(b, 1)) res = b;
+        break;
+
+      case opPos:
+        res = a;
+        break;
+
+      case opNeg:
+      case opNot:
+        {
+          // -(-x), not not b
+          map<const CSymbol*, CTacInstr*>::const_iterator d =
+            _def.find(GetTemp(a));
+          if ((d != _def.end()) && (d->second->GetOperation() == op))
+            res = d->second->GetSrc(1);
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if (res == NULL) return false;
+
+  instr->SetOperation(rop);
+  instr->SetSrc(1, res);
+  instr->SetSrc(2, NULL);
+
+  return true;
+}
+
+/// @brief returns true if @a instr is a link of a chain of @a op operations
+static bool IsChain(const CTacInstr *instr, EOperation op)
+{
+  if (instr->GetOperation() == op) return true;
+
+  // x - c = x + (-c)
+  return (op == opAdd) && (instr->GetOperation() == opSub) &&
+         (dynamic_cast<const CTacConst*>(instr->GetSrc(2)) != NULL);
+}
+
+int CAlgebraicSimplify::Collect(EOperation op, CTacAddr *a,
+                                vector<CTacAddr*> &leaves, int &c) const
+{
+  CTacConst *k = dynamic_cast<CTacConst*>(a);
+  if (k != NULL) {
+    c = op == opAdd ? WrapAdd(c, k->GetValue()) : WrapMul(c, k->GetValue());
+    return 0;
+  }
+
+  // temporaries that are used more than once are only expanded if this
+  // does not duplicate any computation
+  map<const CSymbol*, CTacInstr*>::const_iterator d = _def.find(GetTemp(a));
+  if ((d == _def.end()) || !IsChain(d->second, op)) {
+    leaves.push_back(a);
+    return 0;
+  }
+
+  CTacInstr *def = d->second;
+  CTacAddr *b = def->GetSrc(2);
+  CTacConst *kb = dynamic_cast<CTacConst*>(b);
+
+  map<const CSymbol*, int>::const_iterator u = _nuse.find(d->first);
+  bool shared = (u != _nuse.end()) && (u->second > 1);
+
+  if (shared && (kb == NULL)) {
+    leaves.push_back(a);
+    return 0;
+  }
+
+  if (def->GetOperation() == opSub) b = new CTacConst(WrapMul(kb->GetValue(), -1));
+
+  if (shared) {
+    CTacConst *ka = dynamic_cast<CTacConst*>(def->GetSrc(1));
+    if (ka == NULL) leaves.push_back(def->GetSrc(1));
+    else c = op == opAdd ? WrapAdd(c, ka->GetValue()) : WrapMul(c, ka->GetValue());
+    Collect(op, b, leaves, c);
+    return 1;
+  }
+
+  return 1 + Collect(op, def->GetSrc(1), leaves, c) + Collect(op, b, leaves, c);
+}
+
+bool CAlgebraicSimplify::Reassociate(CCodeBlock *cb, list<CTacInstr*> &code,
+                                     list<CTacInstr*>::iterator pos,
+                                     CTacInstr *instr)
+{
+  EOperation op = instr->GetOperation();
+  CTacAddr *b = instr->GetSrc(2);
+  CTacConst *kb = dynamic_cast<CTacConst*>(b);
+
+  if (op == opSub) {
+    if (kb == NULL) return false;
+    op = opAdd;
+    b = new CTacConst(WrapMul(kb->GetValue(), -1));
+  }
+
+  vector<CTacAddr*> leaves;
+  int c = op == opAdd ? 0 : 1;
+  int n = Collect(op, instr->GetSrc(1), leaves, c) + Collect(op, b, leaves, c);
+
+  // only rewrite the chain if constants have been combined or if its height
+  // can be reduced
+  bool konst = (op == opAdd) ? (c != 0) : (c != 1);
+  if ((n == 0) ||
+      ((leaves.size() - 1 + konst >= (size_t)n + 1) && (leaves.size() < 4)))
+    return false;
+
+  for (size_t l=0; l<leaves.size(); l++) {
+    const CSymbol *t = GetTemp(leaves[l]);
+    if (t != NULL) _nuse[t]++;
+  }
+
+  if ((op == opMul) && (c == 0)) leaves.clear();
+  if (leaves.empty()) {
+    instr->SetOperation(opAssign);
+    instr->SetSrc(1, new CTacConst(c));
+    instr->SetSrc(2, NULL);
+    return true;
+  }
+
+  // combine neighboring operands pairwise; the constant is added last
+  while (leaves.size() > (konst ? 1 : 2)) {
+    vector<CTacAddr*> next;
+    for (size_t l=0; l<leaves.size(); l+=2) {
+      if (l+1 == leaves.size()) {
+        next.push_back(leaves[l]);
+        break;
+      }
+      CTacTemp *t = cb->CreateTemp(CTypeManager::Get()->GetInt());
+      code.insert(pos, new CTacInstr(op, t, leaves[l], leaves[l+1]));
+      next.push_back(t);
+    }
+    leaves.swap(next);
+  }
+
+  if (konst) leaves.push_back(new CTacConst(c));
+
+  if (leaves.size() == 1) {
+    instr->SetOperation(opAssign);
+    instr->SetSrc(1, leaves[0]);
+    instr->SetSrc(2, NULL);
+  } else if ((op == opAdd) && (c < 0) && (c != INT_MIN)) {
+    instr->SetOperation(opSub);
+    instr->SetSrc(1, leaves[0]);
+    instr->SetSrc(2, new CTacConst(-c));
+  } else {
+    instr->SetOperation(op);
+    instr->SetSrc(1, leaves[0]);
+    instr->SetSrc(2, leaves[1]);
+  }
+
+  return true;
+}
+
+void CAlgebraicSimplify::Invalidate(const CSymbol *sym)
+{
+  map<const CSymbol*, CTacAddr*>::iterator c = _copy.begin();
+  while (c != _copy.end()) {
+    const CTacName *n = dynamic_cast<const CTacName*>(c->second);
+    if ((n != NULL) && (n->GetSymbol() == sym)) _copy.erase(c++);
+    else c++;
+  }
+
+  map<const CSymbol*, CTacInstr*>::iterator d = _def.begin();
+  while (d != _def.end()) {
+    vector<const CSymbol*> used;
+    GetUsedSymbols(d->second, used);
+    if (find(used.begin(), used.end(), sym) != used.end()) _def.erase(d++);
+    else d++;
+  }
+}
+
+
+//------------------------------------------------------------------------------
+// CIPConstProp
+//
+CIPConstProp::CIPConstProp(int budget)
+  : CPass("ipcp"), _budget(budget)
+{
+}
+
+bool CIPConstProp::Run(CModule *m)
+{
+  assert(m != NULL);
+  _module = m;
+
+  bool changed = false, found = true;
+
+  while (found) {
+    found = false;
+
+    // call sites in the scopes reachable from the module body
+    CCallGraph cg(m);
+    const vector<CScope*> &scopes = cg.GetScopes();
+    map<const CSymProc*, vector<CCallSite> > calls;
+    vector<CCallSite> sites;
+
+    for (size_t s=0; s<scopes.size(); s++) GetCallSites(scopes[s], sites);
+    for (size_t c=0; c<sites.size(); c++) {
+      const CSymProc *proc = GetCallee(sites[c].call);
+      if (cg.GetScope(proc) != NULL) calls[proc].push_back(sites[c]);
+    }
+
+    // parameters receiving the same constant at all call sites
+    map<const CSymProc*, vector<CCallSite> >::iterator it;
+    for (it=calls.begin(); it!=calls.end(); it++) {
+      const CSymProc *proc = it->first;
+      const vector<CCallSite> &site = it->second;
+      CScope *s = GetScope(proc);
+      vector<bool> cand = GetCandidates(s);
+
+      for (int p=0; p<proc->GetNParams(); p++) {
+        if (!cand[p]) continue;
+
+        bool same = true;
+        CTacConst *c0 = dynamic_cast<CTacConst*>(site[0].args[p]);
+        for (size_t c=0; same && (c<site.size()); c++) {
+          CTacConst *c1 = dynamic_cast<CTacConst*>(site[c].args[p]);
+          same = (c0 != NULL) && (c1 != NULL) &&
+                 (c0->GetValue() == c1->GetValue());
+        }
+
+        if (same && Substitute(s, proc->GetParam(p), c0->GetValue())) {
+          Propagate(s);
+          found = true;
+        }
+      }
+    }
+
+    if (found) {
+      changed = true;
+      continue;
+    }
+
+    // group the call sites by their constant arguments. Call sites with an
+    // existing clone are redirected, the others are candidates for cloning
+    int best = 0;
+    const CSymProc *best_proc = NULL;
+    CConstArgs best_args;
+
+    for (it=calls.begin(); it!=calls.end(); it++) {
+      const CSymProc *proc = it->first;
+      CScope *s = GetScope(proc);
+      vector<bool> cand = GetCandidates(s, true);
+      map<CConstArgs, int> weight;
+
+      for (size_t c=0; c<it->second.size(); c++) {
+        const CCallSite &site = it->second[c];
+        const CSymProc *caller =
+          dynamic_cast<const CSymProc*>(site.caller->GetDeclaration());
+        CConstArgs args;
+
+        for (int p=0; p<proc->GetNParams(); p++) {
+          CTacConst *a = dynamic_cast<CTacConst*>(site.args[p]);
+          if (cand[p] && (a != NULL)) args[p] = a->GetValue();
+        }
+        if (args.empty()) continue;
+
+        map<pair<const CSymProc*, CConstArgs>, CSymProc*>::iterator clone =
+          _clones.find(make_pair(proc, args));
+        if (clone != _clones.end()) {
+          site.call->SetSrc(1, new CTacName(clone->second));
+          found = true;
+        } else if ((caller != proc) && (_origin[caller] != proc)) {
+          // recursive calls are not specialized any further
+          weight[args] += site.weight;
+        }
+      }
+
+      int size = (int)s->GetCodeBlock()->GetInstr().size();
+      map<CConstArgs, int>::iterator w;
+      for (w=weight.begin(); w!=weight.end(); w++) {
+        if ((w->second > best) && (size <= _budget)) {
+          best = w->second;
+          best_proc = proc;
+          best_args = w->first;
+        }
+      }
+    }
+
+    // clone the procedure for the most frequent arguments; the call sites
+    // are redirected in the next round
+    if (!found && (best_proc != NULL)) {
+      CProcedure *proc = dynamic_cast<CProcedure*>(GetScope(best_proc));
+      assert(proc != NULL);
+
+      ostringstream name;
+      name << best_proc->GetName() << ".constprop." << _clones.size();
+
+      CProcedure *clone = new CProcedure(proc, name.str());
+      const CSymProc *decl =
+        dynamic_cast<const CSymProc*>(clone->GetDeclaration());
+      _clones[make_pair(best_proc, best_args)] = const_cast<CSymProc*>(decl);
+      _origin[decl] = best_proc;
+      _budget -= (int)proc->GetCodeBlock()->GetInstr().size();
+
+      CConstArgs::iterator a;
+      for (a=best_args.begin(); a!=best_args.end(); a++) {
+        Substitute(clone, decl->GetParam(a->first), a->second);
+      }
+      Propagate(clone);
+
+      found = true;
+    }
+
+    changed = changed || found;
+  }
+
+  return changed;
+}
+
+void CIPConstProp::GetCallSites(CScope *s, vector<CCallSite> &sites) const
+{
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  vector<CTacInstr*> code(instr.begin(), instr.end());
+
+  // loop nesting depth: the code between a label and a backward branch to
+  // it forms a loop
+  map<const CTac*, size_t> pos;
+  vector<int> depth(code.size() + 1, 0);
+
+  for (size_t i=0; i<code.size(); i++) {
+    if (code[i]->GetOperation() == opLabel) pos[code[i]] = i;
+    if (code[i]->IsBranch() && (pos.count(code[i]->GetDest()) > 0)) {
+      depth[pos[code[i]->GetDest()]]++;
+      depth[i+1]--;
+    }
+  }
+  for (size_t i=1; i<code.size(); i++) depth[i] += depth[i-1];
+
+  list<CTacInstr*>::const_iterator it = instr.begin();
+  for (size_t i=0; i<code.size(); i++, it++) {
+    if (code[i]->GetOperation() != opCall) continue;
+
+    CCallSite site;
+    site.caller = s;
+    site.call = code[i];
+    site.weight = 1;
+    for (int d=0; (d<depth[i]) && (d<4); d++) site.weight *= 10;
+
+    vector<CTacInstr*> params;
+    GetParams(instr.begin(), it, params);
+    for (size_t p=0; p<params.size(); p++) {
+      site.args.push_back(params[p] != NULL ? params[p]->GetSrc(1) : NULL);
+    }
+
+    sites.push_back(site);
+  }
+}
+
+vector<bool> CIPConstProp::GetCandidates(CScope *s, bool fold) const
+{
+  const CSymProc *proc = dynamic_cast<const CSymProc*>(s->GetDeclaration());
+  assert(proc != NULL);
+
+  vector<bool> read(proc->GetNParams(), false);
+  vector<bool> written(proc->GetNParams(), false);
+  map<const CSymbol*, int> index;
+
+  for (int p=0; p<proc->GetNParams(); p++) {
+    const CType *t = proc->GetParam(p)->GetDataType();
+    if (t->IsScalar() && !t->IsPointer()) index[proc->GetParam(p)] = p;
+  }
+
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    const CSymbol *def = GetDefinedSymbol(*it);
+    if (index.count(def) > 0) written[index[def]] = true;
+
+    // the unary and binary operations precede opAssign
+    EOperation op = (*it)->GetOperation();
+    if (fold && !IsRelOp(op) && (op >= opAssign)) continue;
+
+    vector<const CSymbol*> used;
+    GetUsedSymbols(*it, used);
+    for (size_t u=0; u<used.size(); u++) {
+      if (index.count(used[u]) > 0) read[index[used[u]]] = true;
+    }
+  }
+
+  vector<bool> cand(proc->GetNParams(), false);
+  for (int p=0; p<proc->GetNParams(); p++) {
+    cand[p] = (index.count(proc->GetParam(p)) > 0) && read[p] && !written[p];
+  }
+
+  return cand;
+}
+
+bool CIPConstProp::Substitute(CScope *s, const CSymbol *param, int value)
+{
+  bool changed = false;
+
+  const list<CTacInstr*> &instr = s->GetCodeBlock()->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    if ((*it)->GetOperation() == opCall) continue;
+
+    for (int i=1; i<=2; i++) {
+      CTacName *n = dynamic_cast<CTacName*>((*it)->GetSrc(i));
+      if ((n != NULL) && (dynamic_cast<CTacReference*>(n) == NULL) &&
+          (n->GetSymbol() == param)) {
+        (*it)->SetSrc(i, new CTacConst(value));
+        changed = true;
+      }
+    }
+  }
+
+  return changed;
+}
+
+bool CIPConstProp::Propagate(CScope *s)
+{
+  CCodeBlock *cb = s->GetCodeBlock();
+  list<CTacInstr*> instr(cb->GetInstr()), code;
+  list<CTacInstr*>::iterator it;
+  bool changed = false;
+
+  // temporaries are assigned once, except for the results of boolean
+  // expressions
+  map<const CSymbol*, int> ndef;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    CTacTemp *t = dynamic_cast<CTacTemp*>((*it)->GetDest());
+    if (t != NULL) ndef[t->GetSymbol()]++;
+  }
+
+  map<const CSymbol*, int> value;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    CTacInstr *i = *it;
+    EOperation op = i->GetOperation();
+
+    if ((op != opCall) && (op != opAddress)) {
+      for (int k=1; k<=2; k++) {
+        CTacTemp *t = dynamic_cast<CTacTemp*>(i->GetSrc(k));
+        if ((t != NULL) && (value.count(t->GetSymbol()) > 0)) {
+          i->SetSrc(k, new CTacConst(value[t->GetSymbol()]));
+          changed = true;
+        }
+      }
+    }
+
+    CTacConst *c1 = dynamic_cast<CTacConst*>(i->GetSrc(1));
+    CTacConst *c2 = dynamic_cast<CTacConst*>(i->GetSrc(2));
+    int v;
+
+    if (IsRelOp(op)) {
+      if ((c1 != NULL) && (c2 != NULL)) {
+        changed = true;
+        if (!Compare(op, c1->GetValue(), c2->GetValue())) {
+          delete i;
+          continue;
+        }
+        i->SetOperation(opGoto);
+        i->SetSrc(1, NULL);
+        i->SetSrc(2, NULL);
+      }
+    } else if ((c1 != NULL) && ((c2 != NULL) || (i->GetSrc(2) == NULL)) &&
+               Fold(op, c1->GetValue(), c2 != NULL ? c2->GetValue() : 0, v)) {
+      if (op != opAssign) {
+        i->SetOperation(opAssign);
+        i->SetSrc(1, new CTacConst(v));
+        i->SetSrc(2, NULL);
+        changed = true;
+      }
+
+      CTacTemp *t = dynamic_cast<CTacTemp*>(i->GetDest());
+      if ((t != NULL) && (ndef[t->GetSymbol()] == 1)) value[t->GetSymbol()] = v;
+    }
+
+    code.push_back(i);
+  }
+
+  cb->SetInstr(code);
+
+  return changed;
+}
+
+
+//------------------------------------------------------------------------------
+// CValueRange
+//
+CValueRange::CValueRange(void)
+  : CPass("vrp")
+{
+}
+
+bool CValueRange::RunOnScope(CScope *s)
+{
+  CCfg cfg(s->GetCodeBlock());
+  bool changed = false, branches = false;
+
+  Analyze(&cfg);
+
+  vector<CBasicBlock*> blocks(cfg.GetBlocks());
+  for (size_t b=0; b<blocks.size(); b++) {
+    CBasicBlock *bb = blocks[b];
+    CFacts f = _in[bb];
+    if (!f.reached) continue;
+
+    list<CTacInstr*> &instr = bb->GetInstr();
+    list<CTacInstr*>::iterator it = instr.begin();
+    CTacInstr *br = bb->GetTerminator();
+
+    while ((it != instr.end()) && (*it != br)) {
+      CTacInstr *i = *it;
+      EOperation op = i->GetOperation();
+
+      // divisions of non-negative values
+      if ((op == opDiv) && (GetRange(f, i->GetSrc(1)).lo >= 0) &&
+          (GetRange(f, i->GetSrc(2)).lo >= 0)) {
+        i->SetOperation(opUDiv);
+        changed = true;
+      }
+
+      // computations with a constant result
+      const CSymbol *base;
+      long long ofs;
+      if ((GetVar(dynamic_cast<CTacAddr*>(i->GetDest())) != NULL) &&
+          ((op <= opNot) || (op == opUDiv) ||
+           ((op == opAssign) && (GetVar(i->GetSrc(1)) != NULL)))) {
+        CRange r = Evaluate(f, i, base, ofs);
+        if (r.lo == r.hi) {
+          i->SetOperation(opAssign);
+          i->SetSrc(1, new CTacConst((int)r.lo));
+          i->SetSrc(2, NULL);
+          changed = true;
+        }
+      }
+
+      Transfer(f, instr, it);
+      it++;
+    }
+
+    // conditional branches with an infeasible edge
+    if ((br != NULL) && IsRelOp(br->GetOperation()) &&
+        (bb->GetTarget() != bb->GetFallthrough())) {
+      CFacts t = f, e = f;
+      Assume(t, br->GetOperation(), br->GetSrc(1), br->GetSrc(2));
+      Assume(e, InvertRelOp(br->GetOperation()), br->GetSrc(1), br->GetSrc(2));
+
+      if (!t.reached || !e.reached) {
+        cfg.RemoveBranch(bb, t.reached ? bb->GetTarget() : bb->GetFallthrough());
+        branches = true;
+      }
+    }
+  }
+
+  if (branches) cfg.Update();
+  cfg.Commit();
+
+  _in.clear();
+  _edge.clear();
+
+  return changed || branches;
+}
+
+void CValueRange::Analyze(CCfg *cfg)
+{
+  _in.clear();
+  _edge.clear();
+
+  const vector<CBasicBlock*> &blocks = cfg->GetBlocks();
+  const vector<CLoop*> &loops = cfg->GetLoops();
+
+  set<const CBasicBlock*> headers;
+  for (size_t l=0; l<loops.size(); l++) headers.insert(loops[l]->GetHeader());
+
+  map<const CBasicBlock*, int> visits;
+  bool iterate = true;
+  int narrow = 2;
+
+  // widening at the loop headers (and at blocks visited suspiciously
+  // often) until a fixpoint is reached, then narrowing rounds that
+  // recompute all blocks from their predecessors
+  while (iterate || (narrow > 0)) {
+    bool widen = iterate;
+    if (!iterate) narrow--;
+    iterate = false;
+
+    for (size_t b=0; b<blocks.size(); b++) {
+      CBasicBlock *bb = blocks[b];
+      CFacts f;
+      f.reached = (bb == cfg->GetEntry());
+
+      const vector<CBasicBlock*> &pred = bb->GetPred();
+      for (size_t p=0; p<pred.size(); p++) {
+        map<pair<const CBasicBlock*, const CBasicBlock*>, CFacts>::iterator e =
+          _edge.find(make_pair(pred[p], bb));
+        if (e != _edge.end()) f = Join(f, e->second);
+      }
+
+      bool seen = visits[bb] > 0;
+      if (widen && seen) {
+        f = Join(_in[bb], f);
+        if ((headers.find(bb) != headers.end()) || (visits[bb] > 8)) {
+          Widen(_in[bb], f);
+        }
+      }
+
+      if (seen && Equal(_in[bb], f)) continue;
+
+      _in[bb] = f;
+      visits[bb]++;
+      if (widen) iterate = true;
+
+      Propagate(bb, f);
+    }
+  }
+}
+
+bool CValueRange::GetRange(CBasicBlock *bb, const CTacInstr *instr,
+                           const CTacAddr *a, long long &lo, long long &hi) const
+{
+  CFacts f = FactsAt(bb, instr);
+  CRange r = GetRange(f, a);
+
+  lo = r.lo;
+  hi = r.hi;
+
+  return f.reached;
+}
+
+bool CValueRange::InRange(CBasicBlock *bb, const CTacInstr *instr,
+                          const CTacAddr *index, const CTacAddr *bound) const
+{
+  CFacts f = FactsAt(bb, instr);
+
+  return f.reached && (GetRange(f, index).lo >= 0) &&
+         (Bound(f, index, bound) <= -1);
+}
+
+CValueRange::CFacts CValueRange::FactsAt(CBasicBlock *bb,
+                                         const CTacInstr *instr) const
+{
+  CFacts f;
+  f.reached = false;
+
+  map<const CBasicBlock*, CFacts>::const_iterator in = _in.find(bb);
+  if (in == _in.end()) return f;
+  f = in->second;
+
+  const list<CTacInstr*> &code = bb->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+  for (it=code.begin(); (it!=code.end()) && (*it != instr); it++) {
+    Transfer(f, code, it);
+  }
+
+  return f;
+}
+
+void CValueRange::Propagate(CBasicBlock *bb, CFacts f)
+{
+  list<CTacInstr*> &instr = bb->GetInstr();
+  CTacInstr *br = bb->GetTerminator();
+
+  list<CTacInstr*>::const_iterator it;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    if (*it != br) Transfer(f, instr, it);
+  }
+
+  CBasicBlock *target = bb->GetTarget(), *fall = bb->GetFallthrough();
+  if ((br != NULL) && (br->GetOperation() == opReturn)) return;
+
+  if ((br != NULL) && IsRelOp(br->GetOperation()) && (target != fall)) {
+    CFacts t = f;
+    Assume(t, br->GetOperation(), br->GetSrc(1), br->GetSrc(2));
+    _edge[make_pair(bb, target)] = t;
+    Assume(f, InvertRelOp(br->GetOperation()), br->GetSrc(1), br->GetSrc(2));
+  }
+
+  if (fall != NULL) _edge[make_pair(bb, fall)] = f;
+}
+
+const CSymbol* CValueRange::GetVar(const CTacAddr *a) const
+{
+  const CTacName *n = dynamic_cast<const CTacName*>(a);
+  if ((n == NULL) || (dynamic_cast<const CTacReference*>(n) != NULL))
+    return NULL;
+
+  const CSymbol *sym = n->GetSymbol();
+  return IsScalarVar(sym) && sym->GetDataType()->IsInt() ? sym : NULL;
+}
+
+CValueRange::CRange CValueRange::GetRange(const CFacts &f,
+                                          const CTacAddr *a) const
+{
+  CRange r = { INT_MIN, INT_MAX };
+
+  const CTacConst *c = dynamic_cast<const CTacConst*>(a);
+  if (c != NULL) {
+    r.lo = r.hi = c->GetValue();
+    return r;
+  }
+
+  const CSymbol *sym = GetVar(a);
+  if (sym != NULL) {
+    map<const CSymbol*, CRange>::const_iterator it = f.range.find(sym);
+    if (it != f.range.end()) r = it->second;
+  }
+
+  return r;
+}
+
+void CValueRange::SetRange(CFacts &f, const CSymbol *sym, CRange r) const
+{
+  if ((r.lo <= INT_MIN) && (r.hi >= INT_MAX)) f.range.erase(sym);
+  else f.range[sym] = r;
+}
+
+long long CValueRange::Bound(const CFacts &f, const CTacAddr *a,
+                             const CTacAddr *b) const
+{
+  const CSymbol *sa = GetVar(a), *sb = GetVar(b);
+  if ((sa != NULL) && (sa == sb)) return 0;
+
+  long long bound = GetRange(f, a).hi - GetRange(f, b).lo;
+
+  if ((sa != NULL) && (sb != NULL)) {
+    map<pair<const CSymbol*, const CSymbol*>, long long>::const_iterator it =
+      f.diff.find(make_pair(sa, sb));
+    if (it != f.diff.end()) bound = min(bound, it->second);
+  }
+
+  return bound;
+}
+
+void CValueRange::Assume(CFacts &f, const CTacAddr *a, const CTacAddr *b,
+                         long long c) const
+{
+  if (!f.reached) return;
+
+  // b - a >= -c must be possible
+  if (Bound(f, b, a) < -c) {
+    f.reached = false;
+    return;
+  }
+
+  const CSymbol *sa = GetVar(a), *sb = GetVar(b);
+  CRange ra = GetRange(f, a), rb = GetRange(f, b);
+
+  if (sa == sb) return;
+
+  if (sa != NULL) {
+    ra.hi = min(ra.hi, rb.hi + c);
+    SetRange(f, sa, ra);
+  }
+  if (sb != NULL) {
+    rb.lo = max(rb.lo, ra.lo - c);
+    SetRange(f, sb, rb);
+  }
+
+  if ((sa != NULL) && (sb != NULL)) Relate(f, sa, sb, c);
+}
+
+void CValueRange::Relate(CFacts &f, const CSymbol *a, const CSymbol *b,
+                         long long c) const
+{
+  map<pair<const CSymbol*, const CSymbol*>, long long> derived;
+  map<pair<const CSymbol*, const CSymbol*>, long long>::iterator it;
+
+  derived[make_pair(a, b)] = c;
+
+  // a - b <= c and b - x <= d imply a - x <= c + d, etc.
+  for (it=f.diff.begin(); it!=f.diff.end(); it++) {
+    if ((it->first.first == b) && (it->first.second != a))
+      derived[make_pair(a, it->first.second)] = c + it->second;
+    if ((it->first.second == a) && (it->first.first != b))
+      derived[make_pair(it->first.first, b)] = it->second + c;
+  }
+
+  for (it=derived.begin(); it!=derived.end(); it++) {
+    if ((f.diff.find(it->first) == f.diff.end()) ||
+        (f.diff[it->first] > it->second)) f.diff[it->first] = it->second;
+  }
+}
+
+void CValueRange::Assume(CFacts &f, EOperation op, const CTacAddr *a,
+                         const CTacAddr *b) const
+{
+  switch (op) {
+    case opLessThan:    Assume(f, a, b, -1); break;
+    case opLessEqual:   Assume(f, a, b, 0); break;
+    case opBiggerThan:  Assume(f, b, a, -1); break;
+    case opBiggerEqual: Assume(f, b, a, 0); break;
+
+    case opEqual:
+      Assume(f, a, b, 0);
+      Assume(f, b, a, 0);
+      break;
+
+    case opNotEqual:
+    {
+      if (!f.reached) return;
+      if ((Bound(f, a, b) <= 0) && (Bound(f, b, a) <= 0)) {
+        f.reached = false;
+        return;
+      }
+
+      // exclude a constant value at the border of the other range
+      for (int k=0; k<2; k++) {
+        const CTacAddr *x = k == 0 ? a : b, *y = k == 0 ? b : a;
+        const CSymbol *sx = GetVar(x);
+        CRange rx = GetRange(f, x), ry = GetRange(f, y);
+
+        if ((sx == NULL) || (ry.lo != ry.hi)) continue;
+        if (rx.lo == ry.lo) rx.lo++;
+        if (rx.hi == ry.lo) rx.hi--;
+        SetRange(f, sx, rx);
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+void CValueRange::Transfer(CFacts &f, const list<CTacInstr*> &code,
+                           list<CTacInstr*>::const_iterator pos) const
+{
+  const CTacInstr *instr = *pos;
+
+  if (!f.reached) return;
+
+  EOperation op = instr->GetOperation();
+  const CSymbol *def = GetDefinedSymbol(instr);
+
+  // calls may modify global variables
+  if (op == opCall) {
+    const CSymProc *callee = GetCallee(instr);
+    vector<const CSymbol*> kill;
+
+    map<const CSymbol*, CRange>::iterator it;
+    for (it=f.range.begin(); it!=f.range.end(); it++) {
+      if ((it->first->GetSymbolType() == stGlobal) &&
+          CallMayModify(callee, it->first)) kill.push_back(it->first);
+    }
+
+    map<pair<const CSymbol*, const CSymbol*>, long long>::iterator d;
+    for (d=f.diff.begin(); d!=f.diff.end(); d++) {
+      for (int k=0; k<2; k++) {
+        const CSymbol *sym = k == 0 ? d->first.first : d->first.second;
+        if ((sym->GetSymbolType() == stGlobal) && CallMayModify(callee, sym))
+          kill.push_back(sym);
+      }
+    }
+
+    for (size_t k=0; k<kill.size(); k++) Kill(f, kill[k]);
+  }
+
+  // an executed check guarantees 0 <= index < dimension
+  if (op == opCheck) {
+    const CSymbol *sym = GetVar(instr->GetSrc(1));
+    if (sym != NULL) {
+      CRange r = GetRange(f, instr->GetSrc(1));
+      r.lo = max(r.lo, 0LL);
+      SetRange(f, sym, r);
+    }
+    Assume(f, instr->GetSrc(1), instr->GetSrc(2), -1);
+    return;
+  }
+
+  if (def == NULL) return;
+  if (GetVar(dynamic_cast<CTacAddr*>(instr->GetDest())) == NULL) {
+    Kill(f, def);
+    return;
+  }
+
+  const CSymbol *base;
+  long long ofs;
+  CRange r = Evaluate(f, instr, base, ofs);
+
+  map<pair<const CSymbol*, const CSymbol*>, long long> diff;
+  map<pair<const CSymbol*, const CSymbol*>, long long>::iterator it;
+
+  if (base == def) {
+    // def = def + ofs: shift the bounds of the differences
+    for (it=f.diff.begin(); it!=f.diff.end(); it++) {
+      if (it->first.first == def) diff[it->first] = it->second + ofs;
+      else if (it->first.second == def) diff[it->first] = it->second - ofs;
+      else diff[it->first] = it->second;
+    }
+    f.diff = diff;
+  } else {
+    Kill(f, def);
+
+    if (base != NULL) {
+      // def = base + ofs: inherit the facts of base
+      for (it=f.diff.begin(); it!=f.diff.end(); it++) {
+        if (it->first.first == base)
+          diff[make_pair(def, it->first.second)] = it->second + ofs;
+        else if (it->first.second == base)
+          diff[make_pair(it->first.first, def)] = it->second - ofs;
+      }
+      diff[make_pair(def, base)] = ofs;
+      diff[make_pair(base, def)] = -ofs;
+      f.diff.insert(diff.begin(), diff.end());
+    }
+  }
+
+  SetRange(f, def, r);
+
+  // calls of DIM with the same arguments return the same value
+  vector<CTacInstr*> params;
+  if ((op == opCall) && (GetCallee(instr)->GetName() == "DIM") &&
+      GetCallee(instr)->IsExternal() && GetParams(code.begin(), pos, params)) {
+    const CTacName *n = dynamic_cast<const CTacName*>(params[0]->GetSrc(1));
+    const CTacConst *k = dynamic_cast<const CTacConst*>(params[1]->GetSrc(1));
+
+    if ((n != NULL) && (dynamic_cast<const CTacReference*>(n) == NULL) &&
+        (k != NULL)) {
+      pair<const CSymbol*, int> key(n->GetSymbol(), k->GetValue());
+
+      map<const CSymbol*, pair<const CSymbol*, int> >::iterator d;
+      for (d=f.dim.begin(); d!=f.dim.end(); d++) {
+        if (d->second != key) continue;
+        Relate(f, def, d->first, 0);
+        Relate(f, d->first, def, 0);
+      }
+      f.dim[def] = key;
+    }
+  }
+}
+
+CValueRange::CRange CValueRange::Evaluate(const CFacts &f,
+                                          const CTacInstr *instr,
+                                          const CSymbol *&base,
+                                          long long &ofs) const
+{
+  EOperation op = instr->GetOperation();
+  CTacAddr *a = instr->GetSrc(1), *b = instr->GetSrc(2);
+  CRange any = { INT_MIN, INT_MAX }, r = any, ra, rb;
+
+  base = NULL;
+  ofs = 0;
+
+  switch (op) {
+    case opAssign:
+    case opPos:
+      r = GetRange(f, a);
+      base = GetVar(a);
+      break;
+
+    case opNeg:
+      ra = GetRange(f, a);
+      r.lo = -ra.hi;
+      r.hi = -ra.lo;
+      break;
+
+    case opAdd:
+    case opSub:
+      ra = GetRange(f, a);
+      rb = GetRange(f, b);
+      if (op == opSub) {
+        swap(rb.lo, rb.hi);
+        rb.lo = -rb.lo;
+        rb.hi = -rb.hi;
+      }
+      r.lo = ra.lo + rb.lo;
+      r.hi = ra.hi + rb.hi;
+
+      if (rb.lo == rb.hi) { base = GetVar(a); ofs = rb.lo; }
+      else if ((op == opAdd) && (ra.lo == ra.hi)) { base = GetVar(b); ofs = ra.lo; }
+      break;
+
+    case opMul:
+    case opDiv:
+    case opUDiv:
+    {
+      ra = GetRange(f, a);
+      rb = GetRange(f, b);
+
+      // the divisor must not change its sign; unsigned divisions are
+      // evaluated as signed ones for non-negative operands only
+      if ((op != opMul) && (rb.lo <= 0) && (rb.hi >= 0)) return any;
+      if ((op == opUDiv) && ((ra.lo < 0) || (rb.lo < 0))) return any;
+
+      long long v[4];
+      for (int k=0; k<4; k++) {
+        long long x = k < 2 ? ra.lo : ra.hi, y = k % 2 == 0 ? rb.lo : rb.hi;
+        v[k] = op == opMul ? x * y : x / y;
+      }
+      r.lo = min(min(v[0], v[1]), min(v[2], v[3]));
+      r.hi = max(max(v[0], v[1]), max(v[2], v[3]));
+      break;
+    }
+
+    case opCall:
+    {
+      // array dimensions are non-negative
+      const CSymProc *callee = GetCallee(instr);
+      if (callee->IsExternal() && (callee->GetName() == "DIM")) r.lo = 0;
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  // results that may wrap around are unknown
+  if ((r.lo < INT_MIN) || (r.hi > INT_MAX)) {
+    base = NULL;
+    return any;
+  }
+
+  return r;
+}
+
+void CValueRange::Kill(CFacts &f, const CSymbol *sym) const
+{
+  f.range.erase(sym);
+  f.dim.erase(sym);
+
+  map<const CSymbol*, pair<const CSymbol*, int> >::iterator d = f.dim.begin();
+  while (d != f.dim.end()) {
+    if (d->second.first == sym) f.dim.erase(d++);
+    else d++;
+  }
+
+  map<pair<const CSymbol*, const CSymbol*>, long long>::iterator it;
+  it = f.diff.begin();
+  while (it != f.diff.end()) {
+    if ((it->first.first == sym) || (it->first.second == sym)) f.diff.erase(it++);
+    else it++;
+  }
+}
+
+CValueRange::CFacts CValueRange::Join(const CFacts &a, const CFacts &b) const
+{
+  if (!a.reached) return b;
+  if (!b.reached) return a;
+
+  CFacts f;
+  f.reached = true;
+
+  map<const CSymbol*, CRange>::const_iterator r, s;
+  for (r=a.range.begin(); r!=a.range.end(); r++) {
+    s = b.range.find(r->first);
+    if (s == b.range.end()) continue;
+
+    CRange h = { min(r->second.lo, s->second.lo), max(r->second.hi, s->second.hi) };
+    SetRange(f, r->first, h);
+  }
+
+  map<pair<const CSymbol*, const CSymbol*>, long long>::const_iterator d, e;
+  for (d=a.diff.begin(); d!=a.diff.end(); d++) {
+    e = b.diff.find(d->first);
+    if (e != b.diff.end()) f.diff[d->first] = max(d->second, e->second);
+  }
+
+  map<const CSymbol*, pair<const CSymbol*, int> >::const_iterator m, n;
+  for (m=a.dim.begin(); m!=a.dim.end(); m++) {
+    n = b.dim.find(m->first);
+    if ((n != b.dim.end()) && (n->second == m->second)) f.dim.insert(*m);
+  }
+
+  return f;
+}
+
+void CValueRange::Widen(const CFacts &old, CFacts &f) const
+{
+  if (!old.reached) return;
+
+  map<const CSymbol*, CRange>::iterator r;
+  map<const CSymbol*, CRange>::const_iterator o;
+  vector<const CSymbol*> any;
+
+  for (r=f.range.begin(); r!=f.range.end(); r++) {
+    o = old.range.find(r->first);
+    if (o == old.range.end()) continue;
+
+    if (r->second.lo < o->second.lo) r->second.lo = INT_MIN;
+    if (r->second.hi > o->second.hi) r->second.hi = INT_MAX;
+    if ((r->second.lo == INT_MIN) && (r->second.hi == INT_MAX))
+      any.push_back(r->first);
+  }
+  for (size_t k=0; k<any.size(); k++) f.range.erase(any[k]);
+
+  map<pair<const CSymbol*, const CSymbol*>, long long>::iterator d;
+  map<pair<const CSymbol*, const CSymbol*>, long long>::const_iterator e;
+  d = f.diff.begin();
+  while (d != f.diff.end()) {
+    e = old.diff.find(d->first);
+    if ((e != old.diff.end()) && (d->second > e->second)) f.diff.erase(d++);
+    else d++;
+  }
+}
+
+bool CValueRange::Equal(const CFacts &a, const CFacts &b) const
+{
+  if (a.reached != b.reached) return false;
+  if ((a.diff != b.diff) || (a.dim != b.dim)) return false;
+  if (a.range.size() != b.range.size()) return false;
+
+  map<const CSymbol*, CRange>::const_iterator r, s;
+  for (r=a.range.begin(), s=b.range.begin(); r!=a.range.end(); r++, s++) {
+    if ((r->first != s->first) || (r->second.lo != s->second.lo) ||
+        (r->second.hi != s->second.hi)) return false;
+  }
+
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+// CBoundsCheckElim
+//
+CBoundsCheckElim::CBoundsCheckElim(void)
+  : CPass("bounds-check-elim")
+{
+}
+
+bool CBoundsCheckElim::RunOnScope(CScope *s)
+{
+  CCfg cfg(s->GetCodeBlock());
+  bool changed = RemoveInRange(&cfg), found = true;
+
+  // innermost loops first. Checks hoisted in front of an inner loop may
+  // be hoisted out of the enclosing loop in the next round.
+  while (found) {
+    found = false;
+
+    const vector<CLoop*> &loops = cfg.GetLoops();
+    for (size_t l=0; !found && (l<loops.size()); l++) {
+      found = Hoist(&cfg, loops[l]);
+    }
+    changed = changed || found;
+  }
+
+  changed = RemoveRedundant(&cfg) || changed;
+  cfg.Commit();
+
+  return changed;
+}
+
+bool CBoundsCheckElim::RemoveInRange(CCfg *cfg)
+{
+  _ranges.Analyze(cfg);
+
+  // the checks are removed after all queries; the facts refer to the
+  // unmodified code
+  const vector<CBasicBlock*> &blocks = cfg->GetBlocks();
+  vector<pair<CBasicBlock*, CTacInstr*> > checks;
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    const list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    list<CTacInstr*>::const_iterator it;
+    for (it=instr.begin(); it!=instr.end(); it++) {
+      if (((*it)->GetOperation() == opCheck) &&
+          _ranges.InRange(blocks[b], *it, (*it)->GetSrc(1), (*it)->GetSrc(2)))
+        checks.push_back(make_pair(blocks[b], *it));
+    }
+  }
+
+  for (size_t c=0; c<checks.size(); c++) {
+    checks[c].first->GetInstr().remove(checks[c].second);
+    delete checks[c].second;
+  }
+
+  return !checks.empty();
+}
+
+bool CBoundsCheckElim::Hoist(CCfg *cfg, CLoop *l)
+{
+  const vector<CBasicBlock*> &blocks = l->GetBlocks();
+  CBasicBlock *header = l->GetHeader();
+
+  // only checks executed in every iteration are hoisted, i.e., checks
+  // dominating all blocks leaving the loop
+  vector<CBasicBlock*> exits;
+  for (size_t b=0; b<blocks.size(); b++) {
+    const vector<CBasicBlock*> &succ = blocks[b]->GetSucc();
+    bool exit = (blocks[b]->GetFallthrough() == NULL);
+    for (size_t s=0; s<succ.size(); s++) exit = exit || !l->Contains(succ[s]);
+    if (exit) exits.push_back(blocks[b]);
+  }
+  if (exits.empty()) return false;
+
+  // checks of the induction variable require the value of the variable in
+  // the last iteration. Without a constant trip count, it is only computed
+  // for unit steps.
+  const CSymbol *iv = l->GetInductionVar();
+  CTacAddr *bound = l->GetBound();
+  int step = l->GetStep(), init, trip;
+  EOperation cond = l->GetCondition();
+  bool known = l->GetTripCount(trip) && l->GetInitial(init);
+
+  if (!known &&
+      !((step == 1) && ((cond == opLessThan) || (cond == opLessEqual))) &&
+      !((step == -1) && ((cond == opBiggerThan) || (cond == opBiggerEqual))))
+    iv = NULL;
+
+  CBasicBlock *ivbb = NULL;
+  int ividx = 0;
+  for (size_t b=0; (iv != NULL) && (b<blocks.size()); b++) {
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    int idx = 0;
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++, idx++) {
+      if (GetDefinedSymbol(*it) == iv) {
+        ivbb = blocks[b];
+        ividx = idx;
+      }
+    }
+  }
+
+  // checks of the induction variable are moved in front of earlier
+  // iterations and only hoisted out of loops without observable effects
+  bool effects = false;
+  for (size_t b=0; !effects && (b<blocks.size()); b++) {
+    const list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    list<CTacInstr*>::const_iterator it;
+    for (it=instr.begin(); !effects && (it!=instr.end()); it++) {
+      effects = IsObservable(*it);
+    }
+  }
+
+  // find the checks with an invariant bound whose index is invariant or
+  // the induction variable plus a constant
+  vector<CBasicBlock*> where;
+  vector<list<CTacInstr*>::iterator> which;
+  vector<int> offset;
+  vector<bool> invariant;
+  bool changed = false;
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    CBasicBlock *bb = blocks[b];
+    if (bb->GetLoop() != l) continue;
+
+    bool always = true;
+    for (size_t e=0; e<exits.size(); e++) {
+      always = always && cfg->Dominates(bb, exits[e]);
+    }
+    if (!always) continue;
+
+    list<CTacInstr*> &instr = bb->GetInstr();
+    list<CTacInstr*>::iterator it = instr.begin();
+    int idx = -1;
+
+    while (it != instr.end()) {
+      CTacInstr *chk = *it++;
+      idx++;
+      if ((chk->GetOperation() != opCheck) ||
+          !IsLoopInvariant(l, chk->GetSrc(2))) continue;
+
+      if (IsLoopInvariant(l, chk->GetSrc(1))) {
+        if (effects && ObservableBefore(l, bb, chk)) continue;
+        where.push_back(bb);
+        which.push_back(--list<CTacInstr*>::iterator(it));
+        offset.push_back(0);
+        invariant.push_back(true);
+        continue;
+      }
+
+      const CTacName *n = dynamic_cast<const CTacName*>(chk->GetSrc(1));
+      if ((iv == NULL) || (n == NULL) ||
+          (dynamic_cast<const CTacReference*>(n) != NULL)) continue;
+
+      // the instruction reading the induction variable
+      int ofs = 0, at = idx;
+      if (n->GetSymbol() != iv) {
+        list<CTacInstr*>::iterator d = it;
+        d--;
+        bool found = false;
+        while (!found && (d != instr.begin())) {
+          d--;
+          at--;
+          if (GetDefinedSymbol(*d) == n->GetSymbol()) {
+            found = true;
+            if (!GetIncrement(*d, iv, ofs)) at = -1;
+          }
+        }
+        if (!found || (at < 0)) continue;
+      }
+
+      // before or after the induction variable is incremented
+      bool after;
+      if (bb == ivbb) after = at > ividx;
+      else if (cfg->Dominates(ivbb, bb)) after = true;
+      else if (cfg->Dominates(bb, ivbb)) after = false;
+      else continue;
+      if (after) ofs += step;
+
+      // with constant bounds the check is decided at compile time. Checks
+      // that fail are left where they are.
+      const CTacConst *size = dynamic_cast<const CTacConst*>(chk->GetSrc(2));
+      if (known && (size != NULL)) {
+        long long first = (long long)init + ofs;
+        long long last = (long long)init + (long long)(trip-1)*step + ofs;
+        if ((min(first, last) >= 0) && (max(first, last) < size->GetValue())) {
+          list<CTacInstr*>::iterator d = it;
+          instr.erase(--d);
+          delete chk;
+          changed = true;
+        }
+        continue;
+      }
+
+      if (effects) continue;
+      where.push_back(bb);
+      which.push_back(--list<CTacInstr*>::iterator(it));
+      offset.push_back(ofs);
+      invariant.push_back(false);
+    }
+  }
+
+  if (where.empty()) return changed;
+
+  // invariant checks are moved in front of the loop. For the induction
+  // variable, the values of the index in the first and the last iteration
+  // are checked.
+  bool needlast = false;
+  for (size_t c=0; c<invariant.size(); c++) needlast = needlast || !invariant[c];
+
+  CCodeBlock *cb = cfg->GetCodeBlock();
+  CTacAddr *first = NULL, *last = NULL;
+  CBasicBlock *pre = cfg->GetPreheader(l), *bb = pre;
+
+  if (needlast && known) {
+    first = new CTacConst(init);
+    last = new CTacConst(init + (trip-1)*step);
+  } else if (needlast) {
+    // last = max(first, bound - 1) for 'i < bound', etc.
+    list<CTacInstr*> &code = pre->GetInstr();
+    CTacAddr *e = bound;
+    if (cond == opLessThan) e = Emit(cb, code, opSub, bound, new CTacConst(1));
+    if (cond == opBiggerThan) e = Emit(cb, code, opAdd, bound, new CTacConst(1));
+
+    CTacTemp *t = cb->CreateTemp(CTypeManager::Get()->GetInt());
+    first = new CTacName(iv);
+    code.push_back(new CTacInstr(opAssign, t, e, NULL));
+
+    CBasicBlock *one = cfg->CreateBlock(pre);
+    bb = cfg->CreateBlock(one);
+    code.push_back(new CTacInstr(step > 0 ? opBiggerEqual : opLessEqual,
+                                 cfg->GetLabel(bb), t, first));
+    pre->SetFallthrough(one);
+    one->GetInstr().push_back(new CTacInstr(opAssign, t, first, NULL));
+    one->SetFallthrough(bb);
+    bb->SetFallthrough(header);
+    last = t;
+  }
+
+  list<CTacInstr*> &code = bb->GetInstr();
+  for (size_t c=0; c<which.size(); c++) {
+    CTacInstr *chk = *which[c];
+    where[c]->GetInstr().erase(which[c]);
+
+    if (invariant[c]) {
+      code.push_back(chk);
+      continue;
+    }
+
+    CTacAddr *size = chk->GetSrc(2);
+    code.push_back(new CTacInstr(opCheck, NULL,
+                                 Emit(cb, code, opAdd, first, new CTacConst(offset[c])),
+                                 size));
+    code.push_back(new CTacInstr(opCheck, NULL,
+                                 Emit(cb, code, opAdd, last, new CTacConst(offset[c])),
+                                 size));
+    delete chk;
+  }
+
+  cfg->Update();
+
+  return true;
+}
+
+bool CBoundsCheckElim::RemoveRedundant(CCfg *cfg)
+{
+  const vector<CBasicBlock*> &blocks = cfg->GetBlocks();
+  map<const CBasicBlock*, set<CCheck> > out;
+  bool changed = false, iterate = true;
+
+  // checks performed on all paths to the end of a block. Blocks that have
+  // not been visited yet do not restrict their successors.
+  for (int pass=0; pass<2; pass++) {
+    iterate = true;
+    while (iterate) {
+      iterate = false;
+
+      for (size_t b=0; b<blocks.size(); b++) {
+        CBasicBlock *bb = blocks[b];
+        set<CCheck> avail;
+        bool first = true;
+
+        if (bb != cfg->GetEntry()) {
+          const vector<CBasicBlock*> &pred = bb->GetPred();
+          for (size_t p=0; p<pred.size(); p++) {
+            map<const CBasicBlock*, set<CCheck> >::iterator o = out.find(pred[p]);
+            if (o == out.end()) continue;
+
+            if (first) {
+              avail = o->second;
+              first = false;
+            } else {
+              set<CCheck> both;
+              set_intersection(avail.begin(), avail.end(),
+                               o->second.begin(), o->second.end(),
+                               inserter(both, both.begin()));
+              avail = both;
+            }
+          }
+        }
+
+        // in the second pass, remove checks that are already available or
+        // succeed for constant operands
+        list<CTacInstr*> &instr = bb->GetInstr();
+        list<CTacInstr*>::iterator it = instr.begin();
+        while (it != instr.end()) {
+          CTacInstr *i = *it;
+          CCheck c;
+
+          if ((i->GetOperation() == opCheck) &&
+              GetOperand(i->GetSrc(1), c.first) &&
+              GetOperand(i->GetSrc(2), c.second)) {
+            bool known = (c.first.first == NULL) && (c.second.first == NULL) &&
+                         (c.first.second >= 0) &&
+                         (c.first.second < c.second.second);
+
+            if ((pass == 1) && (known || (avail.find(c) != avail.end()))) {
+              it = instr.erase(it);
+              delete i;
+              changed = true;
+              continue;
+            }
+            avail.insert(c);
+          }
+
+          Kill(i, avail);
+          it++;
+        }
+
+        if ((pass == 0) && ((out.find(bb) == out.end()) || (out[bb] != avail))) {
+          out[bb] = avail;
+          iterate = true;
+        }
+      }
+    }
+  }
+
+  return changed;
+}
+
+void CBoundsCheckElim::Kill(const CTacInstr *instr, set<CCheck> &checks) const
+{
+  const CSymbol *def = GetDefinedSymbol(instr);
+  const CSymProc *callee =
+    instr->GetOperation() == opCall ? GetCallee(instr) : NULL;
+
+  if ((def == NULL) && (callee == NULL)) return;
+
+  set<CCheck>::iterator it = checks.begin();
+  while (it != checks.end()) {
+    const CSymbol *a = it->first.first, *b = it->second.first;
+    bool killed = (def != NULL) && ((a == def) || (b == def));
+
+    if (callee != NULL) {
+      killed = killed || ((a != NULL) && CallMayModify(callee, a)) ||
+                         ((b != NULL) && CallMayModify(callee, b));
+    }
+
+    if (killed) checks.erase(it++);
+    else it++;
+  }
+}
+
+bool CBoundsCheckElim::IsObservable(const CTacInstr *instr) const
+{
+  EOperation op = instr->GetOperation();
+
+  if (op == opCall) return !GetCallee(instr)->IsPure();
+
+  if ((op == opDiv) || (op == opUDiv)) {
+    const CTacConst *c = dynamic_cast<const CTacConst*>(instr->GetSrc(2));
+    return (c == NULL) || (c->GetValue() == 0) || (c->GetValue() == -1);
+  }
+
+  return false;
+}
+
+bool CBoundsCheckElim::ObservableBefore(CLoop *l, CBasicBlock *bb,
+                                        const CTacInstr *chk) const
+{
+  const list<CTacInstr*> &instr = bb->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+  for (it=instr.begin(); *it != chk; it++) {
+    if (IsObservable(*it)) return true;
+  }
+
+  // the blocks reachable from the header without passing through bb.
+  // Blocks only reachable through bb follow an execution of the check.
+  CBasicBlock *header = l->GetHeader();
+  if (bb == header) return false;
+
+  set<CBasicBlock*> seen;
+  vector<CBasicBlock*> work(1, header);
+  seen.insert(header);
+
+  while (!work.empty()) {
+    CBasicBlock *b = work.back();
+    work.pop_back();
+
+    const list<CTacInstr*> &code = b->GetInstr();
+    for (it=code.begin(); it!=code.end(); it++) {
+      if (IsObservable(*it)) return true;
+    }
+
+    const vector<CBasicBlock*> &succ = b->GetSucc();
+    for (size_t s=0; s<succ.size(); s++) {
+      if ((succ[s] != bb) && l->Contains(succ[s]) &&
+          seen.insert(succ[s]).second) work.push_back(succ[s]);
+    }
+  }
+
+  return false;
+}
+
+
+//------------------------------------------------------------------------------
+// CLoopUnswitch
+//
+CLoopUnswitch::CLoopUnswitch(int budget)
+  : CPass("loop-unswitch"), _budget(budget)
+{
+}
+
+bool CLoopUnswitch::RunOnScope(CScope *s)
+{
+  CCfg cfg(s->GetCodeBlock());
+  int budget = _budget;
+  bool changed = false, found = true;
+
+  while (found) {
+    found = false;
+
+    // innermost loops first. Unswitching an inner loop places the hoisted
+    // test into the enclosing loop where it may be unswitched again.
+    const vector<CLoop*> &loops = cfg.GetLoops();
+    for (size_t l=0; !found && (l<loops.size()); l++) {
+      CLoop *loop = loops[l];
+      if (loop->GetSize() > budget) continue;
+
+      const vector<CBasicBlock*> &blocks = loop->GetBlocks();
+      for (size_t b=0; !found && (b<blocks.size()); b++) {
+        CBasicBlock *bb = blocks[b];
+        CTacInstr *br = bb->GetTerminator();
+
+        if ((br == NULL) || !IsRelOp(br->GetOperation())) continue;
+        if ((bb->GetTarget() == bb->GetFallthrough()) ||
+            !loop->Contains(bb->GetTarget()) ||
+            !loop->Contains(bb->GetFallthrough())) continue;
+        if (!IsLoopInvariant(loop, br->GetSrc(1)) ||
+            !IsLoopInvariant(loop, br->GetSrc(2))) continue;
+
+        budget -= loop->GetSize();
+        Unswitch(&cfg, loop, bb);
+        found = changed = true;
+      }
+    }
+  }
+
+  cfg.Commit();
+
+  return changed;
+}
+
+void CLoopUnswitch::Unswitch(CCfg *cfg, CLoop *l, CBasicBlock *bb)
+{
+  CBasicBlock *header = l->GetHeader();
+  CBasicBlock *pre = cfg->GetPreheader(l);
+
+  // the analyses may have been recomputed
+  l = header->GetLoop();
+  assert((l != NULL) && (l->GetHeader() == header));
+
+  // duplicate the loop; the copy is placed right after the original
+  vector<CBasicBlock*> blocks(l->GetBlocks());
+  map<CBasicBlock*, CBasicBlock*> copy;
+  CBasicBlock *after = blocks.back();
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    after = copy[blocks[b]] = cfg->CreateBlock(after);
+  }
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    CBasicBlock *orig = blocks[b], *dup = copy[orig];
+
+    list<CTacInstr*> &instr = orig->GetInstr();
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+      CTacInstr *i = (*it)->Clone();
+      if (IsRelOp(i->GetOperation()) && l->Contains(orig->GetTarget()))
+        i->SetDest(cfg->GetLabel(copy[orig->GetTarget()]));
+      dup->GetInstr().push_back(i);
+    }
+
+    CBasicBlock *ft = orig->GetFallthrough();
+    dup->SetFallthrough((ft != NULL) && l->Contains(ft) ? copy[ft] : ft);
+  }
+
+  // test the condition once in the preheader: the original loop executes
+  // the taken side of the branch, the copy the fall-through side
+  CTacInstr *br = bb->GetTerminator();
+  CTacInstr *test = br->Clone();
+  test->SetDest(cfg->GetLabel(header));
+  pre->GetInstr().push_back(test);
+  pre->SetFallthrough(copy[header]);
+
+  CBasicBlock *taken = bb->GetTarget(), *ft = bb->GetFallthrough();
+  cfg->RemoveBranch(copy[bb], copy[ft]);
+  cfg->RemoveBranch(bb, taken);
+
+  cfg->Update();
+}
+
+
+//------------------------------------------------------------------------------
+// CAffine
+//
+
+CAffine::CAffine(int c)
+  : c(c), self(0), iv(0)
+{
+}
+
+bool CAffine::IsConst(void) const
+{
+  return (self == 0) && (iv == 0) && inv.empty();
+}
+
+void CAffine::Add(const CAffine &a, int factor)
+{
+  c = WrapAdd(c, WrapMul(a.c, factor));
+  self = WrapAdd(self, WrapMul(a.self, factor));
+  iv = WrapAdd(iv, WrapMul(a.iv, factor));
+
+  map<const CSymbol*, int>::const_iterator it = a.inv.begin();
+  while (it != a.inv.end()) {
+    int k = WrapAdd(inv[it->first], WrapMul(it->second, factor));
+    if (k == 0) inv.erase(it->first);
+    else inv[it->first] = k;
+    it++;
+  }
+}
+
+void CAffine::Scale(int factor)
+{
+  CAffine a(*this);
+
+  *this = CAffine();
+  if (factor != 0) Add(a, factor);
+}
+
+
+//------------------------------------------------------------------------------
+// CClosedForm
+//
+CClosedForm::CClosedForm(void)
+  : CPass("closed-form")
+{
+}
+
+bool CClosedForm::RunOnScope(CScope *s)
+{
+  CCfg cfg(s->GetCodeBlock());
+  bool changed = false, found = true;
+
+  while (found) {
+    found = false;
+
+    const vector<CLoop*> &loops = cfg.GetLoops();
+    for (size_t l=0; !found && (l<loops.size()); l++) {
+      found = Replace(&cfg, loops[l]);
+    }
+    changed = changed || found;
+  }
+
+  cfg.Commit();
+  _kept.clear();
+
+  return changed;
+}
+
+bool CClosedForm::Replace(CCfg *cfg, CLoop *l)
+{
+  const CSymbol *iv = l->GetInductionVar();
+  if ((iv == NULL) || (_kept.find(l->GetHeader()) != _kept.end())) return false;
+
+  int step = l->GetStep(), trip, init;
+  EOperation cond = l->GetCondition();
+  bool known = l->GetTripCount(trip);
+  CTacAddr *i0 = l->GetInitial(init) ? (CTacAddr*)new CTacConst(init) :
+                                       (CTacAddr*)new CTacName(iv);
+
+  if (!known &&
+      !((step > 0) && ((cond == opLessThan) || (cond == opLessEqual))) &&
+      !((step < 0) && ((cond == opBiggerThan) || (cond == opBiggerEqual))))
+    return false;
+
+  // the loop must not contain inner loops, calls, or stores. Variables with
+  // more than one definition in the loop have a NULL definition.
+  _block.clear();
+  _index.clear();
+  _def.clear();
+
+  vector<const CSymbol*> defs;
+  const vector<CBasicBlock*> &blocks = l->GetBlocks();
+  for (size_t b=0; b<blocks.size(); b++) {
+    CBasicBlock *bb = blocks[b];
+    if (bb->GetLoop() != l) return false;
+
+    int idx = 0;
+    list<CTacInstr*> &instr = bb->GetInstr();
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+      EOperation op = (*it)->GetOperation();
+      if ((op == opCall) || (op == opParam) || (op == opCheck) ||
+          WritesMemory(*it)) return false;
+
+      _block[*it] = bb;
+      _index[*it] = idx++;
+
+      const CSymbol *sym = GetDefinedSymbol(*it);
+      if (sym == NULL) continue;
+      if (_def.find(sym) == _def.end()) {
+        defs.push_back(sym);
+        _def[sym] = *it;
+      } else {
+        _def[sym] = NULL;
+      }
+    }
+  }
+
+  // variables used after the loop
+  set<const CSymbol*> live;
+  const vector<CBasicBlock*> &all = cfg->GetBlocks();
+  for (size_t b=0; b<all.size(); b++) {
+    if (l->Contains(all[b])) continue;
+
+    list<CTacInstr*> &instr = all[b]->GetInstr();
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+      vector<const CSymbol*> used;
+      GetUsedSymbols(*it, used);
+      live.insert(used.begin(), used.end());
+    }
+  }
+
+  // each of them must be assigned an affine function of its old value and
+  // the induction variable in every iteration
+  CBasicBlock *latch = l->GetLatch();
+  vector<const CSymbol*> vars;
+  vector<CAffine> forms;
+
+  for (size_t d=0; d<defs.size(); d++) {
+    const CSymbol *sym = defs[d];
+    if ((sym->GetSymbolType() != stGlobal) && (live.find(sym) == live.end()))
+      continue;
+
+    CTacInstr *def = _def[sym];
+    CAffine f;
+    if ((def == NULL) || !sym->GetDataType()->IsInt()) return false;
+    if (!cfg->Dominates(_block[def], latch)) return false;
+    if (!Evaluate(cfg, l, sym, def, f) || ((f.self != 0) && (f.self != 1)))
+      return false;
+
+    vars.push_back(sym);
+    forms.push_back(f);
+  }
+
+  CBasicBlock *header = l->GetHeader();
+  CBasicBlock *exit = l->Contains(latch->GetTarget()) ?
+                      latch->GetFallthrough() : latch->GetTarget();
+  CTacAddr *bound = l->GetBound();
+  CCodeBlock *cb = cfg->GetCodeBlock();
+
+  // without a constant trip count, the original loop is kept for initial
+  // values failing the condition and for bounds that let the induction
+  // variable overflow, i.e., bound > INT_MAX - |step| + 1 for 'i < bound'
+  long long s = step > 0 ? step : -(long long)step;
+  bool strict = (cond == opLessThan) || (cond == opBiggerThan);
+  long long limit = step > 0 ? (long long)INT_MAX - s + (strict ? 1 : 0) :
+                               (long long)INT_MIN + s - (strict ? 1 : 0);
+  bool guard = !known && (limit != INT_MAX) && (limit != INT_MIN);
+
+  const CTacConst *c = dynamic_cast<const CTacConst*>(bound);
+  if (guard && (c != NULL)) {
+    if (step > 0 ? c->GetValue() > limit : c->GetValue() < limit) return false;
+    guard = false;
+  }
+
+  // compute the trip count in the preheader. l must not be used once the
+  // preheader exists; creating it recomputes the loops.
+  CBasicBlock *pre = cfg->GetPreheader(l), *bb = pre;
+  CTacAddr *n;
+
+  if (known) {
+    n = new CTacConst(trip);
+  } else {
+    pre->GetInstr().push_back(new CTacInstr(InvertRelOp(cond),
+                                            cfg->GetLabel(header), i0, bound));
+    bb = cfg->CreateBlock(pre);
+    pre->SetFallthrough(bb);
+
+    if (guard) {
+      CBasicBlock *next = cfg->CreateBlock(bb);
+      bb->GetInstr().push_back(new CTacInstr(step > 0 ? opBiggerThan : opLessThan,
+                                             cfg->GetLabel(header), bound,
+                                             new CTacConst((int)limit)));
+      bb->SetFallthrough(next);
+      bb = next;
+    }
+    _kept.insert(header);
+
+    // n = (d - 1) / |step| + 1 where d is the distance from the initial
+    // value to the first value failing the condition; it may exceed
+    // INT_MAX but is below 2^32 and divided unsigned.
+    list<CTacInstr*> &code = bb->GetInstr();
+    CTacAddr *d = step > 0 ? Emit(cb, code, opSub, bound, i0) :
+                             Emit(cb, code, opSub, i0, bound);
+
+    CTacTemp *t = cb->CreateTemp(CTypeManager::Get()->GetInt());
+    if (s == 1) {
+      if (strict) code.push_back(new CTacInstr(opAssign, t, d, NULL));
+      else code.push_back(new CTacInstr(opAdd, t, d, new CTacConst(1)));
+    } else {
+      if (strict) d = Emit(cb, code, opSub, d, new CTacConst(1));
+      code.push_back(new CTacInstr(opAdd, t,
+                                   Emit(cb, code, opUDiv, d, new CTacConst((int)s)),
+                                   new CTacConst(1)));
+    }
+    n = t;
+  }
+
+  // compute the final values
+  list<CTacInstr*> &code = bb->GetInstr();
+  CTacAddr *n1 = Emit(cb, code, opSub, n, new CTacConst(1));
+  CTacAddr *sum = NULL, *last = NULL;
+  vector<CTacAddr*> value;
+
+  for (size_t v=0; v<vars.size(); v++) {
+    const CAffine &f = forms[v];
+    CTacAddr *r;
+
+    if (f.self == 1) {
+      // x + n*g + f.iv*sum(i) where g is the invariant part of f
+      CAffine g(f);
+      g.self = g.iv = 0;
+      r = Emit(cb, code, opMul, EmitAffine(cb, code, g, NULL, NULL), n);
+      r = Emit(cb, code, opAdd, new CTacName(vars[v]), r);
+
+      if (f.iv != 0) {
+        if (sum == NULL) {
+          // sum(i) = n*i0 + step*n*(n-1)/2; n*(n-1)/2 is computed without
+          // overflowing intermediate results as h*(n-1) + (n-2h)*((n-1)/2)
+          // with h = n/2
+          CTacAddr *h = Emit(cb, code, opDiv, n, new CTacConst(2));
+          CTacAddr *odd = Emit(cb, code, opSub, n,
+                               Emit(cb, code, opMul, h, new CTacConst(2)));
+          CTacAddr *tri = Emit(cb, code, opAdd,
+                               Emit(cb, code, opMul, h, n1),
+                               Emit(cb, code, opMul, odd,
+                                    Emit(cb, code, opDiv, n1, new CTacConst(2))));
+          sum = Emit(cb, code, opAdd,
+                     Emit(cb, code, opMul, n, i0),
+                     Emit(cb, code, opMul, tri, new CTacConst(step)));
+        }
+        r = Emit(cb, code, opAdd, r,
+                 Emit(cb, code, opMul, sum, new CTacConst(f.iv)));
+      }
+    } else {
+      // the value computed in the last iteration
+      if ((last == NULL) && (f.iv != 0)) {
+        last = Emit(cb, code, opAdd, i0,
+                    Emit(cb, code, opMul, n1, new CTacConst(step)));
+      }
+      r = EmitAffine(cb, code, f, NULL, last);
+    }
+
+    // do not read variables that are assigned before
+    CTacName *rn = dynamic_cast<CTacName*>(r);
+    if ((rn != NULL) && (dynamic_cast<CTacTemp*>(rn) == NULL)) {
+      CTacTemp *t = cb->CreateTemp(CTypeManager::Get()->GetInt());
+      code.push_back(new CTacInstr(opAssign, t, r, NULL));
+      r = t;
+    }
+    value.push_back(r);
+  }
+
+  for (size_t v=0; v<vars.size(); v++) {
+    code.push_back(new CTacInstr(opAssign, new CTacName(vars[v]), value[v], NULL));
+  }
+
+  // continue after the loop; without a guard, the loop becomes unreachable
+  bb->SetFallthrough(exit);
+  cfg->Update();
+
+  return true;
+}
+
+bool CClosedForm::Evaluate(CCfg *cfg, CLoop *l, const CSymbol *x,
+                           const CTacInstr *instr, const CTacAddr *a,
+                           CAffine &f)
+{
+  f = CAffine();
+
+  const CTacConst *c = dynamic_cast<const CTacConst*>(a);
+  if (c != NULL) {
+    f.c = c->GetValue();
+    return true;
+  }
+
+  const CTacName *n = dynamic_cast<const CTacName*>(a);
+  if ((n == NULL) || (dynamic_cast<const CTacReference*>(n) != NULL)) return false;
+
+  const CSymbol *sym = n->GetSymbol();
+  if (!IsScalarVar(sym) || !sym->GetDataType()->IsInt()) return false;
+
+  // not modified by the loop (which contains no calls)
+  map<const CSymbol*, CTacInstr*>::const_iterator d = _def.find(sym);
+  if (d == _def.end()) {
+    f.inv[sym] = 1;
+    return true;
+  }
+
+  const CTacInstr *def = d->second;
+  if (def == NULL) return false;
+
+  CBasicBlock *ib = _block[instr], *db = _block[def];
+
+  // the old value of x
+  if (sym == x) {
+    if ((ib != db) || (_index[instr] > _index[def])) return false;
+    f.self = 1;
+    return true;
+  }
+
+  // the induction variable, before or after it is incremented
+  if (sym == l->GetInductionVar()) {
+    bool after;
+    if (ib == db) after = _index[instr] > _index[def];
+    else if (cfg->Dominates(db, ib)) after = true;
+    else if (cfg->Dominates(ib, db)) after = false;
+    else return false;
+
+    f.iv = 1;
+    if (after) f.c = l->GetStep();
+    return true;
+  }
+
+  // a value computed before in the same block
+  if ((ib != db) || (_index[def] >= _index[instr])) return false;
+
+  return Evaluate(cfg, l, x, def, f);
+}
+
+bool CClosedForm::Evaluate(CCfg *cfg, CLoop *l, const CSymbol *x,
+                           const CTacInstr *instr, CAffine &f)
+{
+  EOperation op = instr->GetOperation();
+  CAffine a, b;
+
+  switch (op) {
+    case opAssign:
+    case opPos:
+      return Evaluate(cfg, l, x, instr, instr->GetSrc(1), f);
+
+    case opNeg:
+      if (!Evaluate(cfg, l, x, instr, instr->GetSrc(1), a)) return false;
+      f = CAffine();
+      f.Add(a, -1);
+      return true;
+
+    case opAdd:
+    case opSub:
+      if (!Evaluate(cfg, l, x, instr, instr->GetSrc(1), a) ||
+          !Evaluate(cfg, l, x, instr, instr->GetSrc(2), b)) return false;
+      f = a;
+      f.Add(b, op == opAdd ? 1 : -1);
+      return true;
+
+    case opMul:
+      if (!Evaluate(cfg, l, x, instr, instr->GetSrc(1), a) ||
+          !Evaluate(cfg, l, x, instr, instr->GetSrc(2), b)) return false;
+      if (b.IsConst()) {
+        f = a;
+        f.Scale(b.c);
+      } else if (a.IsConst()) {
+        f = b;
+        f.Scale(a.c);
+      } else {
+        return false;
+      }
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+CTacAddr* CClosedForm::EmitAffine(CCodeBlock *cb, list<CTacInstr*> &code,
+                                  const CAffine &f, CTacAddr *x, CTacAddr *i)
+{
+  CTacAddr *r = new CTacConst(f.c);
+
+  if (f.self != 0) {
+    r = Emit(cb, code, opAdd, r,
+             Emit(cb, code, opMul, x, new CTacConst(f.self)));
+  }
+  if (f.iv != 0) {
+    r = Emit(cb, code, opAdd, r,
+             Emit(cb, code, opMul, i, new CTacConst(f.iv)));
+  }
+
+  map<const CSymbol*, int>::const_iterator it = f.inv.begin();
+  while (it != f.inv.end()) {
+    r = Emit(cb, code, opAdd, r,
+             Emit(cb, code, opMul, new CTacName(it->first),
+                  new CTacConst(it->second)));
+    it++;
+  }
+
+  return r;
+}
+
+
+//------------------------------------------------------------------------------
+// CPartialRedundancyElim
+//
+CPartialRedundancyElim::CPartialRedundancyElim(void)
+  : CPass("pre")
+{
+}
+
+/// @brief set operations on expression sets
+static vector<bool> operator&(const vector<bool> &a, const vector<bool> &b)
+{
+  vector<bool> r(a);
+  for (size_t i=0; i<r.size(); i++) r[i] = r[i] && b[i];
+  return r;
+}
+
+static vector<bool> operator|(const vector<bool> &a, const vector<bool> &b)
+{
+  vector<bool> r(a);
+  for (size_t i=0; i<r.size(); i++) r[i] = r[i] || b[i];
+  return r;
+}
+
+static vector<bool> operator~(const vector<bool> &a)
+{
+  vector<bool> r(a);
+  r.flip();
+  return r;
+}
+
+bool CPartialRedundancyElim::RunOnScope(CScope *s)
+{
+  // forwarding the temporaries exposes redundancies of expressions using
+  // them in the next round
+  bool changed = false;
+  while (Eliminate(s)) changed = true;
+
+  return changed;
+}
+
+bool CPartialRedundancyElim::Eliminate(CScope *s)
+{
+  CCfg cfg(s->GetCodeBlock());
+
+  // insertions on the entry edge are not possible; make sure the entry
+  // block has no predecessors
+  if (!cfg.GetEntry()->GetPred().empty()) {
+    CBasicBlock *entry = cfg.GetEntry();
+    cfg.CreateBlockBefore(entry)->SetFallthrough(entry);
+    cfg.Update();
+  }
+
+  // splitting edges changes the layout; keep a copy
+  vector<CBasicBlock*> blocks(cfg.GetBlocks());
+  size_t nb = blocks.size();
+
+  // candidate expressions
+  _expr.clear();
+  _index.clear();
+  _first.clear();
+
+  for (size_t b=0; b<nb; b++) {
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+      CExpr e;
+      if (GetExpr(*it, e) && (_index.find(e) == _index.end())) {
+        _index[e] = (int)_expr.size();
+        _expr.push_back(e);
+        _first.push_back((*it)->Clone());
+      }
+    }
+  }
+
+  size_t ne = _expr.size();
+  if (ne == 0) {
+    cfg.Commit();
+    return false;
+  }
+
+  // local properties: upward exposed (antloc), downward exposed (comp),
+  // and transparent (transp)
+  vector<CExprSet> antloc(nb, CExprSet(ne, false)), comp(antloc);
+  vector<CExprSet> transp(nb, CExprSet(ne, true));
+
+  for (size_t b=0; b<nb; b++) {
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    for (list<CTacInstr*>::iterator it=instr.begin(); it!=instr.end(); it++) {
+      CExpr e;
+      if (GetExpr(*it, e)) {
+        int k = _index[e];
+        if (transp[b][k]) antloc[b][k] = true;
+        comp[b][k] = true;
+      }
+      for (size_t k=0; k<ne; k++) {
+        if (Kills(*it, _expr[k])) transp[b][k] = comp[b][k] = false;
+      }
+    }
+  }
+
+  // availability and anticipability
+  vector<CExprSet> avout(nb, CExprSet(ne, true)), antin(avout), antout(avout);
+  bool changed = true;
+
+  while (changed) {
+    changed = false;
+    for (size_t b=0; b<nb; b++) {
+      const vector<CBasicBlock*> &pred = blocks[b]->GetPred();
+      CExprSet in(ne, !pred.empty());
+      for (size_t p=0; p<pred.size(); p++) in = in & avout[pred[p]->GetId()];
+
+      CExprSet out = comp[b] | (in & transp[b]);
+      if (out != avout[b]) { avout[b] = out; changed = true; }
+    }
+  }
+
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t b=nb; b-- > 0; ) {
+      const vector<CBasicBlock*> &succ = blocks[b]->GetSucc();
+      CExprSet out(ne, !succ.empty());
+      for (size_t i=0; i<succ.size(); i++) out = out & antin[succ[i]->GetId()];
+
+      CExprSet in = antloc[b] | (out & transp[b]);
+      antout[b] = out;
+      if (in != antin[b]) { antin[b] = in; changed = true; }
+    }
+  }
+
+  // earliest and latest placement on the edges
+  typedef pair<int, int> CEdge;
+  map<CEdge, CExprSet> earliest, later, insert;
+  vector<CExprSet> laterin(nb, CExprSet(ne, true));
+  laterin[0] = antin[0];
+
+  for (size_t b=0; b<nb; b++) {
+    const vector<CBasicBlock*> &succ = blocks[b]->GetSucc();
+    for (size_t i=0; i<succ.size(); i++) {
+      int t = succ[i]->GetId();
+      earliest[CEdge(b, t)] = antin[t] & ~avout[b] & (~transp[b] | ~antout[b]);
+    }
+  }
+
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t b=0; b<nb; b++) {
+      const vector<CBasicBlock*> &succ = blocks[b]->GetSucc();
+      for (size_t i=0; i<succ.size(); i++) {
+        CEdge e(b, succ[i]->GetId());
+        later[e] = earliest[e] | (laterin[b] & ~antloc[b]);
+      }
+    }
+    for (size_t b=1; b<nb; b++) {
+      const vector<CBasicBlock*> &pred = blocks[b]->GetPred();
+      CExprSet in(ne, true);
+      for (size_t p=0; p<pred.size(); p++) {
+        in = in & later[CEdge(pred[p]->GetId(), b)];
+      }
+      if (in != laterin[b]) { laterin[b] = in; changed = true; }
+    }
+  }
+
+  vector<CExprSet> del(nb);
+  for (size_t b=0; b<nb; b++) del[b] = antloc[b] & ~laterin[b];
+
+  map<CEdge, CExprSet>::iterator it;
+  for (it=later.begin(); it!=later.end(); it++) {
+    insert[it->first] = it->second & ~laterin[it->first.second];
+  }
+
+  // the temporary of an expression must hold its value where it is read by
+  // a deleted computation; computations reaching such a point store their
+  // result in the temporary
+  vector<CExprSet> needin(nb, CExprSet(ne, false)), needout(needin);
+
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t b=nb; b-- > 0; ) {
+      const vector<CBasicBlock*> &succ = blocks[b]->GetSucc();
+      CExprSet out(ne, false);
+      for (size_t i=0; i<succ.size(); i++) {
+        int t = succ[i]->GetId();
+        out = out | (needin[t] & ~insert[CEdge(b, t)]);
+      }
+      needout[b] = out;
+
+      CExprSet in = del[b] | (out & transp[b] & ~antloc[b]);
+      if (in != needin[b]) { needin[b] = in; changed = true; }
+    }
+  }
+
+  // rewrite the computations
+  _temp.assign(ne, NULL);
+  bool modified = false;
+
+  map<const CSymbol*, int> uses;
+  for (size_t b=0; b<nb; b++) {
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    for (list<CTacInstr*>::iterator i=instr.begin(); i!=instr.end(); i++) {
+      vector<const CSymbol*> used;
+      GetUsedSymbols(*i, used);
+      for (size_t u=0; u<used.size(); u++) uses[used[u]]++;
+    }
+  }
+
+  for (size_t b=0; b<nb; b++) {
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    vector<CTacInstr*> code(instr.begin(), instr.end());
+    vector<int> occ(code.size(), -1);
+    vector<bool> replace(code.size(), false), save(code.size(), false);
+
+    // computations following a deleted or saved computation read the
+    // temporary...
+    CExprSet valid = del[b];
+    for (size_t i=0; i<code.size(); i++) {
+      CExpr e;
+      if (GetExpr(code[i], e)) {
+        occ[i] = _index[e];
+        replace[i] = valid[occ[i]];
+        valid[occ[i]] = true;
+      }
+      for (size_t k=0; k<ne; k++) {
+        if (Kills(code[i], _expr[k])) valid[k] = false;
+      }
+    }
+
+    // ...and the remaining computations save their result if it is read
+    CExprSet needed = needout[b];
+    for (size_t i=code.size(); i-- > 0; ) {
+      for (size_t k=0; k<ne; k++) {
+        if (Kills(code[i], _expr[k])) needed[k] = false;
+      }
+      if (occ[i] >= 0) {
+        if (!replace[i]) save[i] = needed[occ[i]];
+        needed[occ[i]] = replace[i];
+      }
+    }
+
+    instr.clear();
+    set<CTacInstr*> copies;
+    for (size_t i=0; i<code.size(); i++) {
+      CTacInstr *c = code[i];
+
+      if (replace[i] || save[i]) {
+        CTacTemp *t = GetTemp(s, occ[i]);
+        if (save[i]) {
+          instr.push_back(new CTacInstr(c->GetOperation(), t, c->GetSrc(1),
+                                        c->GetSrc(2)));
+        }
+        c->SetOperation(opAssign);
+        c->SetSrc(1, t);
+        c->SetSrc(2, NULL);
+        copies.insert(c);
+        modified = modified || replace[i];
+      }
+      instr.push_back(c);
+    }
+
+    Forward(instr, copies, uses);
+  }
+
+  // insert the computations on the edges
+  for (it=insert.begin(); it!=insert.end(); it++) {
+    CBasicBlock *from = blocks[it->first.first], *to = blocks[it->first.second];
+    list<CTacInstr*> code;
+
+    for (size_t k=0; k<ne; k++) {
+      if (!it->second[k]) continue;
+      code.push_back(new CTacInstr(_first[k]->GetOperation(), GetTemp(s, k),
+                                   _first[k]->GetSrc(1), _first[k]->GetSrc(2)));
+    }
+    if (code.empty()) continue;
+    modified = true;
+
+    if (from->GetSucc().size() == 1) {
+      list<CTacInstr*> &instr = from->GetInstr();
+      list<CTacInstr*>::iterator pos = instr.end();
+      if (from->GetTerminator() != NULL) pos--;
+      instr.insert(pos, code.begin(), code.end());
+    } else if (to->GetPred().size() == 1) {
+      list<CTacInstr*> &instr = to->GetInstr();
+      instr.insert(instr.begin(), code.begin(), code.end());
+    } else {
+      // split the critical edge
+      CBasicBlock *bb = from->GetFallthrough() == to ? cfg.CreateBlock(from) :
+                                                       cfg.CreateBlockBefore(to);
+      bb->GetInstr().insert(bb->GetInstr().end(), code.begin(), code.end());
+      bb->SetFallthrough(to);
+      cfg.Retarget(from, to, bb);
+    }
+  }
+
+  cfg.Commit();
+  for (size_t k=0; k<ne; k++) delete _first[k];
+
+  return modified;
+}
+
+bool CPartialRedundancyElim::GetExpr(const CTacInstr *instr, CExpr &e) const
+{
+  EOperation op = instr->GetOperation();
+  bool unary = (op == opNeg) || (op == opNot);
+
+  switch (op) {
+    case opAdd: case opSub: case opMul: case opDiv: case opUDiv:
+    case opAnd: case opOr: case opNeg: case opNot:
+      break;
+    default:
+      return false;
+  }
+
+  const CTacName *dst = dynamic_cast<const CTacName*>(instr->GetDest());
+  if ((dst == NULL) || !IsScalarVar(dst->GetSymbol()) ||
+      (dynamic_cast<const CTacReference*>(dst) != NULL)) return false;
+
+  COperand a, b(NULL, 0);
+  if (!GetOperand(instr->GetSrc(1), a)) return false;
+  if (!unary && !GetOperand(instr->GetSrc(2), b)) return false;
+  if ((a.first == NULL) && (b.first == NULL)) return false;
+
+  if (((op == opDiv) || (op == opUDiv)) &&
+      ((b.first != NULL) || (b.second == 0) || (b.second == -1))) return false;
+
+  if (IsCommutative(op) && (b < a)) swap(a, b);
+  e = CExpr(op, make_pair(a, b));
+
+  return true;
+}
+
+void CPartialRedundancyElim::Forward(list<CTacInstr*> &instr,
+                                     const set<CTacInstr*> &copies,
+                                     map<const CSymbol*, int> &uses) const
+{
+  list<CTacInstr*>::iterator it = instr.begin();
+
+  while (it != instr.end()) {
+    CTacInstr *c = *it++;
+    const CTacTemp *t = dynamic_cast<const CTacTemp*>(c->GetDest());
+    if ((copies.find(c) == copies.end()) || (t == NULL)) continue;
+
+    CTacTemp *h = dynamic_cast<CTacTemp*>(c->GetSrc(1));
+    const CSymbol *tsym = t->GetSymbol(), *hsym = h->GetSymbol();
+    int n = 0;
+
+    // replace the uses of t until t or h are redefined
+    for (list<CTacInstr*>::iterator u=it; u!=instr.end(); u++) {
+      for (int i=0; i<=2; i++) {
+        CTac *op = i == 0 ? (*u)->GetDest() : (*u)->GetSrc(i);
+        CTacName *name = dynamic_cast<CTacName*>(op);
+        if ((name == NULL) || (name->GetSymbol() != tsym)) continue;
+
+        CTacReference *r = dynamic_cast<CTacReference*>(name);
+        if (r != NULL) {
+          r = new CTacReference(hsym, r->GetDerefSymbol());
+          if (i == 0) (*u)->SetDest(r); else (*u)->SetSrc(i, r);
+          n++;
+        } else if ((i > 0) && ((*u)->GetOperation() != opCall)) {
+          (*u)->SetSrc(i, h);
+          n++;
+        }
+      }
+
+      const CSymbol *def = GetDefinedSymbol(*u);
+      if ((def == tsym) || (def == hsym)) break;
+    }
+
+    // remove the copy if all uses have been replaced
+    if (n == uses[tsym]) {
+      it--;
+      it = instr.erase(it);
+      delete c;
+    }
+  }
+}
+
+CTacTemp* CPartialRedundancyElim::GetTemp(CScope *s, int k)
+{
+  if (_temp[k] == NULL) {
+    const CTacName *d = dynamic_cast<const CTacName*>(_first[k]->GetDest());
+    _temp[k] = s->CreateTemp(d->GetSymbol()->GetDataType());
+  }
+
+  return _temp[k];
+}
+
+bool CPartialRedundancyElim::Kills(const CTacInstr *instr, const CExpr &e) const
+{
+  const CSymbol *a = e.second.first.first, *b = e.second.second.first;
+
+  const CSymbol *def = GetDefinedSymbol(instr);
+  if ((def != NULL) && ((def == a) || (def == b))) return true;
+
+  if (instr->GetOperation() == opCall) {
+    const CSymProc *callee = GetCallee(instr);
+    return ((a != NULL) && CallMayModify(callee, a)) ||
+           ((b != NULL) && CallMayModify(callee, b));
+  }
+
+  return false;
+}
+
+
+//------------------------------------------------------------------------------
+// CDeadStoreElim
+//
+CDeadStoreElim::CDeadStoreElim(void)
+  : CPass("dse")
+{
+}
+
+bool CDeadStoreElim::RunOnScope(CScope *s)
+{
+  bool changed = RemoveUnobserved(s);
+
+  CCfg cfg(s->GetCodeBlock());
+  bool found = true;
+
+  // removing a dead load may make an earlier store dead
+  while (found) {
+    found = RemoveOverwritten(&cfg);
+    while (RemoveScalar(&cfg)) found = true;
+    changed = changed || found;
+  }
+
+  cfg.Commit();
+
+  return changed;
+}
+
+bool CDeadStoreElim::RemoveScalar(CCfg *cfg) const
+{
+  const vector<CBasicBlock*> &blocks = cfg->GetBlocks();
+  map<const CBasicBlock*, set<const CSymbol*> > in;
+  set<const CSymbol*> globals;
+  bool changed = false, iterate = true;
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    const list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    list<CTacInstr*>::const_iterator it;
+    for (it=instr.begin(); it!=instr.end(); it++) {
+      const CSymbol *def = GetDefinedSymbol(*it);
+      if ((def != NULL) && (def->GetSymbolType() == stGlobal)) globals.insert(def);
+    }
+  }
+
+  // live variables; global variables are live at the end of the procedure
+  for (int pass=0; pass<2; pass++) {
+    iterate = (pass == 0);
+    do {
+      if (pass == 0) iterate = false;
+
+      for (size_t b=blocks.size(); b-- > 0; ) {
+        CBasicBlock *bb = blocks[b];
+        const vector<CBasicBlock*> &succ = bb->GetSucc();
+        CTacInstr *term = bb->GetTerminator();
+        set<const CSymbol*> live;
+
+        for (size_t k=0; k<succ.size(); k++) {
+          live.insert(in[succ[k]].begin(), in[succ[k]].end());
+        }
+        if (((term != NULL) && (term->GetOperation() == opReturn)) ||
+            (bb->GetFallthrough() == NULL)) {
+          live.insert(globals.begin(), globals.end());
+        }
+
+        // in the second pass, remove the dead assignments
+        list<CTacInstr*> &instr = bb->GetInstr();
+        list<CTacInstr*>::iterator it = instr.end();
+        while (it != instr.begin()) {
+          CTacInstr *i = *--it;
+          const CSymbol *def = GetDefinedSymbol(i);
+          bool dead = (def != NULL) && (live.count(def) == 0);
+
+          if ((pass == 1) && dead && IsRemovable(i)) {
+            it = instr.erase(it);
+            delete i;
+            changed = true;
+            continue;
+          }
+          if ((pass == 1) && dead && (i->GetOperation() == opCall)) {
+            i->SetDest(NULL);
+            changed = true;
+          }
+
+          // calls of pure procedures without a result are removed together
+          // with their parameters
+          vector<CTacInstr*> params;
+          if ((pass == 1) && (i->GetOperation() == opCall) &&
+              (i->GetDest() == NULL) && GetCallee(i)->IsPure() &&
+              GetParams(instr.begin(), it, params)) {
+            for (size_t p=0; p<params.size(); p++) {
+              instr.remove(params[p]);
+              delete params[p];
+            }
+            it = instr.erase(it);
+            delete i;
+            changed = true;
+            continue;
+          }
+
+          if (def != NULL) live.erase(def);
+          AddUses(i, globals, live);
+        }
+
+        if ((pass == 0) && (in[bb] != live)) {
+          in[bb] = live;
+          iterate = true;
+        }
+      }
+    } while (iterate && (pass == 0));
+  }
+
+  return changed;
+}
+
+bool CDeadStoreElim::RemoveOverwritten(CCfg *cfg) const
+{
+  const vector<CBasicBlock*> &blocks = cfg->GetBlocks();
+  bool changed = false;
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    list<CTacInstr*> &instr = blocks[b]->GetInstr();
+    list<CTacInstr*>::iterator it = instr.end();
+
+    map<const CTacInstr*, int> addr;
+    NumberAddresses(blocks[b], addr);
+
+    // addresses (and the arrays they point into) written later in the
+    // block without an intervening read of possibly aliasing memory
+    map<int, const CSymbol*> written;
+
+    while (it != instr.begin()) {
+      CTacInstr *i = *--it;
+      EOperation op = i->GetOperation();
+
+      const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetDest());
+      if (addr.count(i) > 0) {
+        if ((written.count(addr[i]) > 0) && IsRemovable(i)) {
+          it = instr.erase(it);
+          delete i;
+          changed = true;
+          continue;
+        }
+        written[addr[i]] = r->GetDerefSymbol();
+      }
+
+      // calls may read memory; DIM and DOFS only read the array headers
+      // that are never written
+      if (op == opCall) {
+        const CSymProc *proc = GetCallee(i);
+        if (!proc->IsConst() &&
+            !(proc->IsExternal() &&
+              ((proc->GetName() == "DIM") || (proc->GetName() == "DOFS")))) {
+          written.clear();
+        }
+        continue;
+      }
+      if (op == opReturn) {
+        written.clear();
+        continue;
+      }
+
+      for (int k=1; k<=2; k++) {
+        r = dynamic_cast<const CTacReference*>(i->GetSrc(k));
+        if ((op == opAddress) || (r == NULL)) continue;
+
+        const CSymbol *a = r->GetDerefSymbol();
+        map<int, const CSymbol*>::iterator w = written.begin();
+        while (w != written.end()) {
+          const CSymbol *b = w->second;
+          bool alias = (a == NULL) || (b == NULL) || (a == b) ||
+                       ((a->GetSymbolType() != stLocal) &&
+                        (b->GetSymbolType() != stLocal));
+          if (alias) written.erase(w++);
+          else w++;
+        }
+      }
+    }
+  }
+
+  return changed;
+}
+
+void CDeadStoreElim::NumberAddresses(CBasicBlock *bb,
+                                     map<const CTacInstr*, int> &addr) const
+{
+  const list<CTacInstr*> &instr = bb->GetInstr();
+  list<CTacInstr*>::const_iterator it;
+
+  map<vector<int>, int> table;          // value numbers of expressions
+  map<const CSymbol*, int> value;       // current value numbers of variables
+  int next = 0;
+
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    const CTacInstr *i = *it;
+    EOperation op = i->GetOperation();
+
+    const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetDest());
+    if ((r != NULL) && !i->IsBranch() && (op != opParam)) {
+      if (value.count(r->GetSymbol()) == 0) value[r->GetSymbol()] = next++;
+      addr[i] = value[r->GetSymbol()];
+    }
+
+    // calls may modify global variables
+    const CSymProc *callee = op == opCall ? GetCallee(i) : NULL;
+    if (callee != NULL) {
+      map<const CSymbol*, int>::iterator v = value.begin();
+      while (v != value.end()) {
+        if ((v->first->GetSymbolType() == stGlobal) &&
+            CallMayModify(callee, v->first)) value.erase(v++);
+        else v++;
+      }
+    }
+
+    const CSymbol *def = GetDefinedSymbol(i);
+    if (def == NULL) continue;
+
+    // the operands: constants, variables, or the parameters of DIM and DOFS
+    vector<const CTacAddr*> opnd;
+    vector<CTacInstr*> params;
+    if (op <= opAddress) {
+      opnd.push_back(i->GetSrc(1));
+      if (i->GetSrc(2) != NULL) opnd.push_back(i->GetSrc(2));
+    } else if ((callee != NULL) && callee->IsExternal() &&
+               ((callee->GetName() == "DIM") || (callee->GetName() == "DOFS")) &&
+               GetParams(instr.begin(), it, params)) {
+      for (size_t p=0; p<params.size(); p++) opnd.push_back(params[p]->GetSrc(1));
+    } else {
+      opnd.push_back(NULL);
+    }
+
+    vector<int> key(1, op);
+    if (callee != NULL) key.push_back(callee->GetName() == "DIM" ? 1 : 0);
+    for (size_t k=0; k<opnd.size(); k++) {
+      const CTacConst *c = dynamic_cast<const CTacConst*>(opnd[k]);
+      const CTacName *n = dynamic_cast<const CTacName*>(opnd[k]);
+
+      if (c != NULL) {
+        vector<int> ckey(1, -1);
+        ckey.push_back(c->GetValue());
+        if (table.count(ckey) == 0) table[ckey] = next++;
+        key.push_back(table[ckey]);
+      } else if ((n != NULL) && (dynamic_cast<const CTacReference*>(n) == NULL)) {
+        if (value.count(n->GetSymbol()) == 0) value[n->GetSymbol()] = next++;
+        key.push_back(value[n->GetSymbol()]);
+      } else {
+        // memory and other values are unknown
+        key.push_back(next++);
+      }
+    }
+    if (IsCommutative(op) && (key.size() == 3) && (key[2] < key[1])) {
+      swap(key[1], key[2]);
+    }
+
+    if ((op == opAssign) || (op == opPos)) {
+      value[def] = key[1];
+    } else {
+      if (table.count(key) == 0) table[key] = next++;
+      value[def] = table[key];
+    }
+  }
+}
+
+bool CDeadStoreElim::RemoveUnobserved(CScope *s) const
+{
+  CCodeBlock *cb = s->GetCodeBlock();
+  list<CTacInstr*> instr(cb->GetInstr());
+  list<CTacInstr*>::iterator it;
+
+  // temporaries holding addresses into local arrays
+  map<const CSymbol*, const CSymbol*> array;
+  set<const CSymbol*> observed;
+  bool iterate = true;
+
+  while (iterate) {
+    iterate = false;
+
+    for (it=instr.begin(); it!=instr.end(); it++) {
+      EOperation op = (*it)->GetOperation();
+      const CSymbol *t = GetTemp((*it)->GetDest()), *a = NULL;
+      if ((t == NULL) || (array.count(t) > 0)) continue;
+
+      const CTacName *n = dynamic_cast<const CTacName*>((*it)->GetSrc(1));
+      if ((n == NULL) || (dynamic_cast<const CTacReference*>(n) != NULL)) continue;
+
+      if ((op == opAddress) && (n->GetSymbol()->GetSymbolType() == stLocal)) {
+        a = n->GetSymbol();
+      } else if ((op == opAdd) || (op == opSub) || (op == opAssign)) {
+        for (int k=1; (a == NULL) && (k<=2); k++) {
+          const CSymbol *u = GetTemp((*it)->GetSrc(k));
+          if (array.count(u) > 0) a = array[u];
+        }
+      }
+
+      if (a != NULL) {
+        array[t] = a;
+        iterate = true;
+      }
+    }
+  }
+
+  // the runtime functions DIM and DOFS do not read the array
+  set<const CTacInstr*> inquiry;
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    if ((*it)->GetOperation() != opCall) continue;
+
+    const CSymProc *proc = GetCallee(*it);
+    vector<CTacInstr*> params;
+    if (proc->IsExternal() &&
+        ((proc->GetName() == "DIM") || (proc->GetName() == "DOFS")) &&
+        GetParams(instr.begin(), it, params)) {
+      inquiry.insert(params.begin(), params.end());
+    }
+  }
+
+  // the arrays that are read or whose address escapes
+  for (it=instr.begin(); it!=instr.end(); it++) {
+    CTacInstr *i = *it;
+
+    bool derive = (GetTemp(i->GetDest()) != NULL) &&
+                  (array.count(GetTemp(i->GetDest())) > 0);
+
+    for (int k=1; k<=2; k++) {
+      const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetSrc(k));
+      if (r != NULL) {
+        observed.insert(r->GetDerefSymbol());
+        if (array.count(r->GetSymbol()) > 0) observed.insert(array[r->GetSymbol()]);
+        continue;
+      }
+
+      const CSymbol *u = GetTemp(i->GetSrc(k));
+      if ((array.count(u) > 0) && !derive && (inquiry.count(i) == 0))
+        observed.insert(array[u]);
+    }
+  }
+
+  bool changed = false;
+  it = instr.begin();
+  while (it != instr.end()) {
+    CTacInstr *i = *it;
+    const CTacReference *r = dynamic_cast<const CTacReference*>(i->GetDest());
+    const CSymbol *a = r != NULL ? r->GetDerefSymbol() : NULL;
+
+    if ((a != NULL) && (a->GetSymbolType() == stLocal) &&
+        (observed.count(a) == 0) &&
+        ((array.count(r->GetSymbol()) == 0) || (array[r->GetSymbol()] == a)) &&
+        !i->IsBranch() && IsRemovable(i)) {
+      it = instr.erase(it);
+      delete i;
+      changed = true;
+    } else {
+      it++;
+    }
+  }
+
+  if (changed) cb->SetInstr(instr);
+
+  return changed;
+}
+
+void CDeadStoreElim::AddUses(const CTacInstr *instr,
+                             const set<const CSymbol*> &globals,
+                             set<const CSymbol*> &live) const
+{
+  vector<const CSymbol*> used;
+  GetUsedSymbols(instr, used);
+  live.insert(used.begin(), used.end());
+
+  if (instr->GetOperation() == opCall) {
+    const CSymProc *proc = GetCallee(instr);
+    set<const CSymbol*>::const_iterator g;
+    for (g=globals.begin(); g!=globals.end(); g++) {
+      if (proc->MayRead(*g)) live.insert(*g);
+    }
+  }
+}
+
+bool CDeadStoreElim::IsRemovable(const CTacInstr *instr) const
+{
+  EOperation op = instr->GetOperation();
+  const CTacAddr *d = instr->GetSrc(2);
+
+  if (op > opCast) return false;
+
+  // divisions are kept since they may trap
+  if ((op == opDiv) || (op == opUDiv)) {
+    return (dynamic_cast<const CTacConst*>(d) != NULL) &&
+           !IsConst(d, 0) && !IsConst(d, -1);
+  }
+
+  return true;
+}
+
+
+//------------------------------------------------------------------------------
+// CGlobalDCE
+//
+CGlobalDCE::CGlobalDCE(void)
+  : CPass("global-dce")
+{
+}
+
+bool CGlobalDCE::Run(CModule *m)
+{
+  assert(m != NULL);
+  _module = m;
+
+  CCallGraph cg(m);
+  bool changed = false;
+
+  // unreachable procedures
+  vector<CScope*> work(m->GetSubscopes());
+  while (!work.empty()) {
+    CScope *s = work.back();
+    work.pop_back();
+
+    if (!cg.IsReachable(s)) {
+      s->GetParent()->RemoveSubscope(s);
+      delete s;
+      changed = true;
+    } else {
+      work.insert(work.end(), s->GetSubscopes().begin(), s->GetSubscopes().end());
+    }
+  }
+
+  // globals referenced by the remaining code
+  set<const CSymbol*> used;
+  const vector<CScope*> &scopes = cg.GetScopes();
+  for (size_t s=0; s<scopes.size(); s++) {
+    const list<CTacInstr*> &instr = scopes[s]->GetCodeBlock()->GetInstr();
+    list<CTacInstr*>::const_iterator it;
+    for (it=instr.begin(); it!=instr.end(); it++) {
+      CTac *op[] = { (*it)->GetDest(), (*it)->GetSrc(1), (*it)->GetSrc(2) };
+
+      for (int o=0; o<3; o++) {
+        CTacName *n = dynamic_cast<CTacName*>(op[o]);
+        if (n == NULL) continue;
+
+        used.insert(n->GetSymbol());
+        CTacReference *r = dynamic_cast<CTacReference*>(n);
+        if (r != NULL) used.insert(r->GetDerefSymbol());
+      }
+    }
+  }
+
+  vector<CSymbol*> globals = m->GetSymbolTable()->GetSymbols();
+  for (size_t g=0; g<globals.size(); g++) {
+    if ((globals[g]->GetSymbolType() == stGlobal) &&
+        (used.find(globals[g]) == used.end())) {
+      m->GetSymbolTable()->RemoveSymbol(globals[g]);
+      changed = true;
+    }
+  }
+
+  return changed;
+}
+
+
+//------------------------------------------------------------------------------
+// COptimizer
+//
+COptimizer::COptimizer(int level)
+  : _level(level), _unswitch_budget(100)
+{
+}
+
+COptimizer::~COptimizer(void)
+{
+}
+
+int COptimizer::GetLevel(void) const
+{
+  return _level;
+}
+
+void COptimizer::SetUnswitchBudget(int budget)
+{
+  _unswitch_budget = budget;
+}
+
+bool COptimizer::Optimize(CModule *m)
+{
+  assert(m != NULL);
+
+  if (_level < 1) return false;
+
+  vector<CPass*> passes;
+
+  // procedures are only cloned at -O2
+  passes.push_back(new CIPConstProp(_level >= 2 ? 200 : 0));
+  passes.push_back(new CCfgCleanup());
+  passes.push_back(new CPurityAnalysis());
+  passes.push_back(new CModRefAnalysis());
+  passes.push_back(new CConstCallEval(_level >= 2 ? 1000000 : 100000));
+  passes.push_back(new CPureCallElim());
+  passes.push_back(new CDeadArgElim());
+  passes.push_back(new CAlgebraicSimplify());
+  passes.push_back(new CValueRange());
+  passes.push_back(new CBoundsCheckElim());
+  if ((_level >= 2) && (_unswitch_budget > 0))
+    passes.push_back(new CLoopUnswitch(_unswitch_budget));
+  if (_level >= 2) passes.push_back(new CClosedForm());
+  if (_level >= 2) passes.push_back(new CPartialRedundancyElim());
+  passes.push_back(new CDeadStoreElim());
+  passes.push_back(new CGlobalDCE());
+
+  bool changed = false;
+  for (size_t p=0; p<passes.size(); p++) {
+    changed = passes[p]->Run(m) || changed;
+    delete passes[p];
+  }
+
+  return changed;
+}
@@ -0,0 +1,819 @@
+//------------------------------------------------------------------------------
+/// @brief SnuPL TAC optimizer
+/// @section changelog Change Log
+/// 2026/10/19 created
+///
+/// @section license_section License
+/// Copyright (c) 2012-2016 Bernhard Egger
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms,  with or without modifi-
+/// cation, are permitted provided that the following conditions are met:
+///
+/// - Redistributions of source code must retain the above copyright notice,
+///   this list of conditions and the following disclaimer.
+/// - Redistributions in binary form must reproduce the above copyright notice,
+///   this list of conditions and the following disclaimer in the documentation
+///   and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY  AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER  OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT,  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSE-
+/// QUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF  SUBSTITUTE
+/// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+/// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN  CONTRACT, STRICT
+/// LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY
+/// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+/// DAMAGE.
+//------------------------------------------------------------------------------
+
+#ifndef __SnuPL_OPT_H__
+#define __SnuPL_OPT_H__
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "ir.h"
+#include "cfg.h"
+
+
+//------------------------------------------------------------------------------
+/// @brief optimization pass
+///
+/// base class for TAC optimization passes. Intraprocedural passes override
+/// RunOnScope(), interprocedural passes override Run().
+///
+class CPass {
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    /// @brief constructor
+    /// @param name name of the pass
+    CPass(const string name);
+
+    /// @brief destructor
+    virtual ~CPass(void);
+
+    /// @}
+
+    /// @brief return the name of the pass
+    string GetName(void) const;
+
+    /// @brief run the pass on module @a m
+    /// @retval true if the code has been changed
+    virtual bool Run(CModule *m);
+
+  protected:
+    /// @brief operand: symbol or (if NULL) constant value
+    typedef pair<const CSymbol*, int> COperand;
+
+    /// @brief run the pass on scope @a s
+    /// @retval true if the code has been changed
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief return the scope implementing @a proc, or NULL if @a proc is
+    ///        a runtime library function
+    CScope* GetScope(const CSymProc *proc) const;
+
+    /// @brief returns true if a call to @a proc may modify the global @a sym
+    bool CallMayModify(const CSymProc *proc, const CSymbol *sym) const;
+
+    /// @brief return the operand key of @a a
+    /// @retval false if @a a is not a scalar variable or constant
+    bool GetOperand(const CTacAddr *a, COperand &o) const;
+
+    /// @brief returns true if the value of @a a does not change while loop
+    ///        @a l executes
+    bool IsLoopInvariant(const CLoop *l, const CTacAddr *a) const;
+
+    /// @brief append 'dst <- a op b' to @a code where dst is a new temporary.
+    ///        Constant operands are folded.
+    /// @retval the result
+    CTacAddr* Emit(CCodeBlock *cb, list<CTacInstr*> &code, EOperation op,
+                   CTacAddr *a, CTacAddr *b);
+
+    /// @brief remove the instructions computing unused temporaries from
+    ///        @a cb. Divisions that may trap are kept.
+    /// @retval true if instructions have been removed
+    bool RemoveDeadCode(CCodeBlock *cb) const;
+
+    string _name;                    ///< pass name
+    CModule *_module;                ///< module being optimized
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief control flow cleanup
+///
+/// Removes unreachable code and redundant branches.
+///
+class CCfgCleanup : public CPass {
+  public:
+    /// @brief constructor
+    CCfgCleanup(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief purity analysis
+///
+/// Determines bottom-up over the call graph which procedures are pure or
+/// const (see CSymProc::IsPure() and CSymProc::IsConst()) and records the
+/// result in their symbols. Procedures are optimistically assumed to be
+/// const until an instruction or a call proves otherwise, so recursive
+/// procedures can be pure as well. The code is not modified.
+///
+class CPurityAnalysis : public CPass {
+  public:
+    /// @brief constructor
+    CPurityAnalysis(void);
+
+    virtual bool Run(CModule *m);
+
+  protected:
+    /// @brief analyze the code of @a s
+    void Analyze(CScope *s, bool &pure, bool &cnst) const;
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief mod/ref analysis of global variables
+///
+/// Computes for every procedure the global variables it may modify and
+/// read, directly or through the procedures it calls, and records the
+/// summaries in the procedure symbols (see CSymProc::SetModRef()). Global
+/// arrays whose address is taken are assumed to be modified and read.
+/// The code is not modified.
+///
+class CModRefAnalysis : public CPass {
+  public:
+    /// @brief constructor
+    CModRefAnalysis(void);
+
+    virtual bool Run(CModule *m);
+
+  protected:
+    /// @brief collect the global variables accessed by the code of @a s
+    void Collect(CScope *s, set<const CSymbol*> &mod,
+                 set<const CSymbol*> &ref) const;
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief compile-time evaluation of calls
+///
+/// Calls of const procedures (see CSymProc::IsConst()) with constant
+/// arguments are evaluated by interpreting the TAC of the callee and
+/// replaced by the result. The interpreter only handles scalar values;
+/// procedures that access arrays are not evaluated. Calls that exceed the
+/// budget of executed instructions, trap, or read undefined variables are
+/// left to the runtime.
+///
+class CConstCallEval : public CPass {
+  public:
+    /// @brief constructor
+    /// @param budget maximal number of instructions executed per call site
+    CConstCallEval(int budget);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief code of a procedure prepared for interpretation
+    struct CCode {
+      vector<const CTacInstr*> instr; ///< instructions
+      map<const CTac*, size_t> label; ///< positions of the labels
+    };
+
+    /// @brief return the code of @a proc, or NULL if it is not available
+    const CCode* GetCode(const CSymProc *proc);
+
+    /// @brief evaluate a call of @a proc with the arguments @a args
+    /// @param result return value
+    /// @param steps remaining number of instructions that may be executed
+    /// @param depth nesting depth of the call
+    /// @retval false if the call cannot be evaluated
+    bool Evaluate(const CSymProc *proc, const vector<int> &args, int &result,
+                  int &steps, int depth);
+
+    int _budget;                     ///< instruction budget per call site
+    map<const CSymProc*, CCode> _code; ///< code of procedures
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief elimination of pure calls
+///
+/// Treats calls of pure procedures like arithmetic operations: a call with
+/// the same arguments as an earlier call in the same basic block reuses its
+/// result, calls with loop-invariant arguments are moved into the loop
+/// preheader, and calls whose result is not used are removed. Calls of
+/// procedures that are pure but not const are only reused or hoisted if no
+/// global variable or memory is modified in between.
+///
+class CPureCallElim : public CPass {
+  public:
+    /// @brief constructor
+    CPureCallElim(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief reuse the results of pure calls within @a bb
+    /// @retval true if calls have been replaced
+    bool Reuse(CBasicBlock *bb) const;
+
+    /// @brief move pure calls with invariant arguments out of loop @a l
+    /// @retval true if calls have been moved
+    bool Hoist(CCfg *cfg, CLoop *l) const;
+
+    /// @brief remove pure calls whose result is not used from @a cb
+    /// @retval true if calls have been removed
+    bool RemoveDead(CCodeBlock *cb) const;
+
+    /// @brief returns true if @a instr is a call of a pure procedure whose
+    ///        arguments are scalar variables or constants. The parameter
+    ///        instructions are returned in @a params.
+    bool IsPureCall(const list<CTacInstr*> &instr,
+                    list<CTacInstr*>::const_iterator call,
+                    vector<CTacInstr*> &params) const;
+
+    /// @brief returns true if @a instr may change global variables or
+    ///        memory
+    bool Clobbers(const CTacInstr *instr) const;
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief dead argument elimination
+///
+/// Removes the parameters a procedure never accesses and the return value
+/// of functions whose result is not used at any call site. All call sites
+/// are rewritten: the arguments of removed parameters are no longer passed,
+/// the remaining parameters are renumbered, and calls no longer store the
+/// result. The computation of the dropped values becomes dead code.
+///
+class CDeadArgElim : public CPass {
+  public:
+    /// @brief constructor
+    CDeadArgElim(void);
+
+    virtual bool Run(CModule *m);
+
+  protected:
+    /// @brief returns true if the code of @a s accesses @a sym
+    bool Accesses(CScope *s, const CSymbol *sym) const;
+
+    /// @brief returns true if the result of a call to @a proc is used in
+    ///        any of the @a scopes
+    bool ResultUsed(const vector<CScope*> &scopes, const CSymProc *proc) const;
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief algebraic simplification
+///
+/// Applies algebraic identities (x+0, x*1, x*0, x-x, -(-x), not not b, ...),
+/// folds constants, moves constant operands of commutative operations and
+/// comparisons to the right, and reassociates chains of additions and
+/// multiplications within a basic block: constants are combined, e.g.,
+/// (i+1)+2 becomes i+3, and long chains are rebalanced into trees to reduce
+/// their dependency height. Temporaries that are equal to another operand
+/// are replaced by that operand and unused temporaries are removed.
+///
+class CAlgebraicSimplify : public CPass {
+  public:
+    /// @brief constructor
+    CAlgebraicSimplify(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief apply identities to @a instr; the instruction is modified in
+    ///        place
+    /// @retval true if @a instr has been changed
+    bool Simplify(CTacInstr *instr) const;
+
+    /// @brief reassociate the addition or multiplication @a instr. New
+    ///        instructions are inserted into @a code before @a pos.
+    /// @retval true if @a instr has been changed
+    bool Reassociate(CCodeBlock *cb, list<CTacInstr*> &code,
+                     list<CTacInstr*>::iterator pos, CTacInstr *instr);
+
+    /// @brief collect the operands of the chain of @a op operations
+    ///        computing @a a
+    /// @param leaves non-constant operands
+    /// @param c combined constant operand
+    /// @retval number of temporaries that have been expanded
+    int Collect(EOperation op, CTacAddr *a, vector<CTacAddr*> &leaves,
+                int &c) const;
+
+    /// @brief forget all values depending on @a sym
+    void Invalidate(const CSymbol *sym);
+
+    map<const CSymbol*, int> _ndef;  ///< number of definitions of temporaries
+    map<const CSymbol*, int> _nuse;  ///< number of uses of temporaries
+    map<const CSymbol*, CTacAddr*> _copy;  ///< temporaries equal to operand
+    map<const CSymbol*, CTacInstr*> _def;  ///< available definitions
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief interprocedural constant propagation
+///
+/// Parameters receiving the same constant at all call sites reachable from
+/// the module body are replaced by the constant. Procedures that are called
+/// with constant arguments at only some call sites are cloned for the most
+/// frequently executed combinations of constant arguments (call sites in
+/// loops count more) within a code-growth budget. The substituted constants
+/// are propagated through the temporaries of the procedure and conditional
+/// branches on constants are resolved.
+///
+class CIPConstProp : public CPass {
+  public:
+    /// @brief constructor
+    /// @param budget maximal number of instructions added by cloning
+    CIPConstProp(int budget);
+
+    virtual bool Run(CModule *m);
+
+  protected:
+    /// @brief call site
+    struct CCallSite {
+      CScope *caller;                ///< calling scope
+      CTacInstr *call;               ///< call instruction
+      vector<CTacAddr*> args;        ///< arguments (NULL if unknown)
+      int weight;                    ///< estimated execution frequency
+    };
+
+    /// @brief constant arguments (parameter index, value)
+    typedef map<int, int> CConstArgs;
+
+    /// @brief append the call sites in @a s to @a sites
+    void GetCallSites(CScope *s, vector<CCallSite> &sites) const;
+
+    /// @brief return the parameters of @a s that are read but never written
+    ///        and can thus be replaced by a constant
+    /// @param fold only return parameters that are operands of arithmetic
+    ///        or relational operations
+    vector<bool> GetCandidates(CScope *s, bool fold=false) const;
+
+    /// @brief replace the parameter @a param of @a s by @a value
+    /// @retval true if a use of the parameter has been replaced
+    bool Substitute(CScope *s, const CSymbol *param, int value);
+
+    /// @brief propagate constants assigned to temporaries of @a s and
+    ///        resolve conditional branches on constants
+    /// @retval true if the code has been changed
+    bool Propagate(CScope *s);
+
+    int _budget;                     ///< code-growth budget
+    map<pair<const CSymProc*, CConstArgs>, CSymProc*> _clones; ///< clones
+    map<const CSymProc*, const CSymProc*> _origin; ///< original of clones
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief value range propagation
+///
+/// Computes for every program point an interval of possible values for
+/// each integer variable and upper bounds of the differences of pairs of
+/// variables (a - b <= c). Facts are learned from constants, arithmetic,
+/// the edges of conditional branches, the array dimensions returned by DIM
+/// (calls of DIM with the same arguments return the same value) and
+/// executed bounds checks; loops are handled by widening at the loop
+/// headers followed by two narrowing rounds. The facts are used to remove
+/// conditional branches whose outcome is implied by dominating conditions
+/// and computations with a constant result. Divisions of non-negative
+/// values become unsigned divisions (opUDiv) that the backend implements
+/// without sign corrections.
+///
+/// Other passes can run the analysis on a CFG with Analyze() and query the
+/// facts holding before an instruction with GetRange() and InRange().
+///
+class CValueRange : public CPass {
+  public:
+    /// @brief constructor
+    CValueRange(void);
+
+    /// @brief compute the facts at the beginning of the blocks of @a cfg
+    ///        in _in and on the edges between them in _edge. The queries
+    ///        below refer to @a cfg until it is modified.
+    void Analyze(CCfg *cfg);
+
+    /// @brief query the range [@a lo, @a hi] of @a a before @a instr in
+    ///        @a bb
+    /// @retval false if @a instr is not reachable
+    bool GetRange(CBasicBlock *bb, const CTacInstr *instr, const CTacAddr *a,
+                  long long &lo, long long &hi) const;
+
+    /// @brief returns true if 0 <= @a index < @a bound holds before @a instr
+    ///        in @a bb
+    bool InRange(CBasicBlock *bb, const CTacInstr *instr,
+                 const CTacAddr *index, const CTacAddr *bound) const;
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief interval [lo, hi]
+    struct CRange {
+      long long lo;                  ///< lower bound
+      long long hi;                  ///< upper bound
+    };
+
+    /// @brief facts holding at a program point
+    struct CFacts {
+      bool reached;                  ///< false if the point is unreachable
+      map<const CSymbol*, CRange> range; ///< value ranges (default: any)
+      map<pair<const CSymbol*, const CSymbol*>, long long> diff;
+                                     ///< bounds of a - b (default: none)
+      map<const CSymbol*, pair<const CSymbol*, int> > dim;
+                                     ///< variables holding DIM(array, index)
+    };
+
+    /// @brief return the facts holding before @a instr in @a bb
+    CFacts FactsAt(CBasicBlock *bb, const CTacInstr *instr) const;
+
+    /// @brief compute the facts on the outgoing edges of @a bb from the
+    ///        facts @a f at its beginning
+    void Propagate(CBasicBlock *bb, CFacts f);
+
+    /// @brief return the tracked variable @a a refers to, or NULL
+    const CSymbol* GetVar(const CTacAddr *a) const;
+
+    /// @brief return the range of operand @a a
+    CRange GetRange(const CFacts &f, const CTacAddr *a) const;
+
+    /// @brief set the range of the tracked variable @a sym to @a r
+    void SetRange(CFacts &f, const CSymbol *sym, CRange r) const;
+
+    /// @brief return an upper bound of a - b
+    long long Bound(const CFacts &f, const CTacAddr *a, const CTacAddr *b) const;
+
+    /// @brief record a - b <= c for the tracked variables @a a and @a b
+    ///        in @a f and derive the bounds following in one step
+    void Relate(CFacts &f, const CSymbol *a, const CSymbol *b,
+                long long c) const;
+
+    /// @brief add the fact a - b <= c to @a f
+    void Assume(CFacts &f, const CTacAddr *a, const CTacAddr *b,
+                long long c) const;
+
+    /// @brief add the fact 'a op b' to @a f
+    void Assume(CFacts &f, EOperation op, const CTacAddr *a,
+                const CTacAddr *b) const;
+
+    /// @brief update @a f by the effect of the instruction at @a pos in
+    ///        @a code
+    void Transfer(CFacts &f, const list<CTacInstr*> &code,
+                  list<CTacInstr*>::const_iterator pos) const;
+
+    /// @brief return the range of the value computed by @a instr
+    /// @param base if the value is a tracked variable plus a constant
+    ///        without overflow, the variable (otherwise NULL)
+    /// @param ofs the constant
+    CRange Evaluate(const CFacts &f, const CTacInstr *instr,
+                    const CSymbol *&base, long long &ofs) const;
+
+    /// @brief forget all facts about @a sym
+    void Kill(CFacts &f, const CSymbol *sym) const;
+
+    /// @brief return the facts holding on all paths of @a a and @a b
+    CFacts Join(const CFacts &a, const CFacts &b) const;
+
+    /// @brief extrapolate the growing bounds from @a old to @a f
+    void Widen(const CFacts &old, CFacts &f) const;
+
+    /// @brief returns true if @a a and @a b are equal
+    bool Equal(const CFacts &a, const CFacts &b) const;
+
+    map<const CBasicBlock*, CFacts> _in; ///< facts at the beginning of blocks
+    map<pair<const CBasicBlock*, const CBasicBlock*>, CFacts> _edge;
+                                     ///< facts on edges
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief array bounds check elimination
+///
+/// Removes bounds checks that are known to succeed: checks whose index is
+/// in range according to value range propagation (CValueRange), checks of
+/// constant indices and checks repeating an earlier check of the same
+/// operands.
+/// Checks of the induction variable of countable loops (plus a constant
+/// offset) are replaced by checks of its first and last value in front of
+/// the loop. Hoisted checks fail before the loop is executed instead of in
+/// the offending iteration; they are only hoisted if no observable effect
+/// (see IsObservable()) may precede them in the loop.
+///
+class CBoundsCheckElim : public CPass {
+  public:
+    /// @brief constructor
+    CBoundsCheckElim(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief remove checks whose index is known to be in range
+    /// @retval true if checks have been removed
+    bool RemoveInRange(CCfg *cfg);
+
+    /// @brief hoist or remove the checks of the induction variable of @a l
+    /// @retval true if checks have been moved or removed
+    bool Hoist(CCfg *cfg, CLoop *l);
+
+    /// @brief remove checks repeating an earlier check
+    /// @retval true if checks have been removed
+    bool RemoveRedundant(CCfg *cfg);
+
+    /// @brief check: index and bound
+    typedef pair<COperand, COperand> CCheck;
+
+    /// @brief remove the checks in @a checks invalidated by @a instr
+    void Kill(const CTacInstr *instr, set<CCheck> &checks) const;
+
+    /// @brief returns true if @a instr has an effect that is observable
+    ///        although a bounds check fails afterwards: calls of impure
+    ///        procedures (I/O, non-termination) and divisions that may trap.
+    ///        Stores are not observable; the failing check terminates the
+    ///        program.
+    bool IsObservable(const CTacInstr *instr) const;
+
+    /// @brief returns true if an observable effect may precede @a chk in
+    ///        block @a bb of loop @a l in the first iteration
+    bool ObservableBefore(CLoop *l, CBasicBlock *bb, const CTacInstr *chk) const;
+
+    CValueRange _ranges;             ///< value range analysis
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief loop unswitching
+///
+/// Conditional branches inside a loop whose condition is loop-invariant are
+/// hoisted in front of the loop. The loop is duplicated; each copy executes
+/// only one side of the branch. The number of duplicated instructions per
+/// scope is limited by a code-growth budget.
+///
+class CLoopUnswitch : public CPass {
+  public:
+    /// @brief constructor
+    /// @param budget maximal number of instructions added per scope
+    CLoopUnswitch(int budget);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief unswitch loop @a l on the branch terminating @a bb
+    void Unswitch(CCfg *cfg, CLoop *l, CBasicBlock *bb);
+
+    int _budget;                     ///< code-growth budget
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief affine function of an induction variable
+///
+/// c + self*x + iv*i + sum(inv[v]*v) where x is the old value of the
+/// variable being evaluated, i the value of the induction variable at the
+/// beginning of the iteration and v loop-invariant variables.
+///
+class CAffine {
+  public:
+    /// @brief constructor
+    /// @param c constant term
+    CAffine(int c=0);
+
+    /// @brief returns true if the function is a constant
+    bool IsConst(void) const;
+
+    /// @brief add @a factor times @a a to this function
+    void Add(const CAffine &a, int factor=1);
+
+    /// @brief multiply this function by @a factor
+    void Scale(int factor);
+
+    int c;                           ///< constant term
+    int self;                        ///< factor of the old value
+    int iv;                          ///< factor of the induction variable
+    map<const CSymbol*, int> inv;    ///< factors of invariant variables
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief closed-form evaluation of loops
+///
+/// Countable loops whose only effect is the final value of the induction
+/// variable and of variables accumulating affine functions of it (sums,
+/// counters, last values) are replaced by the closed form of these values.
+/// Trip counts unknown at compile time are computed in front of the loop;
+/// the loop is kept and executed instead if the initial value fails the
+/// loop condition or if the bound lets the induction variable overflow.
+///
+class CClosedForm : public CPass {
+  public:
+    /// @brief constructor
+    CClosedForm(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief replace loop @a l by its closed form
+    /// @retval true if the loop has been replaced
+    bool Replace(CCfg *cfg, CLoop *l);
+
+    /// @brief evaluate the operand @a a read by @a instr of loop @a l as an
+    ///        affine function of the induction variable
+    /// @param x variable being evaluated
+    /// @retval true if the operand is an affine function
+    bool Evaluate(CCfg *cfg, CLoop *l, const CSymbol *x, const CTacInstr *instr,
+                  const CTacAddr *a, CAffine &f);
+
+    /// @brief evaluate the value computed by @a instr
+    bool Evaluate(CCfg *cfg, CLoop *l, const CSymbol *x, const CTacInstr *instr,
+                  CAffine &f);
+
+    /// @brief append the evaluation of @a f to @a code
+    /// @param x value of the old value
+    /// @param i value of the induction variable
+    CTacAddr* EmitAffine(CCodeBlock *cb, list<CTacInstr*> &code,
+                         const CAffine &f, CTacAddr *x, CTacAddr *i);
+
+    /// @name position of the instructions of the current loop
+    /// @{
+    map<const CTacInstr*, CBasicBlock*> _block; ///< block of instruction
+    map<const CTacInstr*, int> _index;          ///< index in block
+    map<const CSymbol*, CTacInstr*> _def;       ///< definitions
+    /// @}
+
+    set<const CBasicBlock*> _kept;   ///< headers of loops kept behind a guard
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief partial redundancy elimination
+///
+/// Lazy code motion in the edge-based formulation of Drechsler and Stadel.
+/// Arithmetic expressions over scalar variables and constants are computed
+/// into a new temporary at the latest points where they are needed on all
+/// paths; computations that become redundant read the temporary instead.
+/// This covers common subexpressions, partially redundant expressions and
+/// loop-invariant expressions. Divisions are only moved if the divisor is a
+/// constant other than 0 and -1 so that no trap is moved.
+///
+class CPartialRedundancyElim : public CPass {
+  public:
+    /// @brief constructor
+    CPartialRedundancyElim(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief run one round of lazy code motion on @a s
+    /// @retval true if computations have been removed
+    bool Eliminate(CScope *s);
+
+    /// @brief expression: operation and operands
+    typedef pair<EOperation, pair<COperand, COperand> > CExpr;
+    /// @brief set of expressions (indexed by _index)
+    typedef vector<bool> CExprSet;
+
+    /// @brief return the expression computed by @a instr
+    /// @retval false if @a instr does not compute a candidate expression
+    bool GetExpr(const CTacInstr *instr, CExpr &e) const;
+
+    /// @brief returns true if @a instr changes the value of @a e
+    bool Kills(const CTacInstr *instr, const CExpr &e) const;
+
+    /// @brief return the temporary holding the value of expression @a k
+    CTacTemp* GetTemp(CScope *s, int k);
+
+    /// @brief replace the uses of the temporaries defined by the @a copies
+    ///        in @a instr by their source; copies without remaining uses
+    ///        are removed
+    /// @param uses number of uses of each symbol in the scope
+    void Forward(list<CTacInstr*> &instr, const set<CTacInstr*> &copies,
+                 map<const CSymbol*, int> &uses) const;
+
+    vector<CExpr> _expr;             ///< candidate expressions
+    map<CExpr, int> _index;          ///< index of expressions
+    vector<CTacInstr*> _first;       ///< copy of the first computations
+    vector<CTacTemp*> _temp;         ///< temporaries of expressions
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief dead store elimination
+///
+/// Removes assignments to scalar variables that are not live afterwards
+/// (global variables are live at the end of the procedure and at calls of
+/// procedures that may read them), stores through references that are
+/// overwritten through the same address in the same basic block before the
+/// memory may be read, and stores into local arrays that are never read.
+/// Memory accessed through references to different local arrays does not
+/// alias; array parameters may alias global arrays and other parameters.
+/// Calls whose result is dead only lose their destination.
+///
+class CDeadStoreElim : public CPass {
+  public:
+    /// @brief constructor
+    CDeadStoreElim(void);
+
+  protected:
+    virtual bool RunOnScope(CScope *s);
+
+    /// @brief remove the assignments to scalar variables that are not live
+    /// @retval true if instructions have been changed
+    bool RemoveScalar(CCfg *cfg) const;
+
+    /// @brief remove stores that are overwritten before they are read
+    /// @retval true if stores have been removed
+    bool RemoveOverwritten(CCfg *cfg) const;
+
+    /// @brief number the addresses stored to in @a bb by local value
+    ///        numbering; equal numbers denote equal addresses
+    /// @param addr number of the address stored to by each instruction
+    void NumberAddresses(CBasicBlock *bb,
+                         map<const CTacInstr*, int> &addr) const;
+
+    /// @brief remove the stores into local arrays of @a s that are never
+    ///        read
+    /// @retval true if stores have been removed
+    bool RemoveUnobserved(CScope *s) const;
+
+    /// @brief add the scalar variables read by @a instr to @a live. Calls
+    ///        read the @a globals they may read.
+    void AddUses(const CTacInstr *instr, const set<const CSymbol*> &globals,
+                 set<const CSymbol*> &live) const;
+
+    /// @brief returns true if @a instr only stores its result and can be
+    ///        removed if the result is not needed
+    bool IsRemovable(const CTacInstr *instr) const;
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief dead procedure and global elimination
+///
+/// Removes the procedures that are not reachable from the module body in
+/// the call graph, and the global variables and string constants that are
+/// not referenced by the remaining code.
+///
+class CGlobalDCE : public CPass {
+  public:
+    /// @brief constructor
+    CGlobalDCE(void);
+
+    virtual bool Run(CModule *m);
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief TAC optimizer
+///
+/// runs the optimization passes enabled for the selected optimization level
+///
+class COptimizer {
+  public:
+    /// @name constructors/destructors
+    /// @{
+
+    /// @brief constructor
+    /// @param level optimization level (0: none)
+    COptimizer(int level);
+
+    /// @brief destructor
+    virtual ~COptimizer(void);
+
+    /// @}
+
+    /// @name options
+    /// @{
+
+    /// @brief return the optimization level
+    int GetLevel(void) const;
+
+    /// @brief set the code-growth budget (instructions per scope) for loop
+    ///        unswitching. 0 disables unswitching.
+    void SetUnswitchBudget(int budget);
+
+    /// @}
+
+    /// @brief optimize module @a m
+    /// @retval true if the code has been changed
+    bool Optimize(CModule *m);
+
+  protected:
+    int _level;                      ///< optimization level
+    int _unswitch_budget;            ///< loop unswitching budget
+};
+
+
+#endif // __SnuPL_OPT_H__
@@ -118,37 +118,39 @@ void CParser::InitSymbolTable(CSymtab *s)
   CSymProc *fun;
 
   // function DIM(array: pointer to array; dim: integer): integer
-  fun = new CSymProc("DIM", tm->GetInt());
+  fun = new CSymProc("DIM", tm->GetInt(), true);
   fun->AddParam(new CSymParam(0, "arr", tm->GetPointer(tm->GetNull())));
   fun->AddParam(new CSymParam(1, "dim", tm->GetInt()));
+  fun->SetPure(true);
   s->AddSymbol(fun);
 
   // function DOFS(array: pointer to array): integer;
-  fun = new CSymProc("DOFS", tm->GetInt());
+  fun = new CSymProc("DOFS", tm->GetInt(), true);
   fun->AddParam(new CSymParam(0, "arr", tm->GetPointer(tm->GetNull())));
+  fun->SetPure(true);
   s->AddSymbol(fun);
 
   // function ReadInt() : integer;
-  fun = new CSymProc("ReadInt", tm->GetInt());
+  fun = new CSymProc("ReadInt", tm->GetInt(), true);
   s->AddSymbol(fun);
 
   // procedure WriteInt(i: integer);
-  fun = new CSymProc("WriteInt", tm->GetNull());
+  fun = new CSymProc("WriteInt", tm->GetNull(), true);
   fun->AddParam(new CSymParam(0, "i", tm->GetInt()));
   s->AddSymbol(fun);
 
   // procedure WriteChar(c: char);
-  fun = new CSymProc("WriteChar", tm->GetNull());
+  fun = new CSymProc("WriteChar", tm->GetNull(), true);
   fun->AddParam(new CSymParam(0, "c", tm->GetChar()));
   s->AddSymbol(fun);
 
   // procedure WriteStr(string: char[]);
-  fun = new CSymProc("WriteStr", tm->GetNull());
+  fun = new CSymProc("WriteStr", tm->GetNull(), true);
   fun->AddParam(new CSymParam(0, "str", tm->GetPointer(tm->GetArray(CArrayType::OPEN, tm->GetChar()))));
   s->AddSymbol(fun);
 
   // procedure WriteLn();
-  fun = new CSymProc("WriteLn", tm->GetNull());
+  fun = new CSymProc("WriteLn", tm->GetNull(), true);
   s->AddSymbol(fun);
 }
 
@@ -33,6 +33,8 @@
 //------------------------------------------------------------------------------
 
 #include <cassert>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
@@ -42,6 +44,7 @@
 #include "scanner.h"
 #include "parser.h"
 #include "ir.h"
+#include "opt.h"
 #include "backend.h"
 using namespace std;
 
@@ -52,7 +55,11 @@ bool dump_asm = true;
 bool dump_dot = true;
 bool run_dot  = true;
 bool run_gcc  = false;
-string rte_path = "rte/IA32/";
+bool bounds_check = false;
+int opt_level = 0;
+int unswitch_budget = 100;
+bool target_x86_64 = false;
+string rte_path = "";
 vector<string> files;
 
 
@@ -71,6 +78,15 @@ void Syntax(string msg)
        << "  --no-asm       output assembly code to console instead of a file. Default: file" << endl
        << "  --no-dot       do not output the AST/IR in graphical form. Default: output in graphical form" << endl
        << "  --no-run-dot   do not run the dot command automatically. Default: run automatically" << endl
+       << "  --bounds-check terminate the program if an array index is out of bounds. Default: off" << endl
+       << "  --target <arch>" << endl
+       << "                 generate code for <arch> (ia32 or x86_64). Default: ia32" << endl
+       << "  --rte <path>   directory of the runtime library linked by --exe." << endl
+       << "                 Default: rte/IA32/ or rte/AMD64/ depending on the target" << endl
+       << "  -O<n>          set the optimization level to <n> (0-2). Default: 0" << endl
+       << "  --unswitch-budget <n>" << endl
+       << "                 maximal number of instructions added by loop unswitching" << endl
+       << "                 per procedure (-O2). 0 disables unswitching. Default: 100" << endl
        << endl
        << endl
        << "Examples:" << endl
@@ -104,17 +120,43 @@ void ParseArgs(int argc, char *argv[])
       else if (strcmp(argv[i], "--no-dot") == 0) dump_dot = false;
       else if (strcmp(argv[i], "--no-run-dot") == 0) run_dot = false;
       else if (strcmp(argv[i], "--exe") == 0) run_gcc = true;
+      else if (strcmp(argv[i], "--bounds-check") == 0) bounds_check = true;
+      else if (strcmp(argv[i], "--target") == 0) {
+        i++;
+        if (i == argc) Syntax("Missing argument after --target");
+        if (strcmp(argv[i], "x86_64") == 0) target_x86_64 = true;
+        else if (strcmp(argv[i], "ia32") == 0) target_x86_64 = false;
+        else Syntax("Unknown target '" + string(argv[i]) + "'.");
+      }
       else if (strcmp(argv[i], "--rte") == 0) {
         i++;
         if (i == argc) Syntax("Missing argument after --rte");
         rte_path = string(argv[i]);
       }
+      else if (strcmp(argv[i], "--unswitch-budget") == 0) {
+        i++;
+        if (i == argc) Syntax("Missing argument after --unswitch-budget");
+        char *end;
+        errno = 0;
+        long budget = strtol(argv[i], &end, 10);
+        if ((argv[i][0] < '0') || (argv[i][0] > '9') || (*end != '\0') ||
+            (errno == ERANGE) || (budget > INT_MAX))
+          Syntax("Invalid unswitch budget '" + string(argv[i]) + "'.");
+        unswitch_budget = (int)budget;
+      }
       else if (strcmp(argv[i], "--help") == 0) Syntax("");
       else Syntax("Unknown command line option '" + string(argv[i]) + "'.");
     }
+    else if (strncmp(argv[i], "-O", 2) == 0) {
+      if ((strlen(argv[i]) != 3) || (argv[i][2] < '0') || (argv[i][2] > '2'))
+        Syntax("Unknown optimization level '" + string(argv[i]) + "'.");
+      opt_level = argv[i][2] - '0';
+    }
     else files.push_back(string(argv[i]));
     i++;
   }
+
+  if (rte_path == "") rte_path = target_x86_64 ? "rte/AMD64/" : "rte/IA32/";
 }
 
 void RunDOT(string file)
@@ -138,7 +180,7 @@ void RunCompile(string file)
     string exe(file);
     exe.erase(exe.find(".mod"));
 
-    cmd << "gcc -m32 -o" << exe << " "
+    cmd << (target_x86_64 ? "gcc -o" : "gcc -m32 -o") << exe << " "
         << rte_path << "IO.s" << " "
         << rte_path << "ARRAY.s" << " "
         << file;
@@ -242,11 +284,17 @@ int main(int argc, char *argv[])
       DumpAST(file, dynamic_cast<CAstModule*>(ast));
 
       // AST to TAC conversion
-      CModule *m = new CModule(ast);
+      CModule *m = new CModule(ast, bounds_check);
+
+      // TAC optimization
+      COptimizer *opt = new COptimizer(opt_level);
+      opt->SetUnswitchBudget(unswitch_budget);
+      opt->Optimize(m);
+      delete opt;
 
       DumpTAC(file, m);
 
-      // output x86 assembly to console or file
+      // output x86 or x86-64 assembly to console or file
       ostream *out = &cout;
       ofstream *sout = NULL;
 
@@ -255,7 +303,9 @@ int main(int argc, char *argv[])
         out = sout;
       }
 
-      CBackend *be = new CBackendx86(*out);
+      CBackend *be;
+      if (target_x86_64) be = new CBackendx86_64(*out, opt_level);
+      else be = new CBackendx86(*out, opt_level);
       be->Emit(m);
 
       if (sout != NULL) {
@@ -210,12 +210,19 @@ int CSymParam::GetIndex(void) const
   return _index;
 }
 
+void CSymParam::SetIndex(int index)
+{
+  _index = index;
+}
+
 
 //------------------------------------------------------------------------------
 // CSymProc
 //
-CSymProc::CSymProc(const string name, const CType *return_type)
-  : CSymbol(name, stProcedure, return_type)
+CSymProc::CSymProc(const string name, const CType *return_type,
+                   bool external)
+  : CSymbol(name, stProcedure, return_type), _external(external),
+    _pure(false), _const(false), _modref(external)
 {
 }
 
@@ -235,6 +242,64 @@ const CSymParam* CSymProc::GetParam(int index) const
   return _param[index];
 }
 
+void CSymProc::RemoveParam(int index)
+{
+  assert((index >= 0) && ((size_t)index < _param.size()));
+  _param.erase(_param.begin() + index);
+
+  for (size_t i=index; i<_param.size(); i++) _param[i]->SetIndex(i);
+}
+
+bool CSymProc::IsExternal(void) const
+{
+  return _external;
+}
+
+void CSymProc::SetPure(bool pure)
+{
+  _pure = pure;
+}
+
+bool CSymProc::IsPure(void) const
+{
+  return _pure;
+}
+
+void CSymProc::SetConst(bool c)
+{
+  _const = c;
+}
+
+bool CSymProc::IsConst(void) const
+{
+  return _const;
+}
+
+void CSymProc::SetModRef(const set<const CSymbol*> &mod,
+                         const set<const CSymbol*> &ref)
+{
+  _mod = mod;
+  _ref = ref;
+  _modref = true;
+}
+
+bool CSymProc::HasModRef(void) const
+{
+  return _modref;
+}
+
+bool CSymProc::MayModify(const CSymbol *sym) const
+{
+  if (_pure) return false;
+
+  return !_modref || (_mod.count(sym) > 0);
+}
+
+bool CSymProc::MayRead(const CSymbol *sym) const
+{
+  return !_modref || (_ref.count(sym) > 0);
+}
+
 ostream& CSymProc::print(ostream &out, int indent) const
 {
   string ind(indent, ' ');
@@ -291,6 +356,18 @@ bool CSymtab::AddSymbol(CSymbol *s)
   }
 }
 
+bool CSymtab::RemoveSymbol(CSymbol *s)
+{
+  assert(s != NULL);
+
+  map<string, CSymbol*>::iterator it = _symtab.find(s->GetName());
+  if ((it == _symtab.end()) || (it->second != s)) return false;
+
+  _symtab.erase(it);
+  s->SetSymbolTable(NULL);
+  return true;
+}
+
 const CSymbol* CSymtab::FindSymbol(const string name, EScope scope) const
 {
   map<string, CSymbol*>::const_iterator it = _symtab.find(name);
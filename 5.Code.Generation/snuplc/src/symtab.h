@@ -35,6 +35,7 @@
 
 #include <iostream>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "data.h"
@@ -272,6 +273,9 @@ class CSymParam : public CSymLocal {
     /// @brief return the index of the paramter
     int GetIndex(void) const;
 
+    /// @brief set the index of the parameter
+    void SetIndex(int index);
+
     /// @}
 
     /// @brief print the symbol to an output stream
@@ -298,7 +302,9 @@ class CSymProc : public CSymbol {
     ///
     /// @param name procedure/function identifier
     /// @param return_type return type (NULL if none)
-    CSymProc(const string name, const CType *return_type);
+    /// @param external true for procedures of the runtime library
+    CSymProc(const string name, const CType *return_type,
+             bool external=false);
 
     /// @}
 
@@ -317,6 +323,57 @@ class CSymProc : public CSymbol {
     /// @retval CSymParam* parameter
     const CSymParam* GetParam(int index) const;
 
+    /// @brief remove the @a index-th parameter; the following parameters
+    ///        are renumbered
+    void RemoveParam(int index);
+
+    /// @brief returns true if the procedure is implemented by the runtime
+    ///        library. External procedures do not access SnuPL variables.
+    bool IsExternal(void) const;
+
+    /// @brief set whether the procedure is pure
+    void SetPure(bool pure);
+
+    /// @brief returns true if the procedure has no side effects: it does
+    ///        not modify global variables or memory outside its own frame,
+    ///        performs no I/O and cannot trap. Pure procedures may read
+    ///        global variables and memory and are assumed to terminate.
+    bool IsPure(void) const;
+
+    /// @brief set whether the procedure is const
+    void SetConst(bool c);
+
+    /// @brief returns true if the procedure is pure and its result only
+    ///        depends on the values of its scalar arguments, i.e., it does
+    ///        not read global variables or memory outside its own frame
+    bool IsConst(void) const;
+
+    /// @}
+
+    /// @name global variable summaries
+    ///
+    /// The global variables a procedure (including the procedures it calls)
+    /// may modify or read by name. Without a summary, SnuPL procedures are
+    /// assumed to access all global variables. Procedures of the runtime
+    /// library do not access SnuPL variables.
+    ///
+    /// @{
+
+    /// @brief set the global variables modified (@a mod) and read (@a ref)
+    void SetModRef(const set<const CSymbol*> &mod,
+                   const set<const CSymbol*> &ref);
+
+    /// @brief returns true if the procedure has a summary
+    bool HasModRef(void) const;
+
+    /// @brief returns true if a call to the procedure may modify the global
+    ///        variable @a sym
+    bool MayModify(const CSymbol *sym) const;
+
+    /// @brief returns true if a call to the procedure may read the global
+    ///        variable @a sym
+    bool MayRead(const CSymbol *sym) const;
+
     /// @}
 
     /// @brief print the symbol to an output stream
@@ -326,6 +383,12 @@ class CSymProc : public CSymbol {
 
   private:
     vector<CSymParam*> _param;      ///< parameter list
+    bool _external;                 ///< implemented by the runtime library
+    bool _pure;                     ///< no side effects
+    bool _const;                    ///< pure and reads no memory
+    bool _modref;                   ///< summary available
+    set<const CSymbol*> _mod;       ///< modified global variables
+    set<const CSymbol*> _ref;       ///< read global variables
 };
 
 
@@ -367,6 +430,12 @@ class CSymtab {
     /// @retval false if such a symbol already exists in the local symbol table
     bool AddSymbol(CSymbol *s);
 
+    /// @brief remove a symbol from the local symbol table; the symbol is
+    ///        not deleted
+    /// @retval true if the symbol was removed successfully
+    /// @retval false if the symbol is not in the local symbol table
+    bool RemoveSymbol(CSymbol *s);
+
     /// @brief return a symbol with a given name
     /// @param name symbol name (identifier)
     /// @param scope search scope (default: sGlobal)
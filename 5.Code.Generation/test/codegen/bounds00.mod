@@ -0,0 +1,86 @@
+//
+// bounds00
+//
+// array accesses in loops, all within bounds
+// (compile with --bounds-check; -O1 removes or hoists most checks)
+//
+// expected output:
+// 45
+// 420
+// 204
+// 0 1 2 3 4 5 6 7 8 9 
+//
+
+module bounds00;
+
+var a: integer[10];
+    m: integer[4][6];
+    n, i, j, s: integer;
+
+procedure fill(v: integer[]; n: integer);
+var i: integer;
+begin
+  i := 0;
+  while (i < n) do
+    v[i] := i*i;
+    i := i + 1
+  end
+end fill;
+
+function sum(v: integer[][]; r, c: integer): integer;
+var i, j, s: integer;
+begin
+  s := 0;
+  i := 0;
+  while (i < r) do
+    j := 0;
+    while (j < c) do
+      s := s + v[i][j];
+      j := j + 1
+    end;
+    i := i + 1
+  end;
+  return s
+end sum;
+
+begin
+  n := 9;
+  i := 0;
+  while (i < 10) do
+    a[i] := i;
+    i := i + 1
+  end;
+  i := 1;
+  while (i <= 9) do
+    a[i] := a[i-1] + a[i];
+    i := i + 1
+  end;
+  WriteInt(a[9]); WriteLn();
+
+  i := 0;
+  while (i < 4) do
+    j := 0;
+    while (j < 6) do
+      m[i][j] := i*10 + j;
+      j := j + 1
+    end;
+    i := i + 1
+  end;
+  WriteInt(sum(m, 4, 6)); WriteLn();
+
+  fill(a, n);
+  s := 0; i := n - 1;
+  while (i >= 0) do
+    s := s + a[i];
+    i := i - 1
+  end;
+  WriteInt(s); WriteLn();
+
+  i := 0;
+  while (i < n + 1) do
+    WriteInt(i); WriteChar(' ');
+    a[i] := 0;
+    i := i + 1
+  end;
+  WriteLn()
+end bounds00.
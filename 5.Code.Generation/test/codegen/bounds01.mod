@@ -0,0 +1,29 @@
+//
+// bounds01
+//
+// a bounds check failing in a loop that writes output before the access:
+// the output of the earlier iterations appears before the error
+// (compile with --bounds-check; the output must not change with -O1/-O2)
+//
+// input:
+// 10
+//
+// expected output:
+// 0 1 2 3 4 5 6 7 8 9 10 array index out of bounds
+//
+
+module bounds01;
+
+var a: integer[10];
+    n, i: integer;
+
+begin
+  n := ReadInt() + 2;
+  i := 0;
+  while (i < n) do
+    WriteInt(i); WriteChar(' ');
+    a[i] := i;
+    i := i + 1
+  end;
+  WriteLn()
+end bounds01.
@@ -0,0 +1,82 @@
+//
+// callconv00
+//
+// calling convention: more arguments than argument registers, calls nested
+// in the arguments of other calls, arrays passed by reference and addresses
+// of local and global arrays (x86-64: 8-byte pointers, stack alignment)
+//
+// expected output:
+// 36 -34
+// 67 12
+//  31 3 -5
+// 6 13
+//
+
+module callconv00;
+
+var g: integer[4];
+
+function sum8(a, b, c, d, e, f, h, i: integer): integer;
+begin
+  return a + b + c + d + e + f + h + i
+end sum8;
+
+function diff9(a, b, c, d, e, f, h, i, j: integer): integer;
+begin
+  return a - b - c - d - e - f - h - i - j + 1
+end diff9;
+
+function total(v: integer[]): integer;
+var i, s: integer;
+begin
+  i := 0;
+  s := 0;
+  while (i < DIM(v, 1)) do
+    s := s + v[i];
+    i := i + 1
+  end;
+  return s
+end total;
+
+procedure fill(v: integer[][]; c: char);
+var i, j: integer;
+begin
+  i := 0;
+  while (i < DIM(v, 1)) do
+    j := 0;
+    while (j < DIM(v, 2)) do
+      v[i][j] := i * 10 + j;
+      j := j + 1
+    end;
+    i := i + 1
+  end;
+  WriteChar(c)
+end fill;
+
+procedure local(n: integer);
+var m: integer[3][4];
+    k: integer;
+begin
+  fill(m, ' ');
+  WriteInt(m[2][3] + m[1][2] - 2 * n); WriteChar(' ');
+  k := m[0][1] + n;
+  WriteInt(k)
+end local;
+
+begin
+  WriteInt(sum8(1, 2, 3, 4, 5, 6, 7, 8)); WriteChar(' ');
+  WriteInt(diff9(1, 2, 3, 4, 5, 6, 7, 8, 1)); WriteLn();
+
+  WriteInt(sum8(sum8(1, 2, 3, 4, 5, 6, 7, 8), 1, 2, 3, 4, 5, 6,
+                sum8(1, 1, 1, 1, 1, 1, 1, 1) + diff9(9, 1, 1, 1, 1, 1, 1, 1, 1)));
+  WriteChar(' ');
+  g[0] := 1; g[1] := 2; g[2] := 4; g[3] := 5;
+  WriteInt(total(g)); WriteLn();
+
+  local(2); WriteChar(' ');
+  WriteInt(diff9(0, 0, 0, 0, 0, 0, 0, total(g), sum8(0, 0, 0, 0, 0, 0, 0, -6)));
+  WriteLn();
+  WriteInt(g[0] + g[3]); WriteChar(' ');
+  WriteInt(sum8(g[0], g[1], g[2], g[3], 1, 0, 0, 0));
+  WriteLn()
+end callconv00.
@@ -0,0 +1,58 @@
+//
+// closedform00
+//
+// loops evaluated in closed form with trip counts computed at run time:
+// distances between the initial value and the bound beyond INT_MAX, steps
+// in both directions (divided by magic numbers and shifts) and loops that
+// are not entered
+//
+// input:
+// 10
+//
+// expected output:
+// 1001 2003999999
+// 1000 1000007000
+// 572 857830974 -2004000582
+// 840 2100004210
+// 239 2009754634
+// 0 10
+//
+
+module closedform00;
+
+var n, i, c, s: integer;
+
+begin
+  n := ReadInt();
+
+  i := n - 2000000011;
+  c := 0;
+  while (i < 2000000000) do c := c + 1; i := i + 4000000 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  i := n - 2000000010;
+  c := 0;
+  while (i <= 1000000000 + n) do c := c + 1; i := i + 3000007 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  i := 2000000000 - n;
+  c := 0;
+  s := 0;
+  while (i > n - 2000000000) do c := c + 1; s := s + i; i := i - 7000001 end;
+  WriteInt(c); WriteChar(' '); WriteInt(s); WriteChar(' '); WriteInt(i); WriteLn();
+
+  i := n - 2100000000;
+  c := 0;
+  while (i < 2100000000) do c := c + 1; i := i + 5000005 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  i := n - 2000000000;
+  c := 0;
+  while (i <= 2000000000) do c := c + 1; i := i + 16777216 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  i := n;
+  c := 0;
+  while (i < 5) do c := c + 1; i := i + 1 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn()
+end closedform00.
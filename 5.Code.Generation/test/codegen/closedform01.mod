@@ -0,0 +1,49 @@
+//
+// closedform01
+//
+// loops with trip counts computed at run time whose induction variable
+// overflows before the loop ends: the closed form must not be used, the
+// loops run as written. The step of 1431655766 wraps around and exceeds the
+// bound after three iterations. The last loop's bound is the largest one
+// without overflow.
+//
+// input:
+// 10
+//
+// expected output:
+// 3 2147483601
+// 3 2147483602
+// 3 -2147483554
+// 2 715827894
+//
+
+module closedform01;
+
+var k, n, i, c: integer;
+
+begin
+  k := ReadInt();
+  n := k + 2147483590;
+
+  i := n - 1;
+  c := 0;
+  while (i < n) do c := c + 1; i := i + 1431655766 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  i := n;
+  c := 0;
+  while (i <= n) do c := c + 1; i := i + 1431655766 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  n := n - 2147483600 - 2147483600 + 47;
+  i := n + 1;
+  c := 0;
+  while (i > n) do c := c + 1; i := i - 1431655766 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn();
+
+  n := k + 715827872;
+  i := -2147483647 - 1 + k;
+  c := 0;
+  while (i < n) do c := c + 1; i := i + 1431655766 end;
+  WriteInt(c); WriteChar(' '); WriteInt(i); WriteLn()
+end closedform01.
@@ -0,0 +1,91 @@
+//
+// cmpbr00
+//
+// compare and branch: immediate and memory operands on either side, tests
+// against zero and branches on the flags of the preceding subtraction or
+// logical operation (sign tests included)
+//
+// input:
+// 10
+// 7
+// 3
+//
+// expected output:
+// 41 38 26 26
+// 10 0 3 1 -1
+// =qab <n. >qb
+//
+
+module cmpbr00;
+
+var g, n, m, k: integer;
+    a: integer[6];
+
+function classify(x, y: integer): integer;
+var r: integer;
+begin
+  r := 0;
+  if (x - y < 0) then r := r + 1 end;
+  if (x - y >= 0) then r := r + 2 end;
+  if (x - y = 0) then r := r + 4 end;
+  if (x - y # 0) then r := r + 8 end;
+  if (x - y > 0) then r := r + 16 end;
+  if (x - y <= 0) then r := r + 32 end;
+  return r
+end classify;
+
+function count(n: integer): integer;
+var c: integer;
+begin
+  c := 0;
+  while (n # 0) do
+    n := n - 1;
+    c := c + 2
+  end;
+  return c
+end count;
+
+function find(v: integer[]; x: integer): integer;
+var i: integer;
+begin
+  i := 0;
+  while ((i < DIM(v, 1)) && (v[i] # x)) do
+    i := i + 1
+  end;
+  if (i = DIM(v, 1)) then i := -1 end;
+  return i
+end find;
+
+procedure limits(x: integer; c: char);
+begin
+  if (x < g) then WriteChar('<') end;
+  if (g < x) then WriteChar('>') end;
+  if (x = 7) then WriteChar('=') end;
+  if (-3 > x) then WriteChar('n') end;
+  if (c = 'q') then WriteChar('q') end;
+  if (c # 'q') then WriteChar('.') end;
+  if (a[2] = x) then WriteChar('a') end;
+  if (x >= a[3]) then WriteChar('b') end
+end limits;
+
+begin
+  n := ReadInt();
+  m := ReadInt();
+  k := ReadInt();
+  WriteInt(classify(k, m + k - 5)); WriteChar(' ');
+  WriteInt(classify(m - 2, 5)); WriteChar(' ');
+  WriteInt(classify(k - 5, -m - 2)); WriteChar(' ');
+  WriteInt(classify(-2147483647 + k - 3, 2)); WriteLn();
+
+  a[0] := 4; a[1] := 9; a[2] := m; a[3] := 0; a[4] := -k; a[5] := 9;
+  WriteInt(count(k + 2)); WriteChar(' ');
+  WriteInt(count(k - 3)); WriteChar(' ');
+  WriteInt(find(a, k - 3)); WriteChar(' ');
+  WriteInt(find(a, m + 2)); WriteChar(' ');
+  WriteInt(find(a, k - 1)); WriteLn();
+
+  g := m;
+  limits(m, 'q'); WriteChar(' ');
+  limits(k - 8, 'z'); WriteChar(' ');
+  limits(n + 2, 'q'); WriteLn()
+end cmpbr00.
@@ -0,0 +1,64 @@
+//
+// consteval00
+//
+// compile-time evaluation of calls of const functions with constant
+// arguments. Calls that exceed the instruction budget or the nesting depth
+// of the evaluator are executed at runtime.
+//
+// expected output:
+// 6765 144 1 F
+// 3000000 1000
+// 25
+//
+
+module consteval00;
+
+var t: integer[4];
+    i: integer;
+
+function fib(n: integer): integer;
+begin
+  if (n < 2) then return n end;
+  return fib(n - 1) + fib(n - 2)
+end fib;
+
+function sq(x: integer): integer;
+begin
+  return x * x
+end sq;
+
+function odd(x: integer): boolean;
+begin
+  return x - x / 2 * 2 = 1
+end odd;
+
+function hex(x: integer): char;
+begin
+  if (x < 10) then return '0' end;
+  return 'F'
+end hex;
+
+function count(n: integer): integer;
+var c: integer;
+begin
+  c := 0;
+  while (c < n) do c := c + 1 end;
+  return c
+end count;
+
+function deep(n: integer): integer;
+begin
+  if (n = 0) then return 0 end;
+  return deep(n - 1) + 1
+end deep;
+
+begin
+  t[0] := fib(20);
+  t[1] := sq(sq(2) * 3);
+  WriteInt(t[0]); WriteChar(' '); WriteInt(t[1]); WriteChar(' ');
+  if (odd(7)) then WriteInt(1) else WriteInt(0) end; WriteChar(' ');
+  WriteChar(hex(15)); WriteLn();
+  WriteInt(count(3000000)); WriteChar(' '); WriteInt(deep(1000)); WriteLn();
+  i := 5;
+  WriteInt(sq(i)); WriteLn()
+end consteval00.
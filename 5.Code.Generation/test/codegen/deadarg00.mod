@@ -0,0 +1,42 @@
+//
+// deadarg00
+//
+// dead argument elimination: parameters that are never accessed and return
+// values that are never used are removed from procedures and call sites.
+// The side effects of the calls are preserved.
+//
+// expected output:
+// 3 7 12
+// 5
+//
+
+module deadarg00;
+
+var g: integer;
+    a: integer[4];
+
+function f(x, y, z: integer; v: integer[]): integer;
+begin
+  g := g + y;
+  return x * 2
+end f;
+
+function h(u, w: integer): integer;
+begin
+  return u + w
+end h;
+
+procedure p(u: integer; w: integer[]; c: char);
+begin
+  WriteInt(u)
+end p;
+
+begin
+  g := 1;
+  f(g + 1, 2, 5, a);
+  WriteInt(g); WriteChar(' ');
+  f(h(1, 2), 4, g, a);
+  p(g, a, ' '); WriteChar(' ');
+  p(f(0, 0, 0, a) + h(g, 5), a, 'x'); WriteLn();
+  p(h(2, 3), a, 'y'); WriteLn()
+end deadarg00.
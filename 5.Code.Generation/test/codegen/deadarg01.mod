@@ -0,0 +1,33 @@
+//
+// deadarg01
+//
+// dead argument elimination with nested calls: the arguments of a call
+// contain calls to the same procedure
+//
+// expected output:
+// 1 6
+// 5
+//
+
+module deadarg01;
+
+var s: integer;
+    ga: integer[3];
+
+function f0(p0, p1: integer; a: integer[]): integer;
+begin
+  return p0
+end f0;
+
+function f1(p0, p1, p2: integer): integer;
+begin
+  return p0 + p2
+end f1;
+
+begin
+  s := f0(f0(1, 2, ga), 3, ga);
+  WriteInt(s); WriteChar(' ');
+  WriteInt(f1(f1(1, f0(7, 8, ga), 2), f1(4, 5, 6), f0(f1(0, 0, 3), 1, ga)));
+  WriteLn();
+  WriteInt(f0(f0(f0(5, 1, ga), f0(6, 2, ga), ga), f0(7, 3, ga), ga)); WriteLn()
+end deadarg01.
@@ -0,0 +1,83 @@
+//
+// divmul00
+//
+// multiplication and division by constants (shifts, lea and multiplication
+// by magic numbers instead of imul/idiv)
+//
+// expected output:
+// 0 3 -3 21 -21 300 -300 2147483645 -2147483645 -2147483648
+// 0 10 -10 70 -70 1000 -1000 -10 10 0
+// 0 -5 5 -35 35 -500 500 -2147483643 2147483643 -2147483648
+// 0 -20 20 -140 140 -2000 2000 20 -20 0
+// 0 -90 90 -630 630 -9000 9000 90 -90 0
+// 0 0 0 0 0 0 0 0 0 0
+// 0 -1 1 -7 7 -100 100 -2147483647 2147483647 -2147483648
+// 0 16 -16 112 -112 1600 -1600 -16 16 0
+// 0 -64 64 -448 448 -6400 6400 64 -64 0
+// 0 7 -7 49 -49 700 -700 2147483641 -2147483641 -2147483648
+// 0 1000 -1000 7000 -7000 100000 -100000 -1000 1000 0
+// 0 0 0 3 -3 50 -50 1073741823 -1073741823 -1073741824
+// 0 0 0 -3 3 -50 50 -1073741823 1073741823 1073741824
+// 0 0 0 2 -2 33 -33 715827882 -715827882 -715827882
+// 0 0 0 -2 2 -33 33 -715827882 715827882 715827882
+// 0 0 0 1 -1 14 -14 306783378 -306783378 -306783378
+// 0 0 0 0 0 10 -10 214748364 -214748364 -214748364
+// 0 0 0 0 0 -12 12 -268435455 268435455 268435456
+// 0 0 0 0 0 1 -1 33554431 -33554431 -33554432
+// 0 0 0 0 0 0 0 3350208 -3350208 -3350208
+// 0 0 0 0 0 0 0 2147 -2147 -2147
+//
+
+module divmul00;
+
+var v: integer[10];
+    k: integer;
+
+procedure row(k: integer);
+var j, r: integer;
+begin
+  j := 0;
+  while (j < 10) do
+    if (k = 0) then r := v[j] * 3 end;
+    if (k = 1) then r := v[j] * 10 end;
+    if (k = 2) then r := v[j] * (-5) end;
+    if (k = 3) then r := v[j] * (-20) end;
+    if (k = 4) then r := v[j] * (-90) end;
+    if (k = 5) then r := v[j] * 0 end;
+    if (k = 6) then r := v[j] * (-1) end;
+    if (k = 7) then r := v[j] * 16 end;
+    if (k = 8) then r := v[j] * (-64) end;
+    if (k = 9) then r := v[j] * 7 end;
+    if (k = 10) then r := v[j] * 1000 end;
+    if (k = 11) then r := v[j] / 2 end;
+    if (k = 12) then r := v[j] / (-2) end;
+    if (k = 13) then r := v[j] / 3 end;
+    if (k = 14) then r := v[j] / (-3) end;
+    if (k = 15) then r := v[j] / 7 end;
+    if (k = 16) then r := v[j] / 10 end;
+    if (k = 17) then r := v[j] / (-8) end;
+    if (k = 18) then r := v[j] / 64 end;
+    if (k = 19) then r := v[j] / 641 end;
+    if (k = 20) then r := v[j] / 1000000 end;
+    WriteInt(r);
+    if (j < 9) then WriteChar(' ') end;
+    j := j + 1
+  end;
+  WriteLn()
+end row;
+
+procedure init();
+begin
+  v[0] := 0; v[1] := 1; v[2] := -1; v[3] := 7; v[4] := -7;
+  v[5] := 100; v[6] := -100; v[7] := 2147483647; v[8] := -2147483647;
+  v[9] := -2147483647 - 1
+end init;
+
+begin
+  init();
+  k := 0;
+  while (k < 21) do
+    row(k);
+    k := k + 1
+  end
+end divmul00.
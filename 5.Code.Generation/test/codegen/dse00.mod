@@ -0,0 +1,52 @@
+//
+// dse00
+//
+// dead store elimination: overwritten stores to locals, globals and array
+// elements are removed; stores observed by called procedures or through
+// aliasing array parameters are kept
+//
+// expected output:
+// 3 6 6 7 2
+// 3 6 6 9
+//
+
+module dse00;
+
+var g, h: integer;
+    a: integer[4];
+
+procedure show();
+begin
+  WriteInt(h); WriteChar(' ')
+end show;
+
+procedure store(v: integer[]; x: integer);
+var l: integer;
+    scratch: integer[8];
+    b: boolean;
+begin
+  l := x;
+  b := x > 0;
+  l := x + 1;
+  g := 1;
+  h := 3;
+  show();
+  h := l;
+  g := 2;
+  scratch[0] := l;
+  scratch[1] := g;
+  v[1] := 5;
+  a[1] := 6;
+  WriteInt(v[1]); WriteChar(' ');
+  a[2] := 8;
+  a[2] := 9;
+  b := true;
+  if (b) then WriteInt(a[1]); WriteChar(' ') end
+end store;
+
+begin
+  store(a, 6);
+  WriteInt(h); WriteChar(' '); WriteInt(g); WriteLn();
+  store(a, 1);
+  WriteInt(a[2]); WriteLn()
+end dse00.
@@ -0,0 +1,72 @@
+//
+// frame00
+//
+// stack frames: leaf procedures without locals run without a frame and
+// address their parameters relative to %esp; only the callee-saved
+// registers actually used are saved
+//
+// expected output:
+// -7 29 axx
+// 36 20 4
+//
+
+module frame00;
+
+var g: integer;
+    b: boolean;
+
+procedure touch();
+begin
+  g := g + 1
+end touch;
+
+function id(x: integer): integer;
+begin
+  return x
+end id;
+
+function mix(a, b, c, d, e: integer): integer;
+begin
+  return (a - b) * c + d / e
+end mix;
+
+function pick(c: char; f: boolean; x, y: integer): char;
+begin
+  if (f) then
+    if (x < y) then return c end
+  end;
+  return 'x'
+end pick;
+
+function square(x: integer): integer;
+var t: integer[2];
+begin
+  t[0] := x;
+  t[1] := x * x;
+  return t[1] - t[0] + x
+end square;
+
+function outer(n: integer): integer;
+var s: integer;
+begin
+  s := 0;
+  while (n > 0) do
+    touch();
+    s := s + mix(n, 1, 2, id(10), 5);
+    n := n - 1
+  end;
+  return s
+end outer;
+
+begin
+  g := 0;
+  b := true;
+  WriteInt(id(-7)); WriteChar(' ');
+  WriteInt(mix(9, 3, 4, 17, 3)); WriteChar(' ');
+  WriteChar(pick('a', b, 1, 2));
+  WriteChar(pick('a', b, 2, 1));
+  WriteChar(pick('b', !b, 1, 2)); WriteLn();
+  WriteInt(square(6)); WriteChar(' ');
+  WriteInt(outer(4)); WriteChar(' ');
+  WriteInt(g); WriteLn()
+end frame00.
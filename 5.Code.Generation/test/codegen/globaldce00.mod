@@ -0,0 +1,44 @@
+//
+// globaldce00
+//
+// global dead code elimination: procedures that cannot be reached from the
+// module body, globals and string constants that the remaining code does
+// not reference are removed. From -O1 on, the assembly contains neither
+// 'unused', 'helper', 'spare' and 'orphan' nor the string "never printed";
+// 'used', 'count' and "count: " remain.
+//
+// input:
+// 4
+//
+// expected output:
+// count: 5
+// count: 9
+//
+
+module globaldce00;
+
+var count, spare, orphan: integer;
+
+procedure helper(n: integer);
+begin
+  orphan := orphan + n
+end helper;
+
+procedure unused(n: integer);
+begin
+  WriteStr("never printed");
+  helper(n);
+  spare := n
+end unused;
+
+procedure used(n: integer);
+begin
+  count := count + n;
+  WriteStr("count: "); WriteInt(count); WriteLn()
+end used;
+
+begin
+  count := 1;
+  used(ReadInt());
+  used(count - 1)
+end globaldce00.
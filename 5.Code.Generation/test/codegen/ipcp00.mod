@@ -0,0 +1,69 @@
+//
+// ipcp00
+//
+// constant arguments (interprocedural constant propagation and procedure
+// cloning, -O1/-O2)
+//
+// expected output:
+// 7
+// 1
+// 15
+// -715
+// 120
+// 720
+// 42
+// 1 2 3 
+//
+
+module ipcp00;
+
+var g: integer;
+    v: integer[16];
+
+function scale(x, k: integer): integer;
+begin
+  if (k = 0) then return x
+  else return x * k + 1
+  end
+end scale;
+
+procedure fill(n: integer; mode: boolean);
+var i: integer;
+begin
+  i := 0;
+  while (i < n) do
+    if (mode) then v[i] := i else v[i] := 0 - i end;
+    i := i + 1
+  end
+end fill;
+
+function fact(n: integer): integer;
+begin
+  if (n <= 1) then return 1 end;
+  return n * fact(n - 1)
+end fact;
+
+procedure twice(a: integer);
+var c: integer;
+begin
+  c := a;
+  c := c + 1;
+  g := g + scale(c, a)
+end twice;
+
+procedure show(n: integer; c: char);
+begin
+  WriteInt(n); WriteChar(c)
+end show;
+
+begin
+  g := 0;
+  WriteInt(scale(3, 2)); WriteLn();
+  WriteInt(scale(g, 5)); WriteLn();
+  fill(16, true); WriteInt(v[15]); WriteLn();
+  fill(8, false); WriteInt(v[7]); WriteInt(v[15]); WriteLn();
+  WriteInt(fact(5)); WriteLn();
+  WriteInt(fact(g + 6)); WriteLn();
+  twice(4); twice(4); WriteInt(g); WriteLn();
+  show(1, ' '); show(2, ' '); show(3, ' '); WriteLn()
+end ipcp00.
@@ -0,0 +1,93 @@
+//
+// isel00
+//
+// tree-pattern-matching instruction selection: address arithmetic by lea,
+// immediate and memory operands, in-place updates, tests against zero,
+// divisions inside expressions and byte-sized operands
+//
+// input:
+// 10
+// 7
+// 3
+//
+// expected output:
+// 33 -3 4 28
+// 1 1 -1 0
+// 12 7 17
+// 5 -5 0 -4
+// 56 ok
+//
+
+module isel00;
+
+var g, n, m, k: integer;
+    a: integer[8];
+
+procedure lea(x, y: integer);
+var s, t, u: integer;
+begin
+  s := x + y * 4 + 3;
+  t := x - 13;
+  u := 2 * (x + 1) - 2 * x + 2;
+  WriteInt(s); WriteChar(' ');
+  WriteInt(t); WriteChar(' ');
+  WriteInt(u); WriteChar(' ');
+  WriteInt(s - y)
+end lea;
+
+procedure sign(x: integer);
+begin
+  if (x < 0) then WriteInt(-1)
+  else
+    if (x = 0) then WriteInt(0)
+    else WriteInt(1)
+    end
+  end
+end sign;
+
+procedure div(x, y, z: integer);
+var q, r, w: integer;
+begin
+  q := x + y / z;
+  r := x - x / z * z;
+  w := (x + y) / (z - 1) + 0 - x / 4;
+  g := g + q;
+  g := g - 1;
+  g := -g;
+  WriteInt(q); WriteChar(' ');
+  WriteInt(r + w); WriteChar(' ');
+  WriteInt(g)
+end div;
+
+procedure bytes(c: char; b: boolean);
+var i, n: integer;
+begin
+  i := 0;
+  n := 0;
+  while (i < 8) do
+    a[i] := i * i - 3 * i;
+    if (b && (c = 'x')) then n := n + a[i] end;
+    i := i + 1
+  end;
+  WriteInt(a[4] + 1); WriteChar(' ');
+  WriteInt(-a[4] - 1); WriteChar(' ');
+  WriteInt(0 - a[3]); WriteChar(' ');
+  WriteInt(a[1] + a[2] - 0 * a[5]); WriteLn();
+  WriteInt(n)
+end bytes;
+
+begin
+  n := ReadInt();
+  m := ReadInt();
+  k := ReadInt();
+  g := -28;
+  lea(n, m - 2); WriteLn();
+  sign(k - 2); WriteChar(' ');
+  sign(k - 1); WriteChar(' ');
+  sign(k - 7); WriteChar(' ');
+  sign(k - 3); WriteLn();
+  div(n, m, k); WriteLn();
+  bytes('x', true);
+  if (g # 0) then WriteStr(" ok") end;
+  WriteLn()
+end isel00.
@@ -0,0 +1,51 @@
+//
+// modref00
+//
+// mod/ref summaries of global variables: expressions over globals that are
+// not modified by the called procedures are loop-invariant
+//
+// expected output:
+// 1111111111 120
+// 1 2 3 4 5 45
+//
+
+module modref00;
+
+var g, h, i, s, n: integer;
+
+procedure seth(x: integer);
+begin
+  h := x
+end seth;
+
+procedure rec(x: integer);
+begin
+  if (x > 0) then seth(x); rec(x - 1) end
+end rec;
+
+procedure incg();
+begin
+  g := g + 1
+end incg;
+
+begin
+  g := 4; n := 10;
+  i := 0; s := 0;
+  while (i < n) do
+    s := s + g * 3;
+    rec(2);
+    WriteInt(h);
+    i := i + 1
+  end;
+  WriteChar(' '); WriteInt(s); WriteLn();
+
+  g := 0; n := 5;
+  i := 0; s := 0;
+  while (i < n) do
+    incg();
+    s := s + g * 3;
+    WriteInt(g); WriteChar(' ');
+    i := i + 1
+  end;
+  WriteInt(s); WriteLn()
+end modref00.
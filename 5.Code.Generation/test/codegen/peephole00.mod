@@ -0,0 +1,66 @@
+//
+// peephole00
+//
+// peephole optimization: returns falling through to the epilogue, values
+// reloaded right after being stored, loads folded into arithmetic, and
+// registers cleared between a comparison and the branch using it
+//
+// expected output:
+// 0 10 7
+// 39
+// 15 0
+//
+
+module peephole00;
+
+var a: integer[6];
+    z: integer;
+
+function clamp(x, lo, hi: integer): integer;
+begin
+  if (x < lo) then return lo end;
+  if (x > hi) then return hi end;
+  return x
+end clamp;
+
+function spill(p, q, r: integer): integer;
+var s, t, u, v, w, x, y: integer;
+begin
+  s := p + q; t := q + r; u := r + p;
+  v := s * t; w := t * u; x := u * s;
+  y := 0;
+  while (y < 3) do
+    s := s + t - u;
+    t := t + v - w;
+    u := u + x - s;
+    v := 0;
+    y := y + 1
+  end;
+  return s + t + u + v + w + x + y
+end spill;
+
+procedure zeros(n: integer);
+var i, k: integer;
+begin
+  i := 0;
+  k := 0;
+  while (i < n) do
+    if (i = 2) then k := 0 else k := k + a[i] end;
+    a[i] := 0;
+    i := i + 1
+  end;
+  WriteInt(k); WriteChar(' ');
+  WriteInt(a[0] + a[n-1])
+end zeros;
+
+begin
+  WriteInt(clamp(-5, 0, 10)); WriteChar(' ');
+  WriteInt(clamp(15, 0, 10)); WriteChar(' ');
+  WriteInt(clamp(7, 0, 10)); WriteLn();
+
+  WriteInt(spill(1, 2, 3)); WriteLn();
+
+  a[0] := 1; a[1] := 2; a[2] := 3; a[3] := 4; a[4] := 5; a[5] := 6;
+  z := 0;
+  zeros(6); WriteLn()
+end peephole00.
@@ -0,0 +1,62 @@
+//
+// pre00
+//
+// partially redundant and loop-invariant expressions (partial redundancy
+// elimination, -O2)
+//
+// expected output:
+// 174
+// 66
+// 255
+// 4800
+// 140
+//
+
+module pre00;
+
+var a: integer[8][8];
+    x, y, n, i, j, s: integer;
+
+procedure p(c: boolean; r, k: integer);
+var t, u: integer;
+begin
+  if (c) then
+    t := r * 8 + k
+  else
+    t := 0
+  end;
+  u := r * 8 + k;
+  WriteInt(t + u); WriteLn()
+end p;
+
+function inv(n, m: integer): integer;
+var i, s: integer;
+begin
+  i := 0; s := 0;
+  while (i < n) do
+    s := s + m * 3 + i;
+    i := i + 1
+  end;
+  return s
+end inv;
+
+begin
+  x := 10; y := 7;
+  p(x > y, x, y); p(x < y, y, x);
+  WriteInt(inv(x, y)); WriteLn();
+  s := 0;
+  i := 0;
+  while (i < 8) do
+    j := 0;
+    while (j < 8) do
+      a[i][j] := (x + y) * i - j / 2;
+      s := s + a[i][j] + (x + y);
+      j := j + 1
+    end;
+    i := i + 1
+  end;
+  WriteInt(s); WriteLn();
+  if (x > 3) then n := x * y else n := 0 end;
+  n := n + x * y;
+  WriteInt(n); WriteLn()
+end pre00.
@@ -0,0 +1,74 @@
+//
+// purecall00
+//
+// calls of pure functions: reuse of results, hoisting out of loops and
+// removal of unused calls. Calls of impure functions must be kept.
+//
+// expected output:
+// 18
+// 14
+// 650
+// 3 9
+//
+
+module purecall00;
+
+var g, i, s, n: integer;
+    a: integer[10];
+
+function sq(x: integer): integer;
+begin
+  return x * x
+end sq;
+
+function rd(x: integer): integer;
+begin
+  return g + x
+end rd;
+
+function fact(n: integer): integer;
+begin
+  if (n <= 1) then return 1 else return n * fact(n - 1) end
+end fact;
+
+function len(v: integer[]): integer;
+var l: integer[3];
+begin
+  l[0] := DIM(v, 1);
+  return l[0]
+end len;
+
+procedure side(x: integer);
+begin
+  g := x
+end side;
+
+function count(x: integer): integer;
+begin
+  n := n + 1;
+  return x * x
+end count;
+
+begin
+  g := 3;
+  s := sq(g) + sq(g);
+  WriteInt(s); WriteLn();
+
+  s := rd(1) + rd(1);
+  side(5);
+  s := s + rd(1);
+  WriteInt(s); WriteLn();
+
+  i := 0; s := 0;
+  while (i < 5) do
+    s := s + fact(g) + len(a);
+    sq(i);
+    i := i + 1
+  end;
+  WriteInt(s); WriteLn();
+
+  n := 0;
+  s := count(2) + count(2);
+  count(1);
+  WriteInt(n); WriteChar(' '); WriteInt(s + 1); WriteLn()
+end purecall00.
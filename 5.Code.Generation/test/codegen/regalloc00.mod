@@ -0,0 +1,46 @@
+//
+// regalloc00
+//
+// register allocation: more values are live than there are registers, some
+// across calls and divisions; a local is read before it is written and must
+// start out as zero; ReadInt must preserve the callee-saved registers
+//
+// input:
+// 10
+// 7
+//
+// expected output:
+// 554 10 7
+//
+
+module regalloc00;
+
+var n, m: integer;
+
+function f(x: integer): integer;
+begin
+  return x * 3 + 1
+end f;
+
+function mix(a, b, c: integer): integer;
+var s, t, u, v, w, i: integer;
+begin
+  i := 0;
+  while (i < 10) do
+    s := s + a;
+    t := b / (i + 1);
+    u := c - t;
+    v := f(u);
+    w := w + v / 7 + s;
+    i := i + 1
+  end;
+  m := ReadInt();
+  return s + t + u + v + w + i
+end mix;
+
+begin
+  n := ReadInt();
+  WriteInt(mix(n, 100, 5)); WriteChar(' ');
+  WriteInt(n); WriteChar(' ');
+  WriteInt(m); WriteLn()
+end regalloc00.
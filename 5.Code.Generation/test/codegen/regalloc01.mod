@@ -0,0 +1,53 @@
+//
+// regalloc01
+//
+// graph-coloring register allocation: copies that stay live while their
+// source is modified must not share a register with it; rotating copies
+// in a loop and copies of values live across calls
+//
+// input:
+// 10
+//
+// expected output:
+// 5 6
+// 13 21 34
+// 8 16
+//
+
+module regalloc01;
+
+var n: integer;
+
+function id(x: integer): integer;
+begin
+  return x
+end id;
+
+procedure copies(a: integer);
+var b, c, d, i, t: integer;
+begin
+  b := a;
+  a := a + 1;
+  WriteInt(b); WriteChar(' '); WriteInt(a); WriteLn();
+
+  b := 0; c := 1; d := 1; i := 0;
+  while (i < 6) do
+    t := c + d;
+    b := c;
+    c := d;
+    d := t;
+    i := i + 1
+  end;
+  WriteInt(c); WriteChar(' '); WriteInt(d); WriteChar(' '); WriteInt(c + d); WriteLn();
+
+  b := id(a) + 2;
+  c := b;
+  d := id(c) + 1;
+  b := b + id(d) - 1;
+  WriteInt(c); WriteChar(' '); WriteInt(b); WriteLn()
+end copies;
+
+begin
+  n := ReadInt();
+  copies(n - 5)
+end regalloc01.
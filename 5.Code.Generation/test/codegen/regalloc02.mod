@@ -0,0 +1,52 @@
+//
+// regalloc02
+//
+// linear-scan register allocation: candidates live at the entry of a
+// procedure (arguments and locals read before they are written) need
+// distinct registers, even if other intervals end at the first instruction
+//
+// input:
+// 10
+// 7
+//
+// expected output:
+// 63
+// 93
+// 51
+// 3 10
+//
+
+module regalloc02;
+
+var n, m: integer;
+    a: integer[4];
+
+function f1(p0, p1: integer; arr: integer[]): integer;
+var u1, l1: integer;
+begin
+  l1 := p0 + p1 + DIM(arr, 1);
+  return u1 + l1 * 3
+end f1;
+
+function f(p0, p1: integer): integer;
+var u1: integer;
+begin
+  return (p0 + p1) * 3 + u1
+end f;
+
+procedure h(p0, p1: integer);
+var a1, z1: integer;
+begin
+  a1 := p0 - p1;
+  WriteInt(a1 + z1); WriteChar(' ');
+  WriteInt(p0 + z1)
+end h;
+
+begin
+  n := ReadInt();
+  m := ReadInt();
+  WriteInt(f1(n, m, a)); WriteLn();
+  WriteInt(f1(m, n + 10, a)); WriteLn();
+  WriteInt(f(n, m)); WriteLn();
+  h(n, m); WriteLn()
+end regalloc02.
@@ -0,0 +1,88 @@
+//
+// regcall00
+//
+// register calling convention: the first two arguments of calls between
+// procedures of the module are passed in registers, the runtime builtins
+// keep the stack. Swapped arguments, recursion, char and boolean arguments,
+// arguments that are live across calls and nested calls in arguments
+//
+// input:
+// 10
+// 7
+// 3
+//
+// expected output:
+// 3 -3 6 7
+// a-c
+// 10 1006
+// -3 -320
+// -7 7 -8 8 -10 10
+//
+
+module regcall00;
+
+var n, m, k: integer;
+
+function sub(a, b: integer): integer;
+begin
+  return a - b
+end sub;
+
+function gcd(a, b: integer): integer;
+begin
+  if (b = 0) then return a
+  else return gcd(b, a - a / b * b)
+  end
+end gcd;
+
+function pick(c: char; b: boolean): char;
+begin
+  if (b) then return c
+  else return '-'
+  end
+end pick;
+
+function neg(a: integer): integer;
+begin
+  return -a
+end neg;
+
+function mix(a, b, c: integer): integer;
+var s: integer;
+begin
+  s := sub(b, a);
+  WriteInt(a); WriteChar(' ');
+  s := s + sub(a, b) * c + neg(b);
+  return s + a * 100 + b
+end mix;
+
+procedure swap(a, b: integer);
+var i: integer;
+begin
+  i := 0;
+  while (i < 3) do
+    WriteInt(sub(b, a)); WriteChar(' ');
+    WriteInt(sub(a, b)); WriteChar(' ');
+    i := i + 1;
+    a := a + i
+  end
+end swap;
+
+begin
+  n := ReadInt();
+  m := ReadInt();
+  k := ReadInt();
+
+  WriteInt(sub(n, m)); WriteChar(' ');
+  WriteInt(sub(m, n)); WriteChar(' ');
+  WriteInt(gcd(n * 9, m * 6)); WriteChar(' ');
+  WriteInt(gcd(sub(n, k), gcd(m + 7, 21))); WriteLn();
+
+  WriteChar(pick('a', n > m)); WriteChar(pick('b', n < m));
+  WriteChar(pick(pick('c', true), k = 3)); WriteLn();
+
+  WriteInt(mix(n, m, k)); WriteLn();
+  WriteInt(mix(neg(k), sub(n, neg(m)), gcd(n, 4))); WriteLn();
+
+  swap(n, k); WriteLn()
+end regcall00.
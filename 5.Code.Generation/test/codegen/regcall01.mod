@@ -0,0 +1,56 @@
+//
+// regcall01
+//
+// register calling convention: the register arguments are loaded at the
+// call. Arguments in %ecx and %edx that trade places, a global argument
+// that a call evaluating a later argument modifies, and array elements and
+// characters passed in registers
+//
+// input:
+// 3
+// 4
+//
+// expected output:
+// 1314 902
+// 5 7
+// 20 x
+//
+
+module regcall01;
+
+var g: integer;
+    a: integer[3];
+
+function d(a, b: integer): integer;
+begin
+  return a * 100 + b
+end d;
+
+function inc(): integer;
+begin
+  g := g + 1;
+  return g
+end inc;
+
+procedure show(c: char; n: integer);
+begin
+  WriteInt(n); WriteChar(' '); WriteChar(c); WriteLn()
+end show;
+
+procedure p(x, y: integer);
+begin
+  WriteInt(d(x * y + 1, y * x + 2)); WriteChar(' ');
+  WriteInt(d(g + x, g - y)); WriteLn()
+end p;
+
+begin
+  g := 5;
+  p(ReadInt(), ReadInt());
+
+  WriteInt(d(inc(), g) - 600); WriteChar(' ');
+  WriteInt(d(g, inc()) - 700); WriteLn();
+
+  a[0] := 20;
+  a[1] := a[0];
+  show('x', d(a[1], a[0]) / 101)
+end regcall01.
@@ -0,0 +1,77 @@
+//
+// shape00
+//
+// array shapes: element addresses of statically shaped global and local
+// arrays are computed without runtime calls, open arrays read the sizes
+// of their dimensions from the array header; DIM of static arrays is a
+// constant
+//
+// expected output:
+// 14 8 15
+// 15 10
+// 234 zy
+// 107 13
+//
+
+module shape00;
+
+var g: integer[3][5];
+    c: char[2][3][4];
+
+procedure fill(v: integer[][]; base: integer);
+var i, j: integer;
+begin
+  i := 0;
+  while (i < DIM(v, 1)) do
+    j := 0;
+    while (j < DIM(v, 2)) do
+      v[i][j] := base + i * DIM(v, 2) + j;
+      j := j + 1
+    end;
+    i := i + 1
+  end
+end fill;
+
+function sum(v: integer[][]; d: integer): integer;
+var i, s: integer;
+begin
+  i := 0;
+  s := 0;
+  while (i < DIM(v, d)) do
+    if (d = 1) then s := s + v[i][0] else s := s + v[0][i] end;
+    i := i + 1
+  end;
+  return s
+end sum;
+
+procedure chars(x: char[][][]);
+begin
+  x[1][2][3] := 'z';
+  x[0][1][2] := 'y';
+  WriteInt(DIM(x, 1) * 100 + DIM(x, 2) * 10 + DIM(x, 3))
+end chars;
+
+procedure local(k: integer);
+var m: integer[4][2];
+    n: integer[7];
+begin
+  fill(m, k);
+  n[6] := m[3][1];
+  WriteInt(n[6]); WriteChar(' ');
+  WriteInt(DIM(m, 1) + DIM(m, 2) + DIM(n, 1))
+end local;
+
+begin
+  fill(g, 0);
+  WriteInt(g[2][4]); WriteChar(' ');
+  WriteInt(g[1][0] + g[0][3]); WriteChar(' ');
+  WriteInt(DIM(g, 1) * DIM(g, 2)); WriteLn();
+
+  WriteInt(sum(g, 1)); WriteChar(' ');
+  WriteInt(sum(g, 2)); WriteLn();
+
+  chars(c); WriteChar(' ');
+  WriteChar(c[1][2][3]); WriteChar(c[0][1][2]); WriteLn();
+
+  local(100); WriteLn()
+end shape00.
@@ -0,0 +1,60 @@
+//
+// simplify00
+//
+// algebraic identities, constant reassociation and rebalancing of
+// addition chains
+//
+// expected output:
+// 12 0 -7 7 21
+// 13 -5 30
+// 15 18 1
+// 2 29 3
+//
+
+module simplify00;
+
+var a: integer[3][4];
+    i, j, k, n: integer;
+    b: boolean;
+
+procedure show(x, y, z: integer);
+begin
+  WriteInt(x); WriteChar(' ');
+  WriteInt(y); WriteChar(' ');
+  WriteInt(z); WriteLn()
+end show;
+
+function chain(p, q, r, s, t: integer): integer;
+begin
+  return p + q + r + s + t + 1 - 2
+end chain;
+
+begin
+  i := 7; j := 3;
+
+  // identities
+  k := (i + 0) * 1 + 5;
+  WriteInt(k); WriteChar(' ');
+  WriteInt(i - i); WriteChar(' ');
+  WriteInt(0 - i); WriteChar(' ');
+  WriteInt(-(-i)); WriteChar(' ');
+  WriteInt(3 * i * 1); WriteLn();
+
+  // reassociation; i changes between the computations
+  n := (i + 1) + 2;
+  i := i + 10;
+  k := (i - 1) - 2 - 1;
+  show(n + 3, 1 - (j + 3) * 1, (j - 1) * 3 * 5);
+
+  // rebalanced chain
+  n := chain(1, 2, 3, 4, 6);
+  b := !!(n = 15);
+  if (b && true) then
+    a[1][2] := n + j;
+    show(n, a[1][2], i / 17)
+  end;
+
+  // array designators with missing indices
+  a[2][0] := 2;
+  show(a[2][0], a[1][2] - a[2][0] + k, j / (j - 2))
+end simplify00.
@@ -0,0 +1,75 @@
+//
+// unswitch00
+//
+// loop-invariant conditions inside loops (loop unswitching, -O2)
+//
+// expected output:
+// 2025
+// 1575
+// 1624
+// abababa
+// 19 5 10
+// 19 5 10
+//
+
+module unswitch00;
+
+var mode, lim, acc: integer;
+    fast: boolean;
+    v: integer[64];
+
+procedure toggle();
+begin
+  if (mode = 0) then mode := 1 else mode := 0 end
+end toggle;
+
+procedure nested(n: integer);
+var i, j: integer;
+begin
+  i := 0;
+  while (i < n) do
+    j := 0;
+    while (j < n) do
+      if (fast) then
+        acc := acc + i * j
+      else
+        if (mode > 0) then acc := acc - j else acc := acc + 1 end
+      end;
+      j := j + 1
+    end;
+    i := i + 1
+  end
+end nested;
+
+procedure modified(n: integer);
+var i: integer;
+begin
+  i := 0;
+  while (i < n) do
+    if (mode = 1) then WriteChar('a') else WriteChar('b') end;
+    toggle();
+    i := i + 1
+  end;
+  WriteLn()
+end modified;
+
+procedure local(n, k: integer);
+var i: integer;
+begin
+  i := 0;
+  while (i < n) do
+    if (k > 2) then v[i] := i else v[i] := 0 - i end;
+    if (i > k) then k := k + 1 end;
+    i := i + 1
+  end;
+  WriteInt(k); WriteChar(' '); WriteInt(v[5]); WriteChar(' '); WriteInt(v[10]); WriteLn()
+end local;
+
+begin
+  acc := 0;
+  fast := true; mode := 0; nested(10); WriteInt(acc); WriteLn();
+  fast := false; mode := 1; nested(10); WriteInt(acc); WriteLn();
+  fast := false; mode := 0; nested(7); WriteInt(acc); WriteLn();
+  mode := 1; modified(7);
+  local(20, 1); local(20, 5)
+end unswitch00.
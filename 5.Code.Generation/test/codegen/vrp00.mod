@@ -0,0 +1,80 @@
+//
+// vrp00
+//
+// value range propagation: comparisons implied by dominating conditions,
+// bounds checks that always succeed, divisions of non-negative values, and
+// arithmetic that may wrap around
+//
+// expected output:
+// 1 2 3 0 -1 -2 -3
+// 45 9 8 7 6 5 4 3 2 1 0
+// -2147483648 1073741823 -1073741823
+// 5 2 0 2
+//
+
+module vrp00;
+
+var a: integer[10];
+    i, s: integer;
+
+procedure sign(x: integer);
+begin
+  if (x > 0) then
+    if (x >= 1) then WriteInt(x) else WriteInt(100) end
+  else
+    if (x = 0) then WriteInt(0)
+    else
+      if (x < 0) then WriteInt(x) else WriteInt(-100) end
+    end
+  end;
+  WriteChar(' ')
+end sign;
+
+procedure fill(v: integer[]);
+var k: integer;
+begin
+  k := 0;
+  while (k < DIM(v, 1)) do
+    v[k] := k;
+    k := k + 1
+  end
+end fill;
+
+procedure skip(x: integer);
+begin
+  if (x # 5) then
+    if (x >= 5) then WriteInt(x / 3) else WriteInt(x / 2) end
+  else
+    WriteInt(x)
+  end;
+  WriteChar(' ')
+end skip;
+
+begin
+  sign(1); sign(2); sign(3); sign(0); sign(-1); sign(-2); sign(-3); WriteLn();
+
+  fill(a);
+  s := 0;
+  i := 9;
+  while (i >= 0) do
+    s := s + a[i];
+    i := i - 1
+  end;
+  WriteInt(s);
+  i := 9;
+  while (i >= 0) do
+    WriteChar(' '); WriteInt(a[i] / 1);
+    i := i - 1
+  end;
+  WriteLn();
+
+  i := 2147483647;
+  i := i + 1;
+  WriteInt(i); WriteChar(' ');
+  i := 2147483647;
+  WriteInt(i / 2); WriteChar(' ');
+  i := -2147483647;
+  WriteInt(i / 2); WriteLn();
+
+  skip(5); skip(4); skip(1); skip(6); WriteLn()
+end vrp00.
@@ -0,0 +1,69 @@
+//
+// zeroinit00
+//
+// zero-initialization of locals: only locals that may be read before they
+// are written are cleared in the prologue. Scalars read before any
+// assignment, assigned on some paths only, arrays read directly or by a
+// callee must still start out as zero
+//
+// expected output:
+// 0 21 f -
+// 4 21 f p
+// 5 3 9
+// 5 3 9
+//
+
+module zeroinit00;
+
+function total(v: integer[]): integer;
+var i, s: integer;
+begin
+  i := 0;
+  while (i < DIM(v, 1)) do
+    s := s + v[i];
+    i := i + 1
+  end;
+  return s
+end total;
+
+procedure scalars(n: integer);
+var a, b, c, d: integer;
+    ch: char;
+    f: boolean;
+begin
+  if (n > 0) then a := n; ch := 'p' end;
+  b := 7;
+  while (d < 3) do
+    c := c + b;
+    d := d + 1
+  end;
+  WriteInt(a); WriteChar(' ');
+  WriteInt(c); WriteChar(' ');
+  if (!f) then WriteStr("f ") end;
+  if (ch = 'p') then WriteChar(ch) else WriteChar('-') end
+end scalars;
+
+procedure arrays(k: integer);
+var big: integer[40];
+    half: integer[20];
+    w: integer[30];
+    i: integer;
+begin
+  i := 0;
+  while (i < 10) do
+    half[i] := i;
+    w[i] := i;
+    i := i + 1
+  end;
+  big[k] := 5;
+  WriteInt(total(big)); WriteChar(' ');
+  WriteInt(half[3] + half[15]); WriteChar(' ');
+  WriteInt(w[9])
+end arrays;
+
+begin
+  scalars(0); WriteLn();
+  scalars(4); WriteLn();
+  arrays(3); WriteLn();
+  arrays(39); WriteLn()
+end zeroinit00.